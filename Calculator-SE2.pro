@@ -27,28 +27,60 @@ INCLUDEPATH += \
     src/common \
     src/components \
     src/qtdep_gui \
-    src/logic
+    src/logic \
+    src/headless
 
 HEADERS += \
+    src/common/clock.h \
     src/common/controllerintf.h \
+    src/common/controllerstats.h \
+    src/common/keylog.h \
+    src/common/intervaltimer.h \
+    src/common/join.h \
     src/common/pubsub.h \
+    src/common/segmentframe.h \
+    src/common/startupprofile.h \
+    src/common/timerwheel.h \
     src/common/xevent.h \
     \
     src/components/builder.h \
+    src/components/buildconfig.h \
     src/components/displaycontroller.h \
     src/components/eventfactory.h \
     src/components/inputprocessor.h \
     src/components/maincontroller.h \
+    src/components/statsdumper.h \
     \
     \
     src/qtdep_gui/display.h \
     src/qtdep_gui/guifacade.h \
-    src/qtdep_gui/intervaltimer.h \
     src/qtdep_gui/mainwindow.h \
-    src/logic/calculator.h
+    src/qtdep_gui/timerwheeldriver.h \
+    src/logic/calculator.h \
+    src/logic/countdown.h \
+    src/logic/pstack.h \
+    src/logic/bignum.h \
+    src/logic/rational.h \
+    src/logic/mathkernels.h \
+    src/logic/mathkernels_impl.h \
+    src/logic/statistics.h \
+    \
+    src/headless/executor.h \
+    src/headless/headless.h \
+    src/headless/keyreplayer.h \
+    src/headless/loadgen.h \
+    src/headless/session.h
 
 SOURCES += \
+    src/common/clock.cpp \
+    src/common/controllerstats.cpp \
+    src/common/intervaltimer.cpp \
+    src/common/join.cpp \
+    src/common/keylog.cpp \
     src/common/pubsub.cpp \
+    src/common/segmentframe.cpp \
+    src/common/startupprofile.cpp \
+    src/common/timerwheel.cpp \
     src/common/xevent.cpp \
     \
     src/components/builder.cpp \
@@ -56,15 +88,27 @@ SOURCES += \
     src/components/eventfactory.cpp \
     src/components/inputprocessor.cpp \
     src/components/maincontroller.cpp \
+    src/components/statsdumper.cpp \
     \
     \
     src/qtdep_gui/display.cpp \
     src/qtdep_gui/guifacade.cpp \
-    src/qtdep_gui/intervaltimer.cpp \
     src/qtdep_gui/mainwindow.cpp \
+    src/qtdep_gui/timerwheeldriver.cpp \
     \
     src/main.cpp \
-    src/logic/calculator.cpp
+    src/logic/calculator.cpp \
+    src/logic/countdown.cpp \
+    src/logic/bignum.cpp \
+    src/logic/rational.cpp \
+    src/logic/mathkernels.cpp \
+    src/logic/statistics.cpp \
+    \
+    src/headless/executor.cpp \
+    src/headless/headless.cpp \
+    src/headless/keyreplayer.cpp \
+    src/headless/loadgen.cpp \
+    src/headless/session.cpp
 
 FORMS += \
     src/qtdep_gui/mainwindow.ui \
@@ -76,6 +120,33 @@ qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
 
+# Session server on Unix domain sockets with epoll, shared-memory channel,
+# state snapshots, calculation journal, history store and archive, VAT rate
+# table, bulk reductions of number files (Linux only).
+linux {
+    HEADERS += src/headless/sessionserver.h \
+        src/headless/shmchannel.h \
+        src/components/statesnapshot.h \
+        src/components/journal.h \
+        src/components/historystore.h \
+        src/components/historyarchive.h \
+        src/components/vattable.h \
+        src/headless/numberfile.h \
+        src/headless/filesummary.h \
+        src/headless/bulkreduction.h
+    SOURCES += src/headless/sessionserver.cpp \
+        src/headless/shmchannel.cpp \
+        src/components/statesnapshot.cpp \
+        src/components/journal.cpp \
+        src/components/historystore.cpp \
+        src/components/historyarchive.cpp \
+        src/components/vattable.cpp \
+        src/headless/numberfile.cpp \
+        src/headless/filesummary.cpp \
+        src/headless/bulkreduction.cpp
+    LIBS += -lrt
+}
+
 RESOURCES += \
     resources/res.qrc
 
@@ -0,0 +1,39 @@
+#include <thread>
+#include "clock.h"
+
+
+ClockIntf::~ClockIntf() {}
+
+
+/**
+ * @brief getInstance returns the default clock of the process, which
+ * is created on first invocation.
+ * @return reference to default MonotonicClock instance.
+ */
+MonotonicClock& MonotonicClock::getInstance() {
+    if( _this == nullptr ) {
+        _this = new MonotonicClock();
+    }
+    return *_this;
+}
+
+MonotonicClock *MonotonicClock::_this = nullptr;
+
+
+/**
+ * @brief MonotonicClock::now returns the current time of the clock.
+ * @return msec since creation of the clock.
+ */
+uint64_t MonotonicClock::now() const {
+    chrono::steady_clock::duration d = chrono::steady_clock::now() - epoch;
+    return uint64_t( chrono::duration_cast<chrono::milliseconds>( d ).count() );
+}
+
+/**
+ * @brief MonotonicClock::sleepUntil blocks until the clock has reached
+ * time 't'.
+ * @param t time in msec.
+ */
+void MonotonicClock::sleepUntil( uint64_t t ) {
+    this_thread::sleep_until( epoch + chrono::milliseconds( t ) );
+}
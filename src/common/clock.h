@@ -0,0 +1,88 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <cstdint>
+#include <chrono>
+using namespace std;
+
+
+/**
+ * @brief Abstract class that defines the interface of time sources used
+ * by TimerWheel and its timers. Time is measured in msec.
+ *
+ * sleepUntil() blocks until the clock has reached time 't'. A real clock
+ * sleeps, a virtual clock simply advances, which allows timers to be run
+ * faster than real time.
+ */
+class ClockIntf {
+
+  public:
+    virtual ~ClockIntf();
+
+    /**
+     * @brief now returns the current time of the clock.
+     * @return time in msec.
+     */
+    virtual uint64_t now() const = 0;
+
+    /**
+     * @brief sleepUntil blocks until the clock has reached time 't'.
+     * @param t time in msec.
+     */
+    virtual void sleepUntil( uint64_t t ) = 0;
+};
+
+
+/**
+ * @brief MonotonicClock is the real-time clock based on the monotonic
+ * std::chrono::steady_clock. Time is measured from creation of the clock.
+ */
+class MonotonicClock : public ClockIntf {
+
+  public:
+    MonotonicClock() : epoch( chrono::steady_clock::now() ) {}
+
+    /**
+     * @brief getInstance returns the default clock of the process, which
+     * is created on first invocation.
+     * @return reference to default MonotonicClock instance.
+     */
+    static MonotonicClock& getInstance();
+
+    uint64_t now() const;
+    void sleepUntil( uint64_t t );
+
+  private:
+    const chrono::steady_clock::time_point epoch;
+
+    static MonotonicClock *_this;   // private static pointer declaration
+                                    // for default instance
+};
+
+
+/**
+ * @brief VirtualClock is a deterministic clock that only advances when
+ * set by advance() or when sleepUntil() is invoked. Timer wheels using a
+ * VirtualClock expire timers instantly in order of their expiry, which
+ * allows replay tools and tests to run timer-driven behaviour, such as the
+ * display probe cycle or countdowns, faster than real time.
+ */
+class VirtualClock : public ClockIntf {
+
+  public:
+    VirtualClock( uint64_t start = 0 ) : t( start ) {}
+
+    uint64_t now() const { return t; }
+    void sleepUntil( uint64_t to ) { t = to > t? to : t; }
+
+    /**
+     * @brief advance virtual time by 'msec'.
+     * @param msec msec to advance.
+     */
+    void advance( uint64_t msec ) { t += msec; }
+
+  private:
+    uint64_t t;     // virtual time in msec
+};
+
+#endif // CLOCK_H
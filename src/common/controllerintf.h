@@ -2,7 +2,9 @@
 #define CONTROLLERINTF_H
 
 #include "pubsub.h"
+#include "controllerstats.h"
 class Callback;
+class XEventFactory;
 
 
 /**
@@ -12,6 +14,9 @@ class Callback;
  *
  * A controller can also be a publisher for logging control operations.
  *
+ * Controllers keep runtime statistics in 'counters', which can be read
+ * from any thread by stats(). Controllers are allocated aligned to cache
+ * lines as required by the counters.
  */
 class ControllerIntf : public PublisherIntf {
 
@@ -25,10 +30,18 @@ class ControllerIntf : public PublisherIntf {
         : PublisherIntf( name ), pub( pub ) {}
     virtual ~ControllerIntf();
 
+    /**
+     * @brief operator new allocates controllers aligned to cache lines,
+     * see ControllerStats::allocate().
+     */
+    static void *operator new( size_t size ) { return ControllerStats::allocate( size ); }
+    static void operator delete( void *p ) { ControllerStats::release( p ); }
+
     /**
      * @brief probe is a contol operation that probes a controller
      * before start. Since probing can be asynchronous, a callback
-     * object is used to report completion.
+     * object is used to report completion. Probes of several controllers
+     * can run concurrently with completions composed by a Join.
      * @param cb callback to report completion of probing.
      */
     virtual void probe( Callback *cb = nullptr ) = 0;
@@ -46,6 +59,12 @@ class ControllerIntf : public PublisherIntf {
 
     virtual const std::string getName() const { return PublisherIntf::getName(); }
 
+    /**
+     * @brief stats returns a snapshot of the controller's statistics.
+     * @return snapshot of counters.
+     */
+    ControllerStats::Snapshot stats() const { return counters.snapshot( getName() ); }
+
     /**
      * @brief Methods inherited from PublisherIntf to publish controller
      * log messages, if a publisher instance is provided, and to manage
@@ -57,7 +76,17 @@ class ControllerIntf : public PublisherIntf {
     virtual void clearSubscriptions() { if( pub ) pub->clearSubscriptions(); }
 
   protected:
+    /**
+     * @brief publishMsg publishes a log message, if a publisher instance
+     * is provided, and releases the message event afterwards. Without a
+     * publisher, e.g. in sessions, no event is created.
+     * @param ef event factory.
+     * @param msg message.
+     */
+    void publishMsg( XEventFactory& ef, const std::string& msg );
+
     PublisherIntf *pub = nullptr;   // externally injected publisher instance.
+    ControllerStats counters;       // runtime statistics, updated by controller
 
 };
 
@@ -0,0 +1,56 @@
+#include <chrono>
+#include <new>
+#include <cstdlib>
+#include "controllerstats.h"
+
+
+/**
+ * @brief ControllerStats::snapshot returns the values of all counters.
+ * @param controller name of controller.
+ * @return snapshot of counters.
+ */
+ControllerStats::Snapshot ControllerStats::snapshot( const string& controller ) const {
+    Snapshot s;
+    s.controller = controller;
+    for( int i=0; i < COUNTERS; i++ ) {
+        s.values[i] = cells[i].value.load( memory_order_relaxed );
+    }
+    return s;
+}
+
+const char *ControllerStats::name( Counter c ) {
+    static const char *names[ COUNTERS ] = {
+        "events", "errors", "display_updates", "calc_ops",
+        "transitions", "transition_nsec", "state_nsec", "notify_nsec", "restart_nsec"
+    };
+    return c >= 0 && c < COUNTERS? names[c] : "";
+}
+
+uint64_t ControllerStats::nsec() {
+    return uint64_t( chrono::duration_cast<chrono::nanoseconds>(
+                         chrono::steady_clock::now().time_since_epoch() ).count() );
+}
+
+/**
+ * @brief ControllerStats::allocate allocates 'size' bytes aligned to a
+ * cache line. The block returned by malloc() is kept in the pointer just
+ * below the aligned address.
+ * @param size of object.
+ * @return aligned memory.
+ * @throws bad_alloc if no memory is available.
+ */
+void *ControllerStats::allocate( size_t size ) {
+    void *block = malloc( size + sizeof( void * ) + CACHE_LINE - 1 );
+    if( block == nullptr ) {
+        throw bad_alloc();
+    }
+    uintptr_t p = ( uintptr_t( block ) + sizeof( void * ) + CACHE_LINE - 1 ) & ~uintptr_t( CACHE_LINE - 1 );
+    reinterpret_cast<void **>( p )[ -1 ] = block;
+    return reinterpret_cast<void *>( p );
+}
+
+void ControllerStats::release( void *p ) {
+    if( p != nullptr ) {
+        free( static_cast<void **>( p )[ -1 ] );
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef CONTROLLERSTATS_H
+#define CONTROLLERSTATS_H
+
+#include <iostream>
+#include <atomic>
+#include <cstdint>
+using namespace std;
+
+
+/**
+ * @brief The ControllerStats class keeps runtime statistics of a controller
+ * as relaxed atomic counters, each on its own cache line, such that
+ * updating counters does not slow down other threads reading them or
+ * updating counters of other controllers.
+ *
+ * Counters are updated by the thread that runs the controller only
+ * (single writer) and can be read from any thread, e.g. by a snapshot().
+ * Counters that do not apply to a controller remain 0.
+ */
+class ControllerStats {
+
+  public:
+    enum Counter {
+        Events,             // events handled (input events, control operations)
+        Errors,             // errors occurred or displayed
+        DisplayUpdates,     // frames rendered
+        CalcOps,            // calculator operations
+        Transitions,        // transitions of operational state
+        TransitionNsec,     // total time spent in transitions
+        StateNsec,          // time spent in the state left by the last transition
+        NotifyNsec,         // total time spent in notify()
+        RestartNsec,        // duration of the last warm restart
+        COUNTERS
+    };
+
+    /**
+     * @brief Snapshot holds the counter values of a controller at one time.
+     */
+    struct Snapshot {
+        string controller;
+        uint64_t values[ COUNTERS ];
+    };
+
+    ControllerStats() {
+        for( int i=0; i < COUNTERS; i++ ) {
+            cells[i].value.store( 0, memory_order_relaxed );
+        }
+    }
+
+    /**
+     * @brief add 'n' to a counter, set() sets a counter to 'n'.
+     * @param c counter.
+     * @param n value.
+     */
+    void add( Counter c, uint64_t n = 1 ) {
+        atomic<uint64_t>& v = cells[c].value;
+        v.store( v.load( memory_order_relaxed ) + n, memory_order_relaxed );
+    }
+    void set( Counter c, uint64_t n ) { cells[c].value.store( n, memory_order_relaxed ); }
+    uint64_t get( Counter c ) const { return cells[c].value.load( memory_order_relaxed ); }
+
+    /**
+     * @brief snapshot returns the values of all counters.
+     * @param controller name of controller.
+     * @return snapshot of counters.
+     */
+    Snapshot snapshot( const string& controller ) const;
+
+    /**
+     * @brief name returns the name of a counter as used in stats files.
+     * @param c counter.
+     * @return name of counter, e.g. "display_updates".
+     */
+    static const char *name( Counter c );
+
+    /**
+     * @brief nsec returns the time of the monotonic clock used to measure
+     * durations.
+     * @return time in nsec.
+     */
+    static uint64_t nsec();
+
+    /**
+     * @brief allocate returns memory of 'size' bytes aligned to a cache
+     * line, release() frees it. Objects holding ControllerStats must be
+     * allocated by them, as plain new does not honour the alignment of
+     * the cells in C++11.
+     * @throws bad_alloc if no memory is available.
+     */
+    static void *allocate( size_t size );
+    static void release( void *p );
+
+    static const size_t CACHE_LINE = 64;
+
+  private:
+    struct alignas( CACHE_LINE ) Cell {
+        atomic<uint64_t> value;         // one counter per cache line
+    };
+
+    Cell cells[ COUNTERS ];
+};
+
+#endif // CONTROLLERSTATS_H
@@ -0,0 +1,33 @@
+#include "intervaltimer.h"
+#include "pubsub.h"
+#include "eventfactory.h"
+#include "xevent.h"
+
+
+/**
+ * @brief IntervalTimer::IntervalTimerconstructor.
+ * @param name of the timer.
+ * @param the number of events fired / or intervals.
+ * @param msec duration between timer events.
+ * @param subscriber to timer events.
+ * @param wheel timer wheel at which the timer is scheduled.
+ */
+IntervalTimer::IntervalTimer( std::string name, int limit, int msec, SubscriberIntf *subscriber, TimerWheel& wheel )
+    : name( name ), wheel( wheel ), limit( limit ), remaining( 0 ), count( 0 ), msec( msec ), subscriber( subscriber )
+{}
+
+/**
+ * @brief IntervalTimer::expired is invoked by the timer wheel for each
+ * timer event. The next interval is scheduled relative to the expiry
+ * tick of this interval, unless the limit has been reached.
+ */
+void IntervalTimer::expired() {
+    if( --remaining > 0 ) {
+        wheel.scheduleAt( *this, getExpiry() + unsigned( msec ) );
+    }
+    if( subscriber != nullptr ) {
+        XEventFactory& ef = XEventFactory::getInstance();
+        XEvent& e = ef.getEvent( XEvent::Type::timerEvents, count++ );
+        subscriber->notify( e );
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <iostream>
+#include "timerwheel.h"
+class SubscriberIntf;
+using namespace std;
+
+
+/**
+ * @brief The IntervalTimer class implements an interval timer that fires
+ * a limited number of timer events with a specified delay between them.
+ *
+ * IntervalTimer is a thin adapter of a TimerWheel entry. Intervals are
+ * rescheduled from the previous expiry tick (rather than from the time
+ * of notification) such that intervals do not accumulate drift.
+ *
+ */
+class IntervalTimer : private TimerWheel::Entry {
+
+  public:
+    /**
+     * @brief IntervalTimer constructor.
+     * @param name of the timer.
+     * @param the number of events fired / or intervals.
+     * @param msec duration between timer events.
+     * @param subscriber to timer events.
+     * @param wheel timer wheel at which the timer is scheduled.
+     */
+    IntervalTimer( string name, int limit, int msec, SubscriberIntf *subscriber = nullptr,
+                   TimerWheel& wheel = TimerWheel::getInstance() );
+    ~IntervalTimer() {}
+
+    /**
+     * @brief start IntervalTimer, which fires 'limit' timer events with tick
+     * counts from 0, also when restarted after it has finished. stop()
+     * cancels pending timer events.
+     */
+    void start() {
+        remaining = limit;
+        count = 0;
+        if( remaining > 0 ) {
+            wheel.schedule( *this, unsigned( msec ) );
+        }
+    }
+
+    void stop() { wheel.cancel( *this ); }
+
+    string getName() { return name; }
+
+  private:
+    /**
+     * @brief expired is invoked by the timer wheel for each timer event
+     * (formerly the intervalCallback Qt slot). The subscriber is notified
+     * with a timer event carrying the tick count.
+     */
+    void expired();
+
+    string name;
+
+    TimerWheel& wheel;
+    const int limit;
+    int remaining;                  // timer events left until the limit
+    int count;
+    int msec;
+    SubscriberIntf *subscriber;
+
+};
+
+#endif // TIMER_H
@@ -0,0 +1,54 @@
+#include "join.h"
+
+
+/**
+ * @brief Join::begin starts a join and abandons a pending join.
+ * @param then continuation invoked with the result of the join.
+ */
+void Join::begin( Callback *then ) {
+    this->then = then;
+    pending = 0;
+    armed = false;
+    result = nullptr;
+}
+
+/**
+ * @brief Join::end is invoked after all steps have been forked and
+ * completes the join if all steps have already completed.
+ */
+void Join::end() {
+    armed = true;
+    if( pending == 0 ) {
+        complete();
+    }
+}
+
+/**
+ * @brief Join::callback is invoked when a step has completed. The first
+ * failed result is kept as result of the join.
+ * @param e result of step.
+ */
+void Join::callback( XEvent *e ) {
+    if( then == nullptr || pending == 0 ) {
+        return;     // step of an abandoned join
+    }
+    if( result == nullptr || result->ev == success ) {
+        result = e;
+    }
+    if( --pending == 0 && armed ) {
+        complete();
+    }
+}
+
+/**
+ * @brief Join::complete invokes the continuation. The join is finished
+ * before, such that the continuation can begin the next join.
+ */
+void Join::complete() {
+    Callback *cb = then;
+    XEvent *e = result;
+    then = nullptr;
+    if( cb != nullptr ) {
+        cb->callback( e );
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef JOIN_H
+#define JOIN_H
+
+#include "pubsub.h"
+#include "xevent.h"
+
+
+/**
+ * @brief The Join class composes asynchronous control operations, such
+ * as probing several controllers concurrently, into one operation that
+ * completes when all of them have completed.
+ *
+ * A join is started with begin(), which sets the continuation. Each step
+ * obtains its completion callback from fork(), which returns the join
+ * itself. end() is invoked after all steps have been forked. When the
+ * last step has completed after end(), the continuation is invoked with
+ * the result of the join: the result of the first step that did not
+ * report 'success', otherwise the result of the last step (nullptr
+ * without steps). Steps may complete synchronously, e.g. before end().
+ *
+ * A Join is embedded in its owner and reused for every operation, such
+ * that no callback objects are allocated. begin() abandons a pending join,
+ * whose steps must have been cancelled. All steps must complete on the
+ * event loop thread of the owner.
+ */
+class Join : public Callback {
+
+  public:
+    /**
+     * @brief Join constructor.
+     * @param success result event (XEvent::ev) reported by successful steps.
+     */
+    Join( int success ) : success( success ) {}
+    virtual ~Join() {}
+
+    /**
+     * @brief begin starts a join, fork() adds a step, end() completes
+     * the join once all steps have completed.
+     * @param then continuation invoked with the result of the join.
+     * @return fork() returns the completion callback of the step.
+     */
+    void begin( Callback *then );
+    Callback *fork() { pending++; return this; }
+    void end();
+
+    /**
+     * @brief callback method inherited from Callback is invoked when a
+     * step has completed.
+     * @param e result of step.
+     */
+    void callback( XEvent *e );
+
+    bool isPending() const { return then != nullptr; }
+
+  private:
+    void complete();
+
+    const int success;
+    Callback *then = nullptr;   // continuation of a pending join
+    int pending = 0;            // number of steps not yet completed
+    bool armed = false;         // end() has been invoked
+    XEvent *result = nullptr;
+};
+
+#endif // JOIN_H
@@ -0,0 +1,95 @@
+#include <stdexcept>
+#include <cstring>
+#include "keylog.h"
+#include "xevent.h"
+void logDestructor( string msg );
+
+
+static const char MAGIC[] = { 'S', 'E', '2', 'K' };
+
+
+/**
+ * @brief KeyLog::writeHeader appends the key log header to a stream.
+ * @param os output stream opened in binary mode.
+ */
+void KeyLog::writeHeader( ostream& os ) {
+    char h[ HEADER_SIZE ] = { MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3], char( VERSION ), 0, 0, 0 };
+    os.write( h, HEADER_SIZE );
+}
+
+/**
+ * @brief KeyLog::writeRecord appends a record to a stream.
+ * @param os output stream opened in binary mode.
+ * @param r record.
+ */
+void KeyLog::writeRecord( ostream& os, const Record& r ) {
+    char b[ RECORD_SIZE ] = {
+        char( r.msec ), char( r.msec >> 8 ), char( r.msec >> 16 ), char( r.msec >> 24 ), char( r.key )
+    };
+    os.write( b, RECORD_SIZE );
+}
+
+/**
+ * @brief KeyLog::load reads all records of a key log file. A truncated
+ * last record, e.g. after a crash while writing, is ignored.
+ * @param path of key log file.
+ * @return records in recorded order.
+ * @throws runtime_error if the file cannot be read or is no key log.
+ */
+vector<KeyLog::Record> KeyLog::load( const string& path ) {
+    ifstream is( path.c_str(), ios::binary );
+    char h[ HEADER_SIZE ];
+    if( ! is.read( h, HEADER_SIZE ) ) {
+        throw runtime_error( "cannot read key log: " + path );
+    }
+    if( memcmp( h, MAGIC, sizeof( MAGIC ) ) != 0 || uint8_t( h[4] ) != VERSION ) {
+        throw runtime_error( "no key log or unsupported version: " + path );
+    }
+    vector<Record> log;
+    unsigned char b[ RECORD_SIZE ];
+    while( is.read( reinterpret_cast<char *>( b ), RECORD_SIZE ) ) {
+        Record r;
+        r.msec = uint32_t( b[0] ) | uint32_t( b[1] ) << 8 | uint32_t( b[2] ) << 16 | uint32_t( b[3] ) << 24;
+        r.key = b[4];
+        log.push_back( r );
+    }
+    return log;
+}
+
+
+/**
+ * @brief KeyRecorder constructor creates the key log file.
+ * @param name of recorder.
+ * @param path of key log file.
+ * @param clock time source of timestamps.
+ * @throws runtime_error if the file cannot be created.
+ */
+KeyRecorder::KeyRecorder( const string name, const string path, ClockIntf& clock )
+    : SubscriberIntf( name ), os( path.c_str(), ios::binary | ios::trunc ),
+      clock( clock ), start( clock.now() )
+{
+    if( ! os ) {
+        throw runtime_error( "cannot create key log: " + path );
+    }
+    KeyLog::writeHeader( os );
+    os.flush();
+}
+
+KeyRecorder::~KeyRecorder() {
+    logDestructor( getName() );
+}
+
+
+/**
+ * @brief KeyRecorder::notify appends key input events to the key log.
+ * Other events are ignored.
+ * @param e published XEvent.
+ */
+void KeyRecorder::notify( XEvent& e ) {
+    if( e.type == XEvent::Type::keyInputEvents ) {
+        KeyLog::Record r = { uint32_t( clock.now() - start ), uint8_t( e.ev ) };
+        KeyLog::writeRecord( os, r );
+        os.flush();
+        count++;
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef KEYLOG_H
+#define KEYLOG_H
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstdint>
+#include "pubsub.h"
+#include "clock.h"
+using namespace std;
+
+
+/**
+ * @brief The KeyLog class defines the compact binary format of recorded
+ * key events. A key log consists of an 8-byte header (magic "SE2K",
+ * version, 3 reserved bytes) followed by 5-byte records of a timestamp
+ * in msec since the start of the recording (uint32, little-endian) and
+ * the key event (GuiFacade::KeyEvt as uint8).
+ */
+class KeyLog {
+
+  public:
+    struct Record {
+        uint32_t msec;      // msec since start of recording
+        uint8_t key;        // GuiFacade::KeyEvt
+    };
+
+    static const int HEADER_SIZE = 8;
+    static const int RECORD_SIZE = 5;
+    static const uint8_t VERSION = 1;
+
+    /**
+     * @brief writeHeader and writeRecord append the header or a record
+     * to a binary stream.
+     * @param os output stream opened in binary mode.
+     * @param r record.
+     */
+    static void writeHeader( ostream& os );
+    static void writeRecord( ostream& os, const Record& r );
+
+    /**
+     * @brief load reads all records of a key log file.
+     * @param path of key log file.
+     * @return records in recorded order.
+     * @throws runtime_error if the file cannot be read or is no key log.
+     */
+    static vector<Record> load( const string& path );
+};
+
+
+/**
+ * @brief KeyRecorder is a subscriber to GuiFacade that appends key input
+ * events with timestamps to a key log file. Records are flushed as they
+ * are written such that a trace survives a crash of the application.
+ */
+class KeyRecorder : public SubscriberIntf {
+
+  public:
+    /**
+     * @brief KeyRecorder constructor creates the key log file.
+     * @param name of recorder.
+     * @param path of key log file.
+     * @param clock time source of timestamps.
+     * @throws runtime_error if the file cannot be created.
+     */
+    KeyRecorder( const string name, const string path, ClockIntf& clock = MonotonicClock::getInstance() );
+    ~KeyRecorder();
+
+    /**
+     * @brief notify is invoked when a key input event is published.
+     * @param e published XEvent.
+     */
+    void notify( XEvent& e );
+
+    size_t size() const { return count; }
+
+  private:
+    ofstream os;
+    ClockIntf& clock;
+    const uint64_t start;       // clock time at start of recording
+    size_t count = 0;           // number of recorded events
+};
+
+#endif // KEYLOG_H
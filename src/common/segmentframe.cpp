@@ -0,0 +1,131 @@
+#include <cstring>
+#include "segmentframe.h"
+
+
+DisplayBackendIntf::~DisplayBackendIntf() {}
+
+
+/**
+ * Character classes of display buffer characters: glyph of a cell for
+ * digits, '-', 'E' of the scientific view and other characters (blank), or MARK combined with the
+ * flag for '.' and ':', which do not occupy a cell.
+ */
+static const uint8_t MARK = 0x80;
+
+constexpr uint8_t charClass( int c ) {
+    return c >= '0' && c <= '9'? uint8_t( c - '0' ) :
+           c == '-'? uint8_t( SegmentFrame::MINUS ) :
+           c == 'E'? uint8_t( SegmentFrame::E ) :
+           c == '.'? uint8_t( MARK | SegmentFrame::DOT ) :
+           c == ':'? uint8_t( MARK | SegmentFrame::COLON ) :
+           uint8_t( SegmentFrame::BLANK );
+}
+
+#define CC4( c )  charClass( c ), charClass( c + 1 ), charClass( c + 2 ), charClass( c + 3 )
+#define CC16( c ) CC4( c ), CC4( c + 4 ), CC4( c + 8 ), CC4( c + 12 )
+#define CC64( c ) CC16( c ), CC16( c + 16 ), CC16( c + 32 ), CC16( c + 48 )
+
+static constexpr uint8_t charClassTable[ 256 ] = {
+    CC64( 0 ), CC64( 64 ), CC64( 128 ), CC64( 192 )
+};
+
+
+/**
+ * @brief SegmentFrame::encode a display buffer into a frame. The buffer
+ * is scanned once, classifying characters by table lookup and counting
+ * marks. Classes are then placed right-aligned into cells. Buffers are
+ * limited to 64 characters.
+ * @param buf display buffer.
+ * @param len length of display buffer.
+ * @return encoded frame.
+ */
+SegmentFrame SegmentFrame::encode( const char *buf, size_t len ) {
+    static const size_t MAXLEN = 64;
+    uint8_t cls[ MAXLEN ];
+    size_t n = len < MAXLEN? len : MAXLEN;
+    int marks = 0;
+    for( size_t i=0; i < n; i++ ) {
+        uint8_t c = charClassTable[ uint8_t( buf[i] ) ];
+        cls[i] = c;
+        marks += c >> 7;
+    }
+    SegmentFrame f;
+    f.cell[0] |= marks == 0? DOT : 0;
+    size_t lmax = size_t( CELLS + marks );
+    int l = int( n > lmax? lmax : n );
+    int j = 0;
+    for( int i = l - 1; i >= 0 && j < CELLS; i-- ) {
+        uint8_t c = cls[i];
+        if( c & MARK ) {
+            f.cell[j] |= uint8_t( c & ~MARK );
+        } else {
+            f.cell[j] = uint8_t( ( f.cell[j] & ~GLYPH ) | c );
+            j++;
+        }
+    }
+    return f;
+}
+
+/**
+ * @brief SegmentFrame::encodeBatch encodes 'n' display buffers.
+ * @param bufs display buffers.
+ * @param n number of buffers.
+ * @param frames encoded frames.
+ */
+void SegmentFrame::encodeBatch( const string *bufs, size_t n, SegmentFrame *frames ) {
+    for( size_t i=0; i < n; i++ ) {
+        frames[i] = encode( bufs[i] );
+    }
+}
+
+/**
+ * @brief SegmentFrame::error returns the frame showing "Error".
+ * @return error frame.
+ */
+SegmentFrame SegmentFrame::error() {
+    SegmentFrame f;
+    static const uint8_t msg[] = { E, R, R, O, R };
+    for( int i=0; i < 5; i++ ) {
+        f.cell[ CELLS - i - 1 ] = msg[i];
+    }
+    return f;
+}
+
+
+void SegmentFrame::setAll( int n, bool dot, bool comma, bool colon ) {
+    for( int i=0; i < CELLS; i++ ) {
+        setDigit( i, n );
+        setDot( i, dot );
+        setComma( i, comma );
+        setColon( i, colon );
+    }
+}
+
+void SegmentFrame::clear() {
+    memset( cell, BLANK, sizeof( cell ) );
+}
+
+
+/**
+ * @brief SegmentFrame::toString renders the frame as text from left to
+ * right omitting leading blank cells.
+ * @return frame as string.
+ */
+string SegmentFrame::toString() const {
+    static const char glyphs[] = "0123456789-Ero  ";
+    string str;
+    for( int i = CELLS - 1; i >= 0; i-- ) {
+        if( str.empty() && cell[i] == BLANK ) {
+            continue;
+        }
+        str += glyphs[ cell[i] & GLYPH ];
+        if( cell[i] & DOT ) { str += '.'; }
+        if( cell[i] & COMMA ) { str += ','; }
+        if( cell[i] & COLON ) { str += ':'; }
+    }
+    return str;
+}
+
+bool SegmentFrame::operator==( const SegmentFrame& f ) const {
+    return memcmp( cell, f.cell, sizeof( cell ) ) == 0;
+}
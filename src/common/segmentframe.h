@@ -0,0 +1,110 @@
+#ifndef SEGMENTFRAME_H
+#define SEGMENTFRAME_H
+
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+using namespace std;
+
+
+/**
+ * @brief The SegmentFrame class is the packed content of the 10-digit
+ * display. Each cell is one byte: the lower 4 bits encode the glyph shown
+ * by the digit (0..9, '-', letters of "Error" or blank), the upper bits
+ * turn on the dot, comma and colon symbols of the digit. Cells are indexed
+ * [0..9] from right to left like display digits.
+ *
+ * Frames are the unit passed to display backends (DisplayBackendIntf).
+ * encode() turns a display buffer such as "12.345" or "12:00:00" into a
+ * frame in a single pass over the buffer using a 256-entry character
+ * class table.
+ */
+class SegmentFrame {
+
+  public:
+    static const int CELLS = 10;        // 10 digits in display
+
+    enum Glyph {
+        G0=0, G1, G2, G3, G4, G5, G6, G7, G8, G9,
+        MINUS=10, E=11, R=12, O=13, BLANK=15
+    };
+    enum Flags { GLYPH=0x0f, DOT=0x10, COMMA=0x20, COLON=0x40 };
+
+    SegmentFrame() { clear(); }
+
+    /**
+     * @brief encode a display buffer into a frame. Digits and '-' occupy
+     * one cell each, right-aligned. '.' and ':' turn on the dot or colon
+     * of the cell left of it. If the buffer has neither '.' nor ':', the
+     * dot of the rightmost cell is turned on. At most 10 digits are taken
+     * from the left of the buffer. encodeBatch() encodes 'n' buffers.
+     * @param buf display buffer.
+     * @param len length of display buffer.
+     * @return encoded frame.
+     */
+    static SegmentFrame encode( const char *buf, size_t len );
+    static SegmentFrame encode( const string& buf ) { return encode( buf.data(), buf.length() ); }
+    static void encodeBatch( const string *bufs, size_t n, SegmentFrame *frames );
+
+    /**
+     * @brief error returns the frame showing "Error".
+     * @return error frame.
+     */
+    static SegmentFrame error();
+
+    /**
+     * @brief Access methods to cells. Digits are indexed [0..9] by index
+     * parameter 'i'. Value is indicated by 'n', n < 0 clears the digit.
+     */
+    void setDigit( int i, int n ) { setGlyph( i, n < 0? BLANK : n % 10 ); }
+    void setMinus( int i )          { setGlyph( i, MINUS ); }
+    void setDot( int i, bool on )   { setFlag( i, DOT, on ); }
+    void setComma( int i, bool on ) { setFlag( i, COMMA, on ); }
+    void setColon( int i, bool on ) { setFlag( i, COLON, on ); }
+    void setAll( int n, bool dot, bool comma, bool colon );
+    void clearDigit( int i )        { if( i >= 0 && i < CELLS ) { cell[i] = BLANK; } }
+    void clear();
+
+    int glyph( int i ) const { return cell[i] & GLYPH; }
+    bool dot( int i ) const { return cell[i] & DOT; }
+
+    /**
+     * @brief toString renders the frame as text from left to right, e.g.
+     * "12.345" or "12:00:00", omitting leading blank cells.
+     * @return frame as string.
+     */
+    string toString() const;
+
+    bool operator==( const SegmentFrame& f ) const;
+    bool operator!=( const SegmentFrame& f ) const { return ! ( *this == f ); }
+
+    uint8_t cell[ CELLS ];
+
+  private:
+    void setGlyph( int i, int g ) {
+        if( i >= 0 && i < CELLS ) { cell[i] = uint8_t( ( cell[i] & ~GLYPH ) | g ); }
+    }
+    void setFlag( int i, int flag, bool on ) {
+        if( i >= 0 && i < CELLS ) { cell[i] = uint8_t( on? cell[i] | flag : cell[i] & ~flag ); }
+    }
+};
+
+
+/**
+ * @brief Abstract class that defines the interface of display backends
+ * that render segment frames, such as the Qt display behind GuiFacade or
+ * headless frame sinks.
+ */
+class DisplayBackendIntf {
+
+  public:
+    virtual ~DisplayBackendIntf();
+
+    /**
+     * @brief render a frame on the display.
+     * @param f frame to render.
+     */
+    virtual void render( const SegmentFrame& f ) = 0;
+};
+
+#endif // SEGMENTFRAME_H
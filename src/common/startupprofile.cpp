@@ -0,0 +1,65 @@
+#include <cstdio>
+#include "startupprofile.h"
+
+
+/**
+ * @brief getInstance creates singleton instance on first invocation.
+ * @return reference to singleton StartupProfile instance.
+ */
+StartupProfile& StartupProfile::getInstance() {
+    if( _this == nullptr ) {
+        _this = new StartupProfile();
+    }
+    return *_this;
+}
+
+StartupProfile *StartupProfile::_this = nullptr;
+
+
+/**
+ * @brief mark records the end of a startup phase. After the application
+ * is ready for input, the phase is reported immediately.
+ * @param phase name of the phase.
+ */
+void StartupProfile::mark( const string phase ) {
+    Phase p = { phase, elapsed() };
+    phases.push_back( p );
+    if( isReady() ) {
+        char line[ 160 ];
+        sprintf( line, "Startup: %s done at %.1f ms (%.1f ms after first input).",
+                 phase.c_str(), p.msec, p.msec - readyAt );
+        cout << line << endl;
+    }
+}
+
+/**
+ * @brief ready marks the application as ready for input and reports
+ * the profile with the time-to-first-input.
+ * @param phase name of the last phase before input is accepted.
+ */
+void StartupProfile::ready( const string phase ) {
+    if( ! isReady() ) {
+        mark( phase );
+        readyAt = phases.back().msec;
+        report();
+    }
+}
+
+
+double StartupProfile::elapsed() const {
+    chrono::duration<double, milli> d = chrono::steady_clock::now() - start;
+    return d.count();
+}
+
+void StartupProfile::report() const {
+    char line[ 160 ];
+    cout << "Startup profile" << ( fastStart? " (fast-start):" : ":" ) << endl;
+    double prev = 0.0;
+    for( vector<Phase>::const_iterator it = phases.begin(); it != phases.end(); it++ ) {
+        sprintf( line, "  %-20s %9.1f ms  (+%.1f ms)", it->name.c_str(), it->msec, it->msec - prev );
+        cout << line << endl;
+        prev = it->msec;
+    }
+    sprintf( line, "Time to first input: %.1f ms.", readyAt );
+    cout << line << endl;
+}
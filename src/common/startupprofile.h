@@ -0,0 +1,73 @@
+#ifndef STARTUPPROFILE_H
+#define STARTUPPROFILE_H
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+using namespace std;
+
+
+/**
+ * @brief The StartupProfile class records timestamps of startup phases
+ * (e.g. Qt init, UI setup, stylesheet, Builder::build, probe) relative to
+ * the entry into main(). The profile is reported to cout once the
+ * application is ready for input, including the time-to-first-input.
+ * Phases marked after that, such as work deferred in fast-start mode,
+ * are reported individually.
+ *
+ * StartupProfile exists as a singleton instance created on first access,
+ * which should be the first statement of main().
+ */
+class StartupProfile {
+
+  public:
+    /**
+     * @brief getInstance creates singleton instance on first invocation.
+     * @return reference to singleton StartupProfile instance.
+     */
+    static StartupProfile& getInstance();
+
+    /**
+     * @brief mark records the end of a startup phase.
+     * @param phase name of the phase.
+     */
+    void mark( const string phase );
+
+    /**
+     * @brief ready marks the application as ready for input and reports
+     * the profile with the time-to-first-input. Only the first invocation
+     * has an effect.
+     * @param phase name of the last phase before input is accepted.
+     */
+    void ready( const string phase );
+
+    bool isReady() const { return readyAt >= 0; }
+
+    /**
+     * @brief fastStart selects the fast-start mode, in which probing is
+     * skipped and non-essential work is deferred until input is accepted.
+     */
+    bool isFastStart() const { return fastStart; }
+    void setFastStart( bool fastStart ) { this->fastStart = fastStart; }
+
+  private:
+    StartupProfile() : start( chrono::steady_clock::now() ) {}
+
+    double elapsed() const;
+    void report() const;
+
+    struct Phase {
+        string name;
+        double msec;    // msec since start
+    };
+
+    const chrono::steady_clock::time_point start;
+    vector<Phase> phases;
+    double readyAt = -1.0;      // msec since start when ready for input
+    bool fastStart = false;
+
+    static StartupProfile *_this;   // private static pointer declaration
+                                    // for singleton instance
+};
+
+#endif // STARTUPPROFILE_H
@@ -0,0 +1,290 @@
+#include "timerwheel.h"
+
+
+TimerWheel::Entry::~Entry() {
+    if( wheel != nullptr && isPending() ) {
+        wheel->cancel( *this );
+    }
+}
+
+TimerWheel::DriverIntf::~DriverIntf() {}
+
+
+/**
+ * @brief init initializes all slot lists as empty.
+ */
+void TimerWheel::init() {
+    for( int i=0; i < L0_SIZE; i++ ) {
+        l0[i].prev = l0[i].next = &l0[i];
+    }
+    for( int l=0; l < LN_LEVELS; l++ ) {
+        for( int i=0; i < LN_SIZE; i++ ) {
+            ln[l][i].prev = ln[l][i].next = &ln[l][i];
+        }
+    }
+    expiredList.prev = expiredList.next = &expiredList;
+}
+
+TimerWheel::~TimerWheel() {}
+
+
+/**
+ * @brief getInstance returns the default wheel driven by the main
+ * event loop. The instance is created on first invocation.
+ * @return reference to default TimerWheel instance.
+ */
+TimerWheel& TimerWheel::getInstance() {
+    if( _this == nullptr ) {
+        _this = new TimerWheel();
+    }
+    return *_this;
+}
+
+TimerWheel *TimerWheel::_this = nullptr;
+
+
+/**
+ * @brief setClock replaces the clock of the wheel, which is only
+ * possible while no entry is pending.
+ * @param clock new clock.
+ * @return true if clock has been replaced.
+ */
+bool TimerWheel::setClock( ClockIntf& clock ) {
+    if( count > 0 ) {
+        return false;
+    }
+    this->clock = &clock;
+    current = now();
+    return true;
+}
+
+
+/**
+ * @brief schedule an entry to expire 'delay' ticks from now() or at
+ * absolute tick 'when'. A pending entry is rescheduled.
+ * @param e timer entry.
+ * @param delay relative expiry in ticks (msec).
+ * @param when absolute expiry tick.
+ */
+void TimerWheel::schedule( Entry& e, uint64_t delay ) {
+    scheduleAt( e, now() + delay );
+}
+
+void TimerWheel::scheduleAt( Entry& e, uint64_t when ) {
+    if( e.isPending() ) {
+        e.wheel->cancel( e );
+    }
+    if( count == 0 ) {
+        // idle wheel catches up with the clock, no slots to process
+        uint64_t t = now();
+        current = t > current? t : current;
+    }
+    e.expires = when;
+    e.wheel = this;
+    insert( e );
+    count++;
+    if( driver != nullptr ) {
+        driver->rearm( e.expires );
+    }
+}
+
+/**
+ * @brief cancel removes a pending entry from the wheel. Bitmaps are
+ * not updated and cleared lazily when empty slots are visited.
+ * @param e timer entry.
+ */
+void TimerWheel::cancel( Entry& e ) {
+    if( e.isPending() && e.wheel == this ) {
+        unlink( &e );
+        count--;
+    }
+}
+
+
+/**
+ * @brief insert links entry into the slot that corresponds to its
+ * distance from the current tick.
+ * @param e timer entry.
+ */
+void TimerWheel::insert( Entry& e ) {
+    uint64_t exp = e.expires < current? current : e.expires;
+    uint64_t delta = exp - current;
+    if( delta > MAX_DELAY ) {
+        delta = MAX_DELAY;
+        exp = current + delta;
+    }
+    if( delta < uint64_t( L0_SIZE ) ) {
+        int i = int( exp & ( L0_SIZE - 1 ) );
+        append( &l0[i], &e );
+        l0map[ i >> 6 ] |= uint64_t( 1 ) << ( i & 63 );
+        return;
+    }
+    for( int l=0; l < LN_LEVELS; l++ ) {
+        int shift = L0_BITS + ( l + 1 ) * LN_BITS;
+        if( l == LN_LEVELS - 1 || delta < ( uint64_t( 1 ) << shift ) ) {
+            int i = int( ( exp >> ( shift - LN_BITS ) ) & ( LN_SIZE - 1 ) );
+            append( &ln[l][i], &e );
+            lnmap[l] |= uint64_t( 1 ) << i;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief cascade re-inserts all entries of slot 'index' at level 'level'
+ * into lower levels.
+ * @param level index of level 1..4 (0-based).
+ * @param index slot index.
+ */
+void TimerWheel::cascade( int level, int index ) {
+    Link *head = &ln[ level ][ index ];
+    while( head->next != head ) {
+        Entry *e = static_cast<Entry *>( head->next );
+        unlink( e );
+        insert( *e );
+    }
+    lnmap[ level ] &= ~( uint64_t( 1 ) << index );
+}
+
+
+/**
+ * @brief advanceTo processes all entries that have expired until tick 'to'.
+ * Ticks with empty level 0 slots are skipped using the occupancy bitmap.
+ * Entries of one slot are moved to expiredList first and then expired in
+ * a batch.
+ * @param to absolute tick until which entries are expired.
+ * @return number of expired entries.
+ */
+size_t TimerWheel::advanceTo( uint64_t to ) {
+    size_t fired = 0;
+    while( current <= to ) {
+        if( count == 0 ) {
+            current = to + 1;
+            break;
+        }
+        int i = int( current & ( L0_SIZE - 1 ) );
+        if( i == 0 ) {
+            for( int l=0; l < LN_LEVELS; l++ ) {
+                int shift = L0_BITS + l * LN_BITS;
+                int index = int( ( current >> shift ) & ( LN_SIZE - 1 ) );
+                cascade( l, index );
+                if( index != 0 ) {
+                    break;
+                }
+            }
+        }
+        Link *slot = &l0[i];
+        if( slot->next == slot ) {
+            // skip to next occupied slot or to the next cascade
+            l0map[ i >> 6 ] &= ~( uint64_t( 1 ) << ( i & 63 ) );
+            int k = i + 1;
+            while( k < L0_SIZE ) {
+                uint64_t w = l0map[ k >> 6 ] >> ( k & 63 );
+                if( w != 0 ) {
+                    k += __builtin_ctzll( w );
+                    break;
+                }
+                k = ( k | 63 ) + 1;
+            }
+            uint64_t next = current + uint64_t( k - i );
+            current = next > to + 1? to + 1 : next;
+            continue;
+        }
+        // move slot to expiredList and expire batch
+        expiredList.next = slot->next;
+        expiredList.prev = slot->prev;
+        expiredList.next->prev = &expiredList;
+        expiredList.prev->next = &expiredList;
+        slot->prev = slot->next = slot;
+        l0map[ i >> 6 ] &= ~( uint64_t( 1 ) << ( i & 63 ) );
+        current++;
+
+        while( expiredList.next != &expiredList ) {
+            Entry *e = static_cast<Entry *>( expiredList.next );
+            unlink( e );
+            count--;
+            fired++;
+            e->expired();
+        }
+    }
+    return fired;
+}
+
+
+/**
+ * @brief nextExpiry returns a lower bound of the tick at which the next
+ * entry expires. For level 0, this is the tick of the next occupied slot.
+ * For levels 1..4, it is the tick at which the next occupied slot is
+ * cascaded.
+ * @return tick of next expiry or UINT64_MAX if no entry is pending.
+ */
+uint64_t TimerWheel::nextExpiry() const {
+    uint64_t next = UINT64_MAX;
+    if( count == 0 ) {
+        return next;
+    }
+    int i = int( current & ( L0_SIZE - 1 ) );
+    for( int k=0; k < L0_SIZE; k++ ) {
+        int j = ( i + k ) & ( L0_SIZE - 1 );
+        if( ( l0map[ j >> 6 ] >> ( j & 63 ) ) & 1 && l0[j].next != &l0[j] ) {
+            next = current + uint64_t( k );
+            break;
+        }
+    }
+    for( int l=0; l < LN_LEVELS; l++ ) {
+        int shift = L0_BITS + l * LN_BITS;
+        uint64_t base = current >> shift;
+        // slot 'base' is not yet cascaded if current is at its start
+        int d0 = ( current & ( ( uint64_t( 1 ) << shift ) - 1 ) ) == 0? 0 : 1;
+        for( int d=d0; d <= LN_SIZE; d++ ) {
+            int j = int( ( base + uint64_t( d ) ) & ( LN_SIZE - 1 ) );
+            if( ( lnmap[l] >> j ) & 1 && ln[l][j].next != &ln[l][j] ) {
+                uint64_t t = ( base + uint64_t( d ) ) << shift;
+                next = t < next? t : next;
+                break;
+            }
+        }
+    }
+    return next;
+}
+
+
+/**
+ * @brief runUntil is a headless loop that sleeps until the next expiry
+ * and advances the wheel until the clock has reached tick 'to' or, if
+ * 'to' is UINT64_MAX, until no entry is pending.
+ * @param to absolute tick until which the wheel is run.
+ * @return number of expired entries.
+ */
+size_t TimerWheel::runUntil( uint64_t to ) {
+    size_t fired = 0;
+    while( count > 0 ) {
+        uint64_t next = nextExpiry();
+        if( next > to ) {
+            break;
+        }
+        if( next > now() ) {
+            clock->sleepUntil( next );
+        }
+        fired += advance();
+    }
+    if( to != UINT64_MAX ) {
+        clock->sleepUntil( to );
+        fired += advanceTo( to );
+    }
+    return fired;
+}
+
+
+void TimerWheel::unlink( Link *l ) {
+    l->prev->next = l->next;
+    l->next->prev = l->prev;
+    l->prev = l->next = nullptr;
+}
+
+void TimerWheel::append( Link *head, Link *l ) {
+    l->prev = head->prev;
+    l->next = head;
+    head->prev->next = l;
+    head->prev = l;
+}
@@ -0,0 +1,179 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <cstdint>
+#include <cstddef>
+#include "clock.h"
+using namespace std;
+
+
+/**
+ * @brief The TimerWheel class implements a hashed hierarchical timer wheel
+ * that manages large numbers of timers with O(1) insert and cancel.
+ *
+ * Time is measured in ticks of 1 msec of a pluggable clock (ClockIntf),
+ * which is the monotonic clock by default and can be a VirtualClock to
+ * run timers faster than real time. The wheel consists of 5 levels:
+ * level 0 has 256 slots of 1 tick each, levels 1..4 have 64 slots each
+ * covering 64 times the range of the level below. Timers are kept in
+ * intrusive doubly-linked slot lists. When level 0 wraps around, the next
+ * slot of level 1 is cascaded (re-inserted) into level 0, and so on.
+ *
+ * Expired timers are collected per slot and processed in a batch. Timer
+ * entries can be (re-)scheduled or cancelled from within expired().
+ *
+ * The wheel does not own a thread. It is advanced either by a driver bound
+ * to an event loop (e.g. TimerWheelDriver for Qt), or headless by run(),
+ * runUntil() or advance() invoked from a custom loop. A wheel must only be used from
+ * the thread that advances it.
+ */
+class TimerWheel {
+
+    /**
+     * @brief Link of intrusive doubly-linked lists used for slots.
+     */
+    struct Link {
+        Link *prev = nullptr;
+        Link *next = nullptr;
+    };
+
+  public:
+    /**
+     * @brief Entry is the base class of timers managed by the wheel.
+     * Subclasses implement expired(), which is invoked when the timer
+     * has expired. An entry is pending while it is scheduled.
+     */
+    class Entry : private Link {
+        friend class TimerWheel;
+
+      public:
+        Entry() {}
+        virtual ~Entry();
+
+        /**
+         * @brief expired is invoked by the wheel when the entry expires.
+         */
+        virtual void expired() = 0;
+
+        bool isPending() const { return next != nullptr; }
+        uint64_t getExpiry() const { return expires; }
+
+      private:
+        Entry( const Entry& ) = delete;
+        Entry& operator=( const Entry& ) = delete;
+
+        uint64_t expires = 0;           // absolute expiry tick
+        TimerWheel *wheel = nullptr;    // wheel at which entry is pending
+    };
+
+    /**
+     * @brief Abstract class that defines the interface of drivers that
+     * advance a wheel from an event loop. rearm() is invoked when an entry
+     * has been scheduled to expire at tick 'when'.
+     */
+    class DriverIntf {
+      public:
+        virtual ~DriverIntf();
+        virtual void rearm( uint64_t when ) = 0;
+    };
+
+    TimerWheel( ClockIntf& clock = MonotonicClock::getInstance() ) : clock( &clock ) { init(); }
+    ~TimerWheel();
+
+    /**
+     * @brief getInstance returns the default wheel driven by the main
+     * event loop. The instance is created on first invocation.
+     * @return reference to default TimerWheel instance.
+     */
+    static TimerWheel& getInstance();
+
+    /**
+     * @brief schedule an entry to expire 'delay' ticks from now() or at
+     * absolute tick 'when'. A pending entry is rescheduled.
+     * cancel() removes a pending entry from the wheel.
+     * @param e timer entry.
+     * @param delay relative expiry in ticks (msec).
+     * @param when absolute expiry tick.
+     */
+    void schedule( Entry& e, uint64_t delay );
+    void scheduleAt( Entry& e, uint64_t when );
+    void cancel( Entry& e );
+
+    /**
+     * @brief advance processes all entries that have expired until now()
+     * or until tick 'to' in batches per slot.
+     * @param to absolute tick until which entries are expired.
+     * @return number of expired entries.
+     */
+    size_t advance() { return advanceTo( now() ); }
+    size_t advanceTo( uint64_t to );
+
+    /**
+     * @brief nextExpiry returns a lower bound of the tick at which the next
+     * entry expires, which may be the tick of a cascade. Drivers use it to
+     * sleep until the wheel needs to be advanced.
+     * @return tick of next expiry or UINT64_MAX if no entry is pending.
+     */
+    uint64_t nextExpiry() const;
+
+    /**
+     * @brief run is a headless loop that sleeps until the next expiry and
+     * advances the wheel until no entry is pending. runUntil() runs the
+     * loop until the clock has reached tick 'to'. With a VirtualClock,
+     * sleeping returns instantly.
+     * @param to absolute tick until which the wheel is run.
+     * @return number of expired entries.
+     */
+    size_t run() { return runUntil( UINT64_MAX ); }
+    size_t runUntil( uint64_t to );
+
+    /**
+     * @brief now returns the current tick of the wheel's clock.
+     * @return time of clock in msec.
+     */
+    uint64_t now() const { return clock->now(); }
+
+    /**
+     * @brief setClock replaces the clock of the wheel, which is only
+     * possible while no entry is pending.
+     * @param clock new clock.
+     * @return true if clock has been replaced.
+     */
+    bool setClock( ClockIntf& clock );
+    ClockIntf& getClock() { return *clock; }
+
+    size_t size() const { return count; }
+    void setDriver( DriverIntf *driver ) { this->driver = driver; }
+
+  private:
+    static const int L0_BITS = 8;
+    static const int LN_BITS = 6;
+    static const int L0_SIZE = 1 << L0_BITS;    // 256 slots on level 0
+    static const int LN_SIZE = 1 << LN_BITS;    // 64 slots on levels 1..4
+    static const int LN_LEVELS = 4;
+    static const uint64_t MAX_DELAY = ( uint64_t( 1 ) << ( L0_BITS + LN_LEVELS * LN_BITS ) ) - 1;
+
+    void init();
+    void insert( Entry& e );
+    void cascade( int level, int index );
+
+    static void unlink( Link *l );
+    static void append( Link *head, Link *l );
+
+    Link l0[ L0_SIZE ];                 // level 0 slots
+    Link ln[ LN_LEVELS ][ LN_SIZE ];    // level 1..4 slots
+    uint64_t l0map[ L0_SIZE / 64 ] = {};    // occupancy bitmaps, bits
+    uint64_t lnmap[ LN_LEVELS ] = {};       // may be stale after cancel()
+
+    Link expiredList;                   // batch of entries being expired
+
+    uint64_t current = 0;               // next tick to process
+    size_t count = 0;                   // number of pending entries
+    DriverIntf *driver = nullptr;
+    ClockIntf *clock;
+
+    static TimerWheel *_this;           // private static pointer declaration
+                                        // for default instance
+};
+
+#endif // TIMERWHEEL_H
@@ -0,0 +1,20 @@
+#ifndef BUILDCONFIG_H
+#define BUILDCONFIG_H
+
+#include <iostream>
+using namespace std;
+
+
+/**
+ * @brief BuildConfig holds the options of the components created by
+ * Builder and by Sessions, which are set from command line options in
+ * main() and passed to MainWindow::launch() or Headless::launch().
+ */
+struct BuildConfig {
+    int precision = 0;          // Calculator::Precision of calculators, 0 for Double
+    string snapshot;            // state snapshot file, empty for none (Linux only)
+    int snapshotSync = 0;       // delay of batched snapshot flushes in msec, 0 to flush each save
+    string journal;             // journal file of all calculators, empty for none (Linux only)
+};
+
+#endif // BUILDCONFIG_H
@@ -4,7 +4,13 @@
 #include "maincontroller.h"
 #include "displaycontroller.h"
 #include "calculator.h"
+#include "countdown.h"
 #include "inputprocessor.h"
+#include "statsdumper.h"
+#ifdef __linux__
+#include "statesnapshot.h"
+#include "journal.h"
+#endif
 
 
 /**
@@ -32,9 +38,14 @@ Builder::~Builder() {
 /**
  * @brief build central method of Builder singleton instance to create
  * and configure system components.
+ * @param config options of components, kept for sessions.
+ * @param fastStart skip probing and defer creation of loggers, which
+ * are then created by invoking buildLoggers().
  * @return true in case of successful completion.
  */
-bool Builder::build() {
+bool Builder::build( const BuildConfig& config, bool fastStart ) {
+    this->config = config;
+
     // Build EventFactory singleton instance and initialize member variable.
     eventFactory = &XEventFactory::getInstance();
 
@@ -50,13 +61,42 @@ bool Builder::build() {
 
     displayController = &DisplayController::getInstance( "DisplayController", *this, ctrlMsgPublisherImpl );
     calculatorUnit = &Calculator::getInstance( "CalculatorUnit" );
-    inputProcessor = &InputProcessor::getInstance( "InputProcessor", *this, *calculatorUnit, ctrlMsgPublisherImpl );
+    calculatorUnit->setPrecision( Calculator::Precision( config.precision ) );
+    countdownUnit = new CountdownEngine( "CountdownUnit" );
+    inputProcessor = &InputProcessor::getInstance( "InputProcessor", *this, *calculatorUnit, *countdownUnit,
+                                                   *displayController, ctrlMsgPublisherImpl );
 
     // inputProcessor must subscribe at guiFacade to receive input events.
     // This is the same as:
     // inpEvtPublisherImpl->subscribe( *inputProcessor );
     guiFacade->subscribe( *inputProcessor );
 
+#ifdef __linux__
+    // Reductions of all calculators are journalled, if a journal is configured.
+    if( ! config.journal.empty() ) {
+        buildJournal( config.journal );
+    }
+
+    // The logical state is restored from a snapshot, if one is configured,
+    // before MainController is started.
+    if( ! config.snapshot.empty() ) {
+        buildSnapshot( config.snapshot, config.snapshotSync );
+    }
+#endif
+
+    if( fastStart ) {
+        mainController->enableProbing = false;
+    } else {
+        buildLoggers();
+    }
+    return true;
+}
+
+
+/**
+ * @brief buildLoggers creates loggers and subscribes them to publishers.
+ */
+void Builder::buildLoggers() {
     // Logging can be configured by creating logger instances that implement
     // SubscriberIntf and subscribe to publishers in controllers.
     ctrlMsgLogger = new SimpleLogger( "Simple Ctrl-msg logger" );
@@ -70,16 +110,85 @@ bool Builder::build() {
     if( keyEventLogger ) {
         guiFacade->subscribe( *keyEventLogger );
     }
+}
 
-    return true;
+
+/**
+ * @brief buildStats creates a StatsDumper that periodically writes the
+ * statistics of all controllers to a stats file.
+ * @param path of stats file.
+ * @param msec period of writing the file.
+ */
+void Builder::buildStats( const string& path, int msec ) {
+    vector<ControllerIntf *> controllers;
+    controllers.push_back( mainController );
+    controllers.push_back( inputProcessor );
+    controllers.push_back( displayController );
+    delete statsDumper;
+    statsDumper = new StatsDumper( path, controllers, msec );
+    statsDumper->start();
+}
+
+
+#ifdef __linux__
+/**
+ * @brief buildSnapshot creates a StateSnapshot, restores the state saved
+ * last and subscribes the snapshot to input events and control messages.
+ * Without a snapshot file, the application runs without snapshots.
+ * @param path of snapshot file.
+ * @param syncMsec delay of batched flushes to disk, 0 to flush each save.
+ */
+void Builder::buildSnapshot( const string& path, int syncMsec ) {
+    try {
+        stateSnapshot = new StateSnapshot( path, *inputProcessor, *calculatorUnit, syncMsec );
+
+    } catch( exception& e ) {
+        cerr << e.what() << endl;
+        return;
+    }
+    mainController->restored = stateSnapshot->restore();
+    guiFacade->subscribe( *stateSnapshot );
+    mainController->subscribe( *stateSnapshot );
 }
 
+/**
+ * @brief buildJournal creates a Journal and attaches the calculator as
+ * session 0. Sessions attach their calculators when they are created.
+ * @param path of journal file.
+ */
+void Builder::buildJournal( const string& path ) {
+    try {
+        journal = new Journal( path );
+
+    } catch( exception& e ) {
+        cerr << e.what() << endl;
+        return;
+    }
+    journal->attach( *calculatorUnit, 0 );
+}
+#endif
+
 
 /**
  * @brief destroy is the counter-method to build tearing down all
  * previously built components.
  */
 void Builder::destroy() {
+    delete statsDumper;
+    statsDumper = nullptr;
+#ifdef __linux__
+    if( stateSnapshot ) {
+        mainController->unsubscribe( *stateSnapshot );
+        guiFacade->unsubscribe( *stateSnapshot );
+        delete stateSnapshot;
+        stateSnapshot = nullptr;
+    }
+    if( journal ) {
+        journal->detach( *calculatorUnit );
+        delete journal;
+        journal = nullptr;
+    }
+#endif
     if( keyEventLogger ) {
         guiFacade->unsubscribe( *keyEventLogger );
         delete keyEventLogger;
@@ -91,6 +200,7 @@ void Builder::destroy() {
         delete ctrlMsgLogger;
     }
     delete inputProcessor;
+    delete countdownUnit;
     delete calculatorUnit;
     delete displayController;
     delete mainController;
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include "display.h"
+#include "buildconfig.h"
 using namespace std;
 class XEventFactory;
 class GuiFacade;
@@ -10,7 +11,11 @@ class MainController;
 class DisplayController;
 class InputProcessor;
 class Calculator;
+class CountdownEngine;
 class SubscriberIntf;
+class StatsDumper;
+class StateSnapshot;
+class Journal;
 
 
 /**
@@ -25,6 +30,7 @@ class SubscriberIntf;
 class Builder {
     friend class MainWindow;        // invokes getInstance(&gui), build()
     friend class MainController;    // invokes builder.destroy();
+    friend class Headless;          // invokes getInstance(&gui), build()
 
   public:
 
@@ -36,6 +42,43 @@ class Builder {
     DisplayController& getDisplayController() { return *displayController; }
     InputProcessor& getInputProcessor() { return *inputProcessor; }
     Calculator& getCalculatorUnit() { return *calculatorUnit; }
+    CountdownEngine& getCountdownUnit() { return *countdownUnit; }
+    const BuildConfig& getConfig() const { return config; }
+
+    /**
+     * @brief buildStats creates a StatsDumper that periodically writes the
+     * statistics of all controllers to a stats file. Requires built
+     * components, the dumper is destroyed with them.
+     * @param path of stats file.
+     * @param msec period of writing the file.
+     */
+    void buildStats( const string& path, int msec = 1000 );
+
+#ifdef __linux__
+    /**
+     * @brief buildSnapshot creates a StateSnapshot that saves the logical
+     * state on each change and restores the state saved last, in which case
+     * MainController starts with the restored state without probing.
+     * Invoked by build() if a snapshot is set in the BuildConfig.
+     * @param path of snapshot file.
+     * @param syncMsec delay of batched flushes to disk, 0 to flush each save.
+     */
+    void buildSnapshot( const string& path, int syncMsec = 0 );
+
+    /**
+     * @brief buildJournal creates a Journal that appends every reduction of
+     * the calculator (session 0) and of all Sessions to a journal file.
+     * Invoked by build() if a journal is set in the BuildConfig. The
+     * journal is committed and closed when the components are destroyed.
+     * @param path of journal file.
+     */
+    void buildJournal( const string& path );
+
+    /**
+     * @brief getJournal returns the journal, nullptr if none is built.
+     */
+    Journal *getJournal() { return journal; }
+#endif
 
   private:
 
@@ -63,9 +106,13 @@ class Builder {
     /**
      * @brief build central method of Builder singleton instance to create
      * and configure system components.
+     * @param config options of components, kept for sessions.
+     * @param fastStart skip probing and defer creation of loggers, which
+     * are then created by invoking buildLoggers().
      * @return true in case of successful completion.
      */
-    bool build();
+    bool build( const BuildConfig& config, bool fastStart = false );
+    void buildLoggers();
 
     /**
      * @brief destroy is the counter-method to build tearing down all
@@ -83,10 +130,15 @@ class Builder {
     DisplayController *displayController;
     InputProcessor *inputProcessor;
     Calculator *calculatorUnit;
+    CountdownEngine *countdownUnit;
 
     SubscriberIntf *ctrlMsgLogger = nullptr;
     SubscriberIntf *keyEventLogger = nullptr;
+    StatsDumper *statsDumper = nullptr;
+    StateSnapshot *stateSnapshot = nullptr;
+    Journal *journal = nullptr;
 
+    BuildConfig config;             // options of components built
     const Ui::Display& uiDisplay;   // temp, passed to GuiFacade for build
     static Builder *_this;          // private static pointer declaration
                                     // for singleton instance
@@ -24,52 +24,35 @@ DisplayController& DisplayController::getInstance( const string name, Builder& b
 DisplayController *DisplayController::_this = nullptr;
 
 
-DisplayController::~DisplayController() {
-    logDestructor( getName() );
+/**
+ * @brief Private constructor invoked by getInstance( ... ).
+ * @param name of controller.
+ * @param builder reference to builder instance.
+ * @param pub reference to optional publisher of controller events.
+ * @param backend display backend, GuiFacade if nullptr.
+ */
+DisplayController::DisplayController( const string name, Builder& builder, PublisherIntf *pub,
+                                      DisplayBackendIntf *backend )
+    : ControllerIntf( name, pub ), builder( builder ), backend( backend )
+{
+    if( this->backend == nullptr ) {
+        this->backend = builder.getGui();
+    }
 }
 
 
+
 /**
  * @brief updateDisplay pushes 10-digit buffer content to display.
  * Buffer may contain '.', ',' or ':' that will be displayed by turning
  * on repsective symbols on corresponding digits. Buffer length thus
- * can be >10 digits.
+ * can be >10 digits. The buffer is encoded into a SegmentFrame in one
+ * pass, which is rendered by the display backend.
  * @param buffer string to display, e.g. "12.345" or "12:00:00"
  */
 void DisplayController::updateDisplay( string buffer ) {
-    //cout << "--> '" << buffer << "'\t";
-    gui->clearAll();
-    int ndots = count( buffer.begin(), buffer.end(), '.');
-    int ncolons = count( buffer.begin(), buffer.end(), ':');
-    gui->setDot( 0, ndots==0 && ncolons==0 );
-    int lbuf = int( buffer.length() );
-    int lmax = len + ndots + ncolons;
-    int l = lbuf > lmax? lmax : lbuf;
-    int j = 0;
-    for( int i=0; i < l; i++ ) {
-        char d = buffer.at( unsigned( l - i - 1 ) );
-        switch( d ) {
-
-        case '0': case '1': case '2': case '3': case '4':
-        case '5': case '6': case '7': case '8': case '9': {
-            int n = d - '0';
-            gui->setDigit( j, n );
-        } break;
-
-        case '.':
-            gui->setDot( j--, true );
-            break;
-
-        case ':':
-            gui->setColon( j--, true );
-            break;
-
-        case '-':
-            gui->setMinus( j );
-            break;
-        }
-        j++;
-    }
+    counters.add( ControllerStats::DisplayUpdates );
+    backend->render( SegmentFrame::encode( buffer ) );
 }
 
 
@@ -77,7 +60,9 @@ void DisplayController::updateDisplay( string buffer ) {
  * @brief setError display "Error".
  */
 void DisplayController::setError() {
-    gui->setErr();
+    counters.add( ControllerStats::Errors );
+    counters.add( ControllerStats::DisplayUpdates );
+    backend->render( SegmentFrame::error() );
 }
 
 
@@ -88,13 +73,17 @@ void DisplayController::setError() {
  *
  * The probe cycle is divided into several modes probing and displaying
  * different patterns such as an advancing dot from left to right and back
- * or blinking numbers in the display.
+ * or blinking numbers in the display. The cycle owns its interval timer,
+ * deleting the cycle cancels it.
  */
 class ProbeCycle : public SubscriberIntf {
 
   public:
-    ProbeCycle( Callback *cb ) : SubscriberIntf( "ProbeCycle" ), cb( cb ) {}
+    ProbeCycle( Callback *cb, DisplayBackendIntf& backend )
+        : SubscriberIntf( "ProbeCycle" ), cb( cb ), backend( backend ),
+          timer( "Display, Cycle_1", len, 20, this ) {}
 
+    void start() { timer.start(); }
     void notify( XEvent& e );
 
     /*
@@ -102,6 +91,8 @@ class ProbeCycle : public SubscriberIntf {
      */
     int probeMode = 0;
     Callback *cb;
+    DisplayBackendIntf& backend;
+    SegmentFrame frame;             // frame advanced by each tick
     static const int len = 82;
     const int ticks[ len ] = {
         // mode 0: show advancing/decling dots, each bit represents a dot
@@ -121,9 +112,16 @@ class ProbeCycle : public SubscriberIntf {
         // mode f: reset display to "0."
         0x800f, 0
     };
+    IntervalTimer timer;            // advances the cycle every 20 msec
 };
 
 
+DisplayController::~DisplayController() {
+    delete probeCycle;
+    logDestructor( getName() );
+}
+
+
 /**
  * @brief probe is a method that asynchronously runs the display test cycle.
  * @param cb optional callback object at which the callback(XEvent *e)-
@@ -131,47 +129,48 @@ class ProbeCycle : public SubscriberIntf {
  * to Probing mode during execution of probe cycle.
  *
  * Decoupling execution of probe() from its invocation prevents main
- * thread from being blocked for the duration of the probe cycle.
+ * thread from being blocked for the duration of the probe cycle. A
+ * previous probe cycle is cancelled.
  */
 void DisplayController::probe( Callback *cb ) {
-    XEvent& xe0 = builder.getEventFactory().getEvent( getName() + " probing..." );
-    publish( xe0 );
-    gui->clearAll();
-    ProbeCycle *c1 = new ProbeCycle( cb );
-    IntervalTimer *t1 = new IntervalTimer( "Display, Cycle_1", c1->len, 20, c1 );
-    t1->start();
+    counters.add( ControllerStats::Events );
+    publishMsg( builder.getEventFactory(), getName() + " probing..." );
+    backend->render( SegmentFrame() );
+    delete probeCycle;
+    probeCycle = new ProbeCycle( cb, *backend );
+    probeCycle->start();
 }
 
 /**
  * @brief start and transition controller to RUNNING state.
  */
 void DisplayController::start() {
-    gui->clearAll();
-    gui->setDigit( 0, 0 );
-    gui->setDot( 0, true );
-    XEvent& xe0 = builder.getEventFactory().getEvent( getName() + " started." );
-    publish( xe0 );
+    counters.add( ControllerStats::Events );
+    updateDisplay( "0" );
+    publishMsg( builder.getEventFactory(), getName() + " started." );
 }
 
 /**
  * @brief stop and transition controller trough Stopping to Stopped state.
+ * A running probe cycle is cancelled.
  * @param exit terminate programm if set to true.
  */
 void DisplayController::stop( bool /* exit */ ) {
-    gui->clearAll();
-    XEvent& xe0 = builder.getEventFactory().getEvent( getName() + " stopped." );
-    publish( xe0 );
+    counters.add( ControllerStats::Events );
+    delete probeCycle;
+    probeCycle = nullptr;
+    backend->render( SegmentFrame() );
+    publishMsg( builder.getEventFactory(), getName() + " stopped." );
 }
 
 
 /**
  * @brief ProbeCycle::notify invoked at the end of a passed interval
  * advancing the probe cycle by 1 tick, decoding content from ticks[ tick ]
- * and loading it to the display.
+ * into the frame and rendering it on the display.
  * @param e timer event.
  */
 void ProbeCycle::notify( XEvent& e ) {
-    GuiFacade *gui = Builder::getInstance().getGui();
     int i = e.ev;
     if( i < len ) {
         int t = ticks[ i ];
@@ -182,7 +181,7 @@ void ProbeCycle::notify( XEvent& e ) {
 \
             case 0:
                 for( int j=0; j < 10; j++ ) {
-                    gui->setDot( j, t & 0x01 );
+                    frame.setDot( j, t & 0x01 );
                     t = t >> 1;
                 }
                 break;
@@ -190,36 +189,39 @@ void ProbeCycle::notify( XEvent& e ) {
             case 1:
                 switch( t ) {
                 case 0:
-                    gui->clearAll();
+                    frame.clear();
                     break;
                 case 1:
                     // show: "8.8.8.8.8.8.8.8.8.8."
-                    gui->setAll( 8, true, false, false );
+                    frame.setAll( 8, true, false, false );
                     break;
                 case 2:
                     // show: "12:00:00"
-                    gui->setDigit( 0, 0 );
-                    gui->setDigit( 1, 0 );
-                    gui->setDigit( 2, 0 );
-                    gui->setDigit( 3, 0 );
-                    gui->setDigit( 4, 2 );
-                    gui->setDigit( 5, 1 );
-                    gui->setColon( 2, true );
-                    gui->setColon( 4, true );
+                    frame.setDigit( 0, 0 );
+                    frame.setDigit( 1, 0 );
+                    frame.setDigit( 2, 0 );
+                    frame.setDigit( 3, 0 );
+                    frame.setDigit( 4, 2 );
+                    frame.setDigit( 5, 1 );
+                    frame.setColon( 2, true );
+                    frame.setColon( 4, true );
                     break;
                 }
                 break;
 
             case 0xf:
-                gui->clearAll();
-                gui->setDigit( 0, 0 );
-                gui->setDot( 0, true );
+                frame.clear();
+                frame.setDigit( 0, 0 );
+                frame.setDot( 0, true );
+                backend.render( frame );
                 if( cb != nullptr ) {
                     XEvent& xe0 = Builder::getInstance().getEventFactory()
                             .getEvent( XEvent::Type::callbackEvents, MainController::OpSt::RUNNING );
-                    cb->callback( new XEvent( xe0 ) );
+                    cb->callback( &xe0 );
                 }
+                return;
             }
+            backend.render( frame );
         }
     }
 }
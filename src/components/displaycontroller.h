@@ -2,7 +2,9 @@
 #define DISPLAYCONTROLLER_H
 
 #include "controllerintf.h"
+#include "segmentframe.h"
 #include "builder.h"
+class ProbeCycle;
 using namespace std;
 
 
@@ -11,9 +13,13 @@ using namespace std;
  * display controller providing Qt-independent access to the 10-digit display.
  * Methods of ControllerIntf are implemented, inclduing a probe cycle that
  * runs a series of test-pattern for calculator and timer modes.
+ *
+ * Display content is passed as SegmentFrame to a display backend, which
+ * is GuiFacade unless another backend is injected.
  */
 class DisplayController : public ControllerIntf {
     friend class Builder;
+    friend class Session;
 
   public:
     /**
@@ -23,7 +29,9 @@ class DisplayController : public ControllerIntf {
      * to Probing mode during execution of probe cycle.
      *
      * Decoupling execution of probe() from its invocation prevents main
-     * thread from being blocked for the duration of the probe cycle.
+     * thread from being blocked for the duration of the probe cycle. The
+     * probe cycle is owned by the controller and cancelled by stop() or
+     * by the next probe().
      */
     virtual void probe( Callback *cb = nullptr );
 
@@ -52,7 +60,16 @@ class DisplayController : public ControllerIntf {
      */
     void setError();
 
-    int static const len = 10;          // 10 digits in display
+    /**
+     * @brief render passes a frame to the display backend.
+     * @param f frame to display.
+     */
+    void render( const SegmentFrame& f ) {
+        counters.add( ControllerStats::DisplayUpdates );
+        backend->render( f );
+    }
+
+    int static const len = SegmentFrame::CELLS;     // 10 digits in display
 
 
   private:
@@ -61,9 +78,10 @@ class DisplayController : public ControllerIntf {
      * @param name of controller.
      * @param builder reference to builder instance.
      * @param pub reference to optional publisher of controller events.
+     * @param backend display backend, GuiFacade if nullptr.
      */
-    DisplayController( const string name, Builder& builder, PublisherIntf *pub = nullptr )
-        : ControllerIntf( name, pub ), builder( builder ), gui( builder.getGui() ) {}
+    DisplayController( const string name, Builder& builder, PublisherIntf *pub = nullptr,
+                       DisplayBackendIntf *backend = nullptr );
 
     virtual ~DisplayController();
 
@@ -83,7 +101,8 @@ class DisplayController : public ControllerIntf {
      * @brief Private member variables.
      */
     Builder& builder;
-    GuiFacade* gui = nullptr;
+    DisplayBackendIntf *backend = nullptr;
+    ProbeCycle *probeCycle = nullptr;   // running or completed probe cycle
 
     static DisplayController *_this;    // private static pointer declaration
                                         // for singleton instance
@@ -16,6 +16,35 @@ XEventFactory& XEventFactory::getInstance() {
 XEventFactory *XEventFactory::_this = nullptr;
 
 
+/**
+ * @brief Private constructor creates interned key input, callback and
+ * timer events.
+ */
+XEventFactory::XEventFactory() {
+    for( int i=0; i < KEY_EVENTS; i++ ) {
+        keyEvents[i] = new XEvent( i );
+    }
+    for( int i=0; i < CALLBACK_EVENTS; i++ ) {
+        callbackEvents[i] = new XEvent( XEvent::Type::callbackEvents, i );
+    }
+    for( int i=0; i < TIMER_EVENTS; i++ ) {
+        timerEvents[i] = new XEvent( XEvent::Type::timerEvents, i );
+    }
+}
+
+XEventFactory::~XEventFactory() {
+    for( int i=0; i < KEY_EVENTS; i++ ) {
+        delete keyEvents[i];
+    }
+    for( int i=0; i < CALLBACK_EVENTS; i++ ) {
+        delete callbackEvents[i];
+    }
+    for( int i=0; i < TIMER_EVENTS; i++ ) {
+        delete timerEvents[i];
+    }
+}
+
+
 /**
  * @brief Public factory methods to create XEvent instances.
  * @param ev event as int from type set.
@@ -23,13 +52,36 @@ XEventFactory *XEventFactory::_this = nullptr;
  * @param msg message.
  */
 XEvent& XEventFactory::getEvent( const int ev ) {
+    if( ev >= 0 && ev < KEY_EVENTS ) {
+        return *keyEvents[ ev ];
+    }
     return *new XEvent( ev );
 }
 
 XEvent& XEventFactory::getEvent( const int type, const int ev ) {
+    if( type == XEvent::Type::callbackEvents && ev >= 0 && ev < CALLBACK_EVENTS ) {
+        return *callbackEvents[ ev ];
+    }
+    if( type == XEvent::Type::timerEvents && ev >= 0 && ev < TIMER_EVENTS ) {
+        return *timerEvents[ ev ];
+    }
     return *new XEvent( type, ev );
 }
 
 XEvent& XEventFactory::getEvent( const string msg  ) {
     return *new XEvent( msg );
 }
+
+/**
+ * @brief release deletes an event that is not interned. Interned events
+ * are the only events of their type and number, see getEvent().
+ * @param e event created by the factory.
+ */
+void XEventFactory::release( XEvent& e ) {
+    bool interned = ( e.type == XEvent::Type::keyInputEvents && e.ev >= 0 && e.ev < KEY_EVENTS ) ||
+                    ( e.type == XEvent::Type::callbackEvents && e.ev >= 0 && e.ev < CALLBACK_EVENTS ) ||
+                    ( e.type == XEvent::Type::timerEvents && e.ev >= 0 && e.ev < TIMER_EVENTS );
+    if( ! interned ) {
+        delete &e;
+    }
+}
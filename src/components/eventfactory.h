@@ -9,6 +9,16 @@ class XEvent;
 /**
  * @brief The EventFactory class defines the EventFactory singleton
  * instance that exclusively creates XEvents.
+ *
+ * Key input events are immutable and interned: getEvent( ev ) returns
+ * the same instance for the same key, such that publishing keys does
+ * not allocate. Callback events reporting results of control operations
+ * and timer events carrying tick counts of interval timers are interned
+ * likewise. Interned events are created with the factory,
+ * which makes getEvent( ev ) safe to use from several threads.
+ *
+ * Message events are created per message and released after they were
+ * published.
  */
 class XEventFactory {
 
@@ -29,11 +39,27 @@ class XEventFactory {
     XEvent& getEvent( const int type, const int ev );
     XEvent& getEvent( const string msg  );
 
+    /**
+     * @brief release deletes an event that is not interned, e.g. a message
+     * event after it was published. Interned events are kept.
+     * @param e event created by the factory.
+     */
+    void release( XEvent& e );
+
+    ~XEventFactory();
+
   private:
     /**
      * @brief Private constructor invoked by EventFactory::getInstance().
      */
-    XEventFactory() {}
+    XEventFactory();
+
+    static const int KEY_EVENTS = 64;   // number of interned key input events
+    XEvent *keyEvents[ KEY_EVENTS ];
+    static const int CALLBACK_EVENTS = 8;   // number of interned callback events
+    XEvent *callbackEvents[ CALLBACK_EVENTS ];
+    static const int TIMER_EVENTS = 128;    // number of interned timer events
+    XEvent *timerEvents[ TIMER_EVENTS ];
 
     static XEventFactory *_this;     // private static pointer declaration
                                     // for singleton instance
@@ -0,0 +1,623 @@
+#include <stdexcept>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "historyarchive.h"
+#include "historystore.h"
+#include "calculator.h"
+
+
+static_assert( sizeof( double ) == 8, "doubles must be 64-bit" );
+
+static const unsigned DOD_BITS[] = { 0, 7, 9, 12, 20, 32, 64 };     // delta-of-delta buckets
+
+
+/**
+ * @brief BitWriter appends values of 1..64 bits MSB first to a vector of
+ * 64-bit words.
+ */
+struct BitWriter {
+    BitWriter( vector<uint64_t>& words ) : words( words ) {}
+
+    void put( uint64_t v, unsigned n ) {
+        unsigned free = 64 - used;
+        if( n < free ) {
+            cur |= v << ( free - n );
+            used += n;
+        } else {
+            unsigned k = n - free;          // bits left for the next word
+            cur |= v >> k;
+            words.push_back( cur );
+            cur = k > 0? v << ( 64 - k ) : 0;
+            used = k;
+        }
+    }
+
+    void flush() {
+        if( used > 0 ) {
+            words.push_back( cur );
+        }
+        cur = 0;
+        used = 0;
+    }
+
+    vector<uint64_t>& words;
+    uint64_t cur = 0;
+    unsigned used = 0;
+};
+
+/**
+ * @brief BitReader reads values of 1..64 bits MSB first from 64-bit words.
+ * Reading beyond the end yields zero bits.
+ */
+struct BitReader {
+    BitReader( const uint64_t *p, size_t n ) : p( p ), end( p + n ) {}
+
+    uint64_t get( unsigned n ) {
+        if( n <= left ) {
+            uint64_t v = cur >> ( 64 - n );
+            cur = cur << 1 << ( n - 1 );
+            left -= n;
+            return v;
+        }
+        unsigned k = n - left;              // bits from the next word
+        uint64_t v = left > 0? cur >> ( 64 - left ) : 0;
+        uint64_t w = p < end? *p++ : 0;
+        v = ( v << 1 << ( k - 1 ) ) | ( w >> ( 64 - k ) );
+        cur = w << 1 << ( k - 1 );
+        left = 64 - k;
+        return v;
+    }
+
+    /**
+     * @brief ones consumes up to 'max' one bits and the terminating zero
+     * bit, if any, and returns the number of ones.
+     */
+    unsigned ones( unsigned max ) {
+        if( left < max + 1 ) {
+            unsigned k = 0;
+            while( k < max && get( 1 ) ) {
+                k++;
+            }
+            return k;
+        }
+        unsigned k = min( unsigned( __builtin_clzll( ~cur | 1 ) ), max );
+        unsigned n = k < max? k + 1 : k;
+        cur = cur << 1 << ( n - 1 );
+        left -= n;
+        return k;
+    }
+
+    const uint64_t *p;
+    const uint64_t *end;
+    uint64_t cur = 0;
+    unsigned left = 0;
+};
+
+
+static uint64_t bits( double d ) {
+    uint64_t v;
+    memcpy( &v, &d, 8 );
+    return v;
+}
+
+/**
+ * @brief putXor appends doubles XOR-compressed against their predecessor:
+ * '0' if equal, '10' and the significant bits if they fit into the window
+ * of leading and trailing zeros of the previous value, else '11', 5 bits
+ * leading zeros, 6 bits length and the significant bits.
+ */
+static void putXor( BitWriter& out, const double *values, uint32_t n ) {
+    uint64_t prev = bits( values[0] );
+    out.put( prev, 64 );
+    unsigned lead = 65, trail = 0;
+    for( uint32_t i=1; i < n; i++ ) {
+        uint64_t v = bits( values[i] );
+        uint64_t x = v ^ prev;
+        prev = v;
+        if( x == 0 ) {
+            out.put( 0, 1 );
+            continue;
+        }
+        unsigned l = min( unsigned( __builtin_clzll( x ) ), 31u );
+        unsigned t = unsigned( __builtin_ctzll( x ) );
+        if( lead <= 64 && l >= lead && t >= trail ) {
+            out.put( 2, 2 );
+            out.put( x >> trail, 64 - lead - trail );
+        } else {
+            unsigned sig = 64 - l - t;
+            out.put( 3, 2 );
+            out.put( l, 5 );
+            out.put( sig & 63, 6 );
+            out.put( x >> t, sig );
+            lead = l;
+            trail = t;
+        }
+    }
+}
+
+/**
+ * @brief XorDecoder decodes the values of putXor() one by one.
+ */
+struct XorDecoder {
+    XorDecoder( const uint64_t *p, size_t n ) : in( p, n ), v( in.get( 64 ) ) {}
+
+    uint64_t next() {
+        unsigned k = in.ones( 2 );
+        if( k > 0 ) {
+            if( k == 2 ) {
+                lead = unsigned( in.get( 5 ) );
+                sig = unsigned( in.get( 6 ) );
+                sig = sig == 0? 64 : sig;
+            }
+            v ^= in.get( sig ) << ( ( 64 - lead - sig ) & 63 );
+        }
+        return v;
+    }
+
+    BitReader in;
+    uint64_t v;
+    unsigned lead = 0;
+    unsigned sig = 64;
+};
+
+/**
+ * @brief putTimes appends timestamps as first value and delta-of-deltas:
+ * '0' if the delta is unchanged, else 1 to 6 one bits selecting the bucket
+ * of DOD_BITS, terminated by '0' below 6, and the two's complement.
+ */
+static void putTimes( BitWriter& out, const uint64_t *usec, uint32_t n ) {
+    out.put( usec[0], 64 );
+    uint64_t delta = 0;
+    for( uint32_t i=1; i < n; i++ ) {
+        uint64_t d = usec[i] - usec[ i - 1 ];
+        int64_t dod = int64_t( d - delta );
+        delta = d;
+        unsigned k = 0;
+        if( dod != 0 ) {
+            for( k=1; k < 6; k++ ) {
+                int64_t limit = int64_t( 1 ) << ( DOD_BITS[k] - 1 );
+                if( dod >= -limit && dod < limit ) {
+                    break;
+                }
+            }
+        }
+        if( k < 6 ) {
+            out.put( ( ( uint64_t( 1 ) << k ) - 1 ) << 1, k + 1 );
+        } else {
+            out.put( 63, 6 );
+        }
+        if( k > 0 ) {
+            unsigned b = DOD_BITS[k];
+            out.put( b < 64? uint64_t( dod ) & ( ( uint64_t( 1 ) << b ) - 1 ) : uint64_t( dod ), b );
+        }
+    }
+}
+
+/**
+ * @brief TimeDecoder decodes the timestamps of putTimes() one by one.
+ */
+struct TimeDecoder {
+    TimeDecoder( const uint64_t *p, size_t n ) : in( p, n ), t( in.get( 64 ) ) {}
+
+    uint64_t next() {
+        unsigned k = in.ones( 6 );
+        if( k > 0 ) {
+            unsigned b = DOD_BITS[k];
+            uint64_t v = in.get( b );
+            if( b < 64 ) {
+                uint64_t sign = uint64_t( 1 ) << ( b - 1 );
+                v = ( v ^ sign ) - sign;    // sign extension
+            }
+            delta += v;
+        }
+        t += delta;
+        return t;
+    }
+
+    BitReader in;
+    uint64_t t;
+    uint64_t delta = 0;
+};
+
+/**
+ * @brief pack appends codes of 'b' bits LSB first plus one padding word,
+ * such that unpack() can always read two adjacent words.
+ */
+static void pack( vector<uint64_t>& words, const uint32_t *codes, uint32_t n, unsigned b ) {
+    size_t base = words.size();
+    words.resize( base + ( size_t( n ) * b + 63 ) / 64 + 1, 0 );
+    for( uint32_t i=0; b > 0 && i < n; i++ ) {
+        size_t p = size_t( i ) * b;
+        unsigned o = unsigned( p & 63 );
+        words[ base + p / 64 ] |= uint64_t( codes[i] ) << o;
+        if( o + b > 64 ) {
+            words[ base + p / 64 + 1 ] |= uint64_t( codes[i] ) >> ( 64 - o );
+        }
+    }
+}
+
+/**
+ * @brief unpack decodes 'n' codes of 'b' bits and looks them up in 'dict'
+ * of 2^b entries. The loop is branch-free.
+ */
+template<typename T>
+static void unpack( const uint64_t *words, unsigned b, const vector<uint64_t>& dict, uint32_t n, T *out ) {
+    uint64_t mask = ( uint64_t( 1 ) << b ) - 1;
+    for( uint32_t i=0; i < n; i++ ) {
+        size_t p = size_t( i ) * b;
+        const uint64_t *q = words + p / 64;
+        unsigned o = unsigned( p & 63 );
+        uint64_t code = ( ( q[0] >> o ) | ( q[1] << 1 << ( 63 - o ) ) ) & mask;
+        out[i] = T( dict[ code ] );
+    }
+}
+
+/**
+ * @brief dictionary appends the distinct values of a field to 'words' in
+ * order of first occurrence and returns their codes and bit width.
+ */
+template<typename T>
+static unsigned dictionary( vector<uint64_t>& words, const vector<T>& values, vector<uint32_t>& codes ) {
+    unordered_map<T, uint32_t> dict;
+    codes.resize( values.size() );
+    for( size_t i=0; i < values.size(); i++ ) {
+        typename unordered_map<T, uint32_t>::iterator it = dict.find( values[i] );
+        if( it == dict.end() ) {
+            it = dict.insert( make_pair( values[i], uint32_t( dict.size() ) ) ).first;
+            words.push_back( uint64_t( values[i] ) );
+        }
+        codes[i] = it->second;
+    }
+    unsigned b = 0;
+    while( ( size_t( 1 ) << b ) < dict.size() ) {
+        b++;
+    }
+    return b;
+}
+
+static void writeFully( int fd, const void *buf, size_t n, const string& path ) {
+    const char *p = static_cast<const char *>( buf );
+    while( n > 0 ) {
+        ssize_t w = ::write( fd, p, n );
+        if( w < 0 && errno == EINTR ) {
+            continue;
+        }
+        if( w <= 0 ) {
+            throw runtime_error( "cannot write archive " + path + ": " + strerror( errno ) );
+        }
+        p += w;
+        n -= size_t( w );
+    }
+}
+
+static uint64_t nsecSince( chrono::steady_clock::time_point t0 ) {
+    return uint64_t( chrono::duration_cast<chrono::nanoseconds>( chrono::steady_clock::now() - t0 ).count() );
+}
+
+
+/**
+ * @brief HistoryArchive constructor opens an archive file for streaming and
+ * checks its header.
+ * @param path of archive file.
+ * @throws runtime_error if the file cannot be opened or is no archive.
+ */
+HistoryArchive::HistoryArchive( const string& path ) : path( path ) {
+    static_assert( sizeof( Chunk ) == 64, "Chunk must have no padding" );
+    fd = open( path.c_str(), O_RDONLY );
+    if( fd < 0 ) {
+        throw runtime_error( "cannot open archive " + path + ": " + strerror( errno ) );
+    }
+    posix_fadvise( fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+    uint32_t h[ HEADER_SIZE / 4 ];
+    if( ! readFully( h, HEADER_SIZE ) || h[0] != MAGIC || h[1] != VERSION || h[2] != CHUNK_ROWS ) {
+        ::close( fd );
+        throw runtime_error( "no archive or unsupported version: " + path );
+    }
+}
+
+HistoryArchive::~HistoryArchive() {
+    ::close( fd );
+}
+
+
+/**
+ * @brief HistoryArchive::build writes an archive file from a journal file
+ * chunk by chunk. The archive is written to a temporary file, which
+ * replaces 'path' when complete.
+ * @param journal path of journal file.
+ * @param path of archive file.
+ * @return number of rows.
+ * @throws runtime_error if a file cannot be read or written.
+ */
+uint64_t HistoryArchive::build( const string& journal, const string& path ) {
+    JournalReader in( journal );
+    string tmp = path + ".tmp";
+    int fd = open( tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    if( fd < 0 ) {
+        throw runtime_error( "cannot write archive " + tmp + ": " + strerror( errno ) );
+    }
+    try {
+        uint32_t h[ HEADER_SIZE / 4 ] = { MAGIC, VERSION, CHUNK_ROWS, 0 };
+        writeFully( fd, h, HEADER_SIZE, tmp );
+        vector<uint64_t> words;
+        for( size_t i=0; i < in.size(); i += CHUNK_ROWS ) {
+            Chunk c;
+            encode( in.begin() + i, uint32_t( min( in.size() - i, size_t( CHUNK_ROWS ) ) ), c, words );
+            writeFully( fd, &c, sizeof( c ), tmp );
+            writeFully( fd, words.data(), words.size() * 8, tmp );
+        }
+        if( fdatasync( fd ) < 0 ) {
+            throw runtime_error( "cannot write archive " + tmp + ": " + strerror( errno ) );
+        }
+    } catch( exception& ) {
+        ::close( fd );
+        throw;
+    }
+    ::close( fd );
+    if( rename( tmp.c_str(), path.c_str() ) != 0 ) {
+        throw runtime_error( "cannot write archive " + path + ": " + strerror( errno ) );
+    }
+    return in.size();
+}
+
+/**
+ * @brief HistoryArchive::encode compresses 'rows' records into the sections
+ * of a chunk.
+ * @param r records.
+ * @param rows number of records, 1..CHUNK_ROWS.
+ * @param c chunk header.
+ * @param words sections.
+ */
+void HistoryArchive::encode( const Journal::Record *r, uint32_t rows, Chunk& c, vector<uint64_t>& words ) {
+    vector<uint64_t> usec( rows );
+    vector<uint32_t> session( rows );
+    vector<int32_t> op( rows );
+    vector<double> values[ 3 ];
+    memset( &c, 0, sizeof( c ) );
+    c.rows = rows;
+    c.minUsec = UINT64_MAX;
+    for( int k=0; k < 3; k++ ) {
+        values[k].resize( rows );
+    }
+    for( uint32_t i=0; i < rows; i++ ) {
+        usec[i] = r[i].usec;
+        session[i] = r[i].session;
+        op[i] = r[i].op;
+        values[0][i] = r[i].operand1;
+        values[1][i] = r[i].operand2;
+        values[2][i] = r[i].result;
+        c.minUsec = min( c.minUsec, r[i].usec );
+        c.maxUsec = max( c.maxUsec, r[i].usec );
+    }
+
+    words.clear();
+    vector<uint32_t> opCodes, sessionCodes;
+    c.opBits = uint8_t( dictionary( words, op, opCodes ) );
+    c.section[ OpDict ] = uint32_t( words.size() );
+    c.sessionBits = uint8_t( dictionary( words, session, sessionCodes ) );
+    size_t start = words.size();
+    c.section[ SessionDict ] = uint32_t( start - c.section[ OpDict ] );
+    pack( words, opCodes.data(), rows, c.opBits );
+    c.section[ OpCodes ] = uint32_t( words.size() - start );
+    start = words.size();
+    pack( words, sessionCodes.data(), rows, c.sessionBits );
+    c.section[ SessionCodes ] = uint32_t( words.size() - start );
+
+    BitWriter out( words );
+    start = words.size();
+    putTimes( out, usec.data(), rows );
+    out.flush();
+    c.section[ Usec ] = uint32_t( words.size() - start );
+    for( int k=0; k < 3; k++ ) {
+        start = words.size();
+        putXor( out, values[k].data(), rows );
+        out.flush();
+        c.section[ Operand1 + k ] = uint32_t( words.size() - start );
+    }
+    c.words = uint32_t( words.size() );
+}
+
+
+/**
+ * @brief HistoryArchive::next reads and decodes the next chunk overlapping
+ * the time range [from, to). Other chunks are skipped by seeking.
+ * @param b batch receiving the decoded chunk.
+ * @param from, to time range in usec.
+ * @return false at the end of the archive.
+ * @throws runtime_error if the archive is truncated or corrupt.
+ */
+bool HistoryArchive::next( Batch& b, uint64_t from, uint64_t to ) {
+    for( ;; ) {
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        Chunk c;
+        ssize_t n = ::read( fd, &c, sizeof( c ) );
+        if( n == 0 ) {
+            readNsec += nsecSince( t0 );
+            return false;
+        }
+        if( n != ssize_t( sizeof( c ) ) && ! ( n > 0 && readFully( reinterpret_cast<char *>( &c ) + n, sizeof( c ) - size_t( n ) ) ) ) {
+            throw runtime_error( "truncated archive: " + path );
+        }
+        uint64_t sum = 0;
+        for( int i=0; i < SECTIONS; i++ ) {
+            sum += c.section[i];
+        }
+        if( c.rows == 0 || c.rows > CHUNK_ROWS || sum != c.words || c.opBits > 16 || c.sessionBits > 16
+            || c.section[ OpDict ] == 0 || c.section[ OpDict ] > ( 1u << c.opBits )
+            || c.section[ SessionDict ] == 0 || c.section[ SessionDict ] > ( 1u << c.sessionBits )
+            || c.section[ OpCodes ] < ( c.rows * c.opBits + 63 ) / 64 + 1
+            || c.section[ SessionCodes ] < ( c.rows * c.sessionBits + 63 ) / 64 + 1 ) {
+            throw runtime_error( "corrupt archive: " + path );
+        }
+        bytes += sizeof( c );
+        if( c.maxUsec < from || c.minUsec >= to ) {
+            if( lseek( fd, off_t( c.words ) * 8, SEEK_CUR ) < 0 ) {
+                throw runtime_error( "truncated archive: " + path );
+            }
+            skipped++;
+            readNsec += nsecSince( t0 );
+            continue;
+        }
+        words.resize( c.words );
+        if( ! readFully( words.data(), size_t( c.words ) * 8 ) ) {
+            throw runtime_error( "truncated archive: " + path );
+        }
+        bytes += uint64_t( c.words ) * 8;
+        readNsec += nsecSince( t0 );
+
+        t0 = chrono::steady_clock::now();
+        decode( c, b );
+        decodeNsec += nsecSince( t0 );
+        return true;
+    }
+}
+
+/**
+ * @brief HistoryArchive::decode decompresses the sections of a chunk column
+ * by column into a batch.
+ * @param c chunk header.
+ * @param b batch.
+ */
+void HistoryArchive::decode( const Chunk& c, Batch& b ) const {
+    uint32_t rows = c.rows;
+    b.rows = rows;
+    b.minUsec = c.minUsec;
+    b.maxUsec = c.maxUsec;
+    b.usec.resize( rows );
+    b.session.resize( rows );
+    b.op.resize( rows );
+    b.operand1.resize( rows );
+    b.operand2.resize( rows );
+    b.result.resize( rows );
+
+    const uint64_t *sec[ SECTIONS ];
+    const uint64_t *p = words.data();
+    for( int i=0; i < SECTIONS; i++ ) {
+        sec[i] = p;
+        p += c.section[i];
+    }
+    vector<uint64_t> dict( size_t( 1 ) << c.opBits, 0 );
+    copy( sec[ OpDict ], sec[ OpDict ] + c.section[ OpDict ], dict.begin() );
+    unpack( sec[ OpCodes ], c.opBits, dict, rows, b.op.data() );
+    dict.assign( size_t( 1 ) << c.sessionBits, 0 );
+    copy( sec[ SessionDict ], sec[ SessionDict ] + c.section[ SessionDict ], dict.begin() );
+    unpack( sec[ SessionCodes ], c.sessionBits, dict, rows, b.session.data() );
+
+    // the streams are independent, decoding them interleaved overlaps
+    // their dependency chains
+    TimeDecoder usec( sec[ Usec ], c.section[ Usec ] );
+    XorDecoder operand1( sec[ Operand1 ], c.section[ Operand1 ] );
+    XorDecoder operand2( sec[ Operand2 ], c.section[ Operand2 ] );
+    XorDecoder result( sec[ Result ], c.section[ Result ] );
+    b.usec[0] = usec.t;
+    memcpy( &b.operand1[0], &operand1.v, 8 );
+    memcpy( &b.operand2[0], &operand2.v, 8 );
+    memcpy( &b.result[0], &result.v, 8 );
+    for( uint32_t i=1; i < rows; i++ ) {
+        b.usec[i] = usec.next();
+        uint64_t v[ 3 ] = { operand1.next(), operand2.next(), result.next() };
+        memcpy( &b.operand1[i], v, 8 );
+        memcpy( &b.operand2[i], v + 1, 8 );
+        memcpy( &b.result[i], v + 2, 8 );
+    }
+}
+
+bool HistoryArchive::readFully( void *buf, size_t n ) {
+    char *p = static_cast<char *>( buf );
+    while( n > 0 ) {
+        ssize_t r = ::read( fd, p, n );
+        if( r < 0 && errno == EINTR ) {
+            continue;
+        }
+        if( r <= 0 ) {
+            return false;
+        }
+        p += r;
+        n -= size_t( r );
+    }
+    return true;
+}
+
+
+/**
+ * @brief HistoryArchive::run builds an archive from a journal and/or
+ * replays the reductions of a time range through the batch evaluator and
+ * compares the evaluated with the archived results. Reductions of Big and
+ * Fraction precision are not compared.
+ * @param path of archive file.
+ * @param journal path of journal to build the archive from or nullptr.
+ * @param replay replay the archive.
+ * @param range time range as query expression or nullptr for all.
+ * @return exit code, 1 also if a replayed result differs.
+ */
+int HistoryArchive::run( const string& path, const char *journal, bool replay, const char *range ) {
+    char line[ 160 ];
+    try {
+        if( journal != nullptr ) {
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            uint64_t n = build( journal, path );
+            double msec = nsecSince( t0 ) / 1e6;
+            struct stat st;
+            double size = stat( path.c_str(), &st ) == 0? double( st.st_size ) : 0;
+            sprintf( line, "Archive: %llu rows archived from %s in %.1f ms, %.1f bytes per row (journal %u).",
+                     (unsigned long long) n, journal, msec, n > 0? size / n : 0.0, unsigned( sizeof( Journal::Record ) ) );
+            cout << line << endl;
+        }
+        if( replay ) {
+            HistoryStore::Query q = HistoryStore::Query::parse( range != nullptr? range : "" );
+            if( q.op != -1 || q.session != -1 || ! q.operand1.any() || ! q.operand2.any() || ! q.result.any() ) {
+                throw invalid_argument( "archive replay supports time and day predicates only" );
+            }
+            HistoryArchive archive( path );
+            Batch b;
+            vector<double> result;
+            vector<bool> exact;
+            uint64_t rows = 0, decoded = 0, chunks = 0, mismatches = 0, notReplayed = 0, evalNsec = 0;
+            while( archive.next( b, q.from, q.to ) ) {
+                chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+                exact.assign( b.rows, false );
+                for( size_t i=0; i < b.rows; i++ ) {
+                    exact[i] = ( b.op[i] >> Journal::PRECISION_SHIFT ) != Calculator::Double;
+                    b.op[i] &= Journal::OP_MASK;
+                }
+                result.resize( b.rows );
+                Calculator::evaluate( b.op.data(), b.operand1.data(), b.operand2.data(), result.data(), b.rows );
+                for( size_t i=0; i < b.rows; i++ ) {
+                    if( b.usec[i] >= q.from && b.usec[i] < q.to && exact[i] ) {
+                        notReplayed++;
+                    } else if( b.usec[i] >= q.from && b.usec[i] < q.to ) {
+                        rows++;
+                        bool same = bits( result[i] ) == bits( b.result[i] ) || ( std::isnan( result[i] ) && std::isnan( b.result[i] ) );
+                        mismatches += same? 0 : 1;
+                    }
+                }
+                evalNsec += nsecSince( t0 );
+                decoded += b.rows;
+                chunks++;
+            }
+            double decode = archive.decodeMsec();
+            sprintf( line, "Replay: %llu reductions in %llu chunks (%llu skipped), %llu mismatches, %llu exact not replayed.",
+                     (unsigned long long) rows, (unsigned long long) chunks, (unsigned long long) archive.chunksSkipped(),
+                     (unsigned long long) mismatches, (unsigned long long) notReplayed );
+            cout << line << endl;
+            sprintf( line, "Archive: %.1f MB read in %.1f ms, decoded in %.1f ms (%.0f MB/s of journal), evaluated in %.1f ms.",
+                     archive.bytesRead() / 1e6, archive.readMsec(), decode,
+                     decode > 0? decoded * sizeof( Journal::Record ) / 1e3 / decode : 0.0, evalNsec / 1e6 );
+            cout << line << endl;
+            return mismatches > 0? 1 : 0;
+        }
+
+    } catch( exception& e ) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
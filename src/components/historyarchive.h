@@ -0,0 +1,140 @@
+#ifndef HISTORYARCHIVE_H
+#define HISTORYARCHIVE_H
+
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include "journal.h"
+using namespace std;
+
+
+/**
+ * @brief The HistoryArchive class keeps calculation journals compressed
+ * for long-term storage and replays archived days through the batch
+ * evaluator Calculator::evaluate() (Linux only).
+ *
+ * The archive is a 16-byte header (magic "SE2A", version, chunk rows,
+ * reserved) followed by self-contained chunks of up to CHUNK_ROWS records.
+ * Each chunk holds its time range, such that chunks outside a replayed day
+ * are skipped unread, and one compressed stream per field:
+ *   - operators and sessions as dictionary codes, bit-packed with the
+ *     fewest bits for the dictionary of the chunk,
+ *   - timestamps delta-of-delta encoded with variable-length buckets,
+ *   - operands and results XOR-compressed against the previous value of
+ *     the field (Gorilla), such that repeated values take one bit and
+ *     similar values only their differing bits.
+ * Streams are decoded chunk by chunk (streaming) column-wise into a Batch
+ * with a bit reader consuming 64-bit words, dictionary codes are unpacked
+ * in a branch-free loop.
+ *
+ * Operators keep the precision bits of the journal. Only reductions in
+ * Double precision are replayed; those of Big and Fraction precision were
+ * journaled as rounded exact results, which double evaluation does not
+ * reproduce, and are counted as not replayed.
+ */
+class HistoryArchive {
+
+  public:
+    static const uint32_t CHUNK_ROWS = 4096;
+
+    /**
+     * @brief Batch holds the decoded columns of one chunk.
+     */
+    struct Batch {
+        size_t rows = 0;
+        uint64_t minUsec = 0;
+        uint64_t maxUsec = 0;
+        vector<uint64_t> usec;
+        vector<uint32_t> session;
+        vector<int32_t> op;
+        vector<double> operand1;
+        vector<double> operand2;
+        vector<double> result;
+    };
+
+    /**
+     * @brief HistoryArchive constructor opens an archive file for
+     * streaming.
+     * @param path of archive file.
+     * @throws runtime_error if the file cannot be opened or is no archive.
+     */
+    HistoryArchive( const string& path );
+    ~HistoryArchive();
+
+    /**
+     * @brief build writes an archive file from a journal file.
+     * @param journal path of journal file.
+     * @param path of archive file.
+     * @return number of rows.
+     * @throws runtime_error if a file cannot be read or written.
+     */
+    static uint64_t build( const string& journal, const string& path );
+
+    /**
+     * @brief next reads and decodes the next chunk overlapping the time
+     * range [from, to). Other chunks are skipped without decoding.
+     * @param b batch receiving the decoded chunk.
+     * @param from, to time range in usec.
+     * @return false at the end of the archive.
+     * @throws runtime_error if the archive is truncated or corrupt.
+     */
+    bool next( Batch& b, uint64_t from = 0, uint64_t to = UINT64_MAX );
+
+    uint64_t bytesRead() const { return bytes; }
+    uint64_t chunksSkipped() const { return skipped; }
+    double readMsec() const { return readNsec / 1e6; }
+    double decodeMsec() const { return decodeNsec / 1e6; }
+
+    /**
+     * @brief run builds an archive from a journal and/or replays it through
+     * the batch evaluator, verifying the archived results, and prints
+     * statistics. Invoked from main() for options --archive,
+     * --archive-build, --archive-replay and --query.
+     * @param path of archive file.
+     * @param journal path of journal to build the archive from or nullptr.
+     * @param replay replay the archive.
+     * @param range time range to replay as query expression with time and
+     * day predicates, e.g. "day=yesterday", or nullptr for all.
+     * @return exit code, 1 also if a replayed result differs.
+     */
+    static int run( const string& path, const char *journal, bool replay, const char *range );
+
+  private:
+    HistoryArchive( const HistoryArchive& ) = delete;
+    HistoryArchive& operator=( const HistoryArchive& ) = delete;
+
+    static const uint32_t MAGIC = 0x41324553;       // "SE2A"
+    static const uint32_t VERSION = 1;
+    static const size_t HEADER_SIZE = 16;
+
+    enum Section { OpDict, SessionDict, OpCodes, SessionCodes, Usec, Operand1, Operand2, Result, SECTIONS };
+
+    /**
+     * @brief Chunk is the header of a chunk, followed by 'words' 64-bit
+     * words of sections.
+     */
+    struct Chunk {
+        uint32_t rows;
+        uint32_t words;
+        uint64_t minUsec;
+        uint64_t maxUsec;
+        uint8_t opBits;
+        uint8_t sessionBits;
+        uint16_t reserved;
+        uint32_t section[ SECTIONS ];   // words of each section
+    };
+
+    static void encode( const Journal::Record *r, uint32_t rows, Chunk& c, vector<uint64_t>& words );
+    void decode( const Chunk& c, Batch& b ) const;
+    bool readFully( void *buf, size_t n );
+
+    const string path;
+    int fd = -1;
+    vector<uint64_t> words;
+    uint64_t bytes = 0;
+    uint64_t skipped = 0;
+    uint64_t readNsec = 0;
+    uint64_t decodeNsec = 0;
+};
+
+#endif // HISTORYARCHIVE_H
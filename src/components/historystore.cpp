@@ -0,0 +1,503 @@
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "historystore.h"
+#include "guifacade.h"
+
+
+static size_t align64( size_t n ) {
+    return ( n + 63 ) & ~size_t( 63 );
+}
+
+
+/**
+ * @brief HistoryStore constructor maps a store file and checks that the
+ * columns lie within the file.
+ * @param path of store file.
+ * @throws runtime_error if the file cannot be mapped or is no store.
+ */
+HistoryStore::HistoryStore( const string& path ) {
+    int fd = open( path.c_str(), O_RDONLY );
+    struct stat st;
+    if( fd < 0 || fstat( fd, &st ) < 0 || size_t( st.st_size ) < sizeof( Header ) ) {
+        if( fd >= 0 ) {
+            ::close( fd );
+        }
+        throw runtime_error( "cannot read history store: " + path );
+    }
+    length = size_t( st.st_size );
+    void *p = mmap( nullptr, length, PROT_READ, MAP_SHARED, fd, 0 );
+    ::close( fd );
+    if( p == MAP_FAILED ) {
+        throw runtime_error( "cannot map history store " + path + ": " + strerror( errno ) );
+    }
+    base = static_cast<const char *>( p );
+    header = reinterpret_cast<const Header *>( base );
+    uint64_t n = header->rows;
+    if( header->magic != MAGIC || header->version != VERSION
+        || header->blocks != ( n + BLOCK_ROWS - 1 ) / BLOCK_ROWS
+        || header->zones + header->blocks * sizeof( Zone ) > length
+        || header->usec + n * 8 > length || header->session + n * 4 > length || header->op + n > length
+        || header->operand1 + n * 8 > length || header->operand2 + n * 8 > length || header->result + n * 8 > length )
+    {
+        munmap( p, length );
+        throw runtime_error( "no history store or unsupported version: " + path );
+    }
+    zones = reinterpret_cast<const Zone *>( base + header->zones );
+    usec = reinterpret_cast<const uint64_t *>( base + header->usec );
+    session = reinterpret_cast<const uint32_t *>( base + header->session );
+    op = reinterpret_cast<const uint8_t *>( base + header->op );
+    operand1 = reinterpret_cast<const double *>( base + header->operand1 );
+    operand2 = reinterpret_cast<const double *>( base + header->operand2 );
+    result = reinterpret_cast<const double *>( base + header->result );
+}
+
+HistoryStore::~HistoryStore() {
+    munmap( const_cast<char *>( base ), length );
+}
+
+
+/**
+ * @brief HistoryStore::build writes a store file from a journal file. The
+ * store is written to a temporary file, which then replaces the store,
+ * such that readers never map a partially written store.
+ * @param journal path of journal file.
+ * @param path of store file.
+ * @return number of rows.
+ * @throws runtime_error if a file cannot be read or written.
+ */
+uint64_t HistoryStore::build( const string& journal, const string& path ) {
+    JournalReader in( journal );
+    Header h;
+    memset( &h, 0, sizeof( h ) );
+    h.magic = MAGIC;
+    h.version = VERSION;
+    h.rows = in.size();
+    h.blocks = uint32_t( ( h.rows + BLOCK_ROWS - 1 ) / BLOCK_ROWS );
+    h.sorted = 1;
+    size_t off = align64( sizeof( Header ) );
+    h.zones = off;      off = align64( off + h.blocks * sizeof( Zone ) );
+    h.usec = off;       off = align64( off + h.rows * 8 );
+    h.session = off;    off = align64( off + h.rows * 4 );
+    h.op = off;         off = align64( off + h.rows );
+    h.operand1 = off;   off = align64( off + h.rows * 8 );
+    h.operand2 = off;   off = align64( off + h.rows * 8 );
+    h.result = off;     off = align64( off + h.rows * 8 );
+
+    string tmp = path + ".tmp";
+    int fd = open( tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+    if( fd < 0 || ftruncate( fd, off_t( off ) ) < 0 ) {
+        int err = errno;
+        if( fd >= 0 ) {
+            ::close( fd );
+            unlink( tmp.c_str() );
+        }
+        throw runtime_error( "cannot write history store " + tmp + ": " + strerror( err ) );
+    }
+    void *p = mmap( nullptr, off, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    ::close( fd );
+    if( p == MAP_FAILED ) {
+        int err = errno;
+        unlink( tmp.c_str() );
+        throw runtime_error( "cannot map history store " + tmp + ": " + strerror( err ) );
+    }
+    char *b = static_cast<char *>( p );
+    Zone *z = reinterpret_cast<Zone *>( b + h.zones );
+    uint64_t *usec = reinterpret_cast<uint64_t *>( b + h.usec );
+    uint32_t *session = reinterpret_cast<uint32_t *>( b + h.session );
+    uint8_t *op = reinterpret_cast<uint8_t *>( b + h.op );
+    double *values[ 3 ] = {
+        reinterpret_cast<double *>( b + h.operand1 ),
+        reinterpret_cast<double *>( b + h.operand2 ),
+        reinterpret_cast<double *>( b + h.result )
+    };
+
+    for( uint64_t i=0; i < h.rows; i++ ) {
+        const Journal::Record& r = in[ size_t( i ) ];
+        Zone& zone = z[ i / BLOCK_ROWS ];
+        if( i % BLOCK_ROWS == 0 ) {
+            zone.minUsec = UINT64_MAX;
+            zone.maxUsec = 0;
+            for( int k=0; k < 3; k++ ) {
+                zone.min[k] = HUGE_VAL;
+                zone.max[k] = -HUGE_VAL;
+            }
+            zone.ops = 0;
+        }
+        if( i > 0 && r.usec < usec[ i - 1 ] ) {
+            h.sorted = 0;
+        }
+        usec[i] = r.usec;
+        session[i] = r.session;
+        op[i] = uint8_t( r.op & Journal::OP_MASK );
+        double v[ 3 ] = { r.operand1, r.operand2, r.result };
+        for( int k=0; k < 3; k++ ) {
+            values[k][i] = v[k];
+            zone.min[k] = v[k] < zone.min[k]? v[k] : zone.min[k];     // NaN is not counted
+            zone.max[k] = v[k] > zone.max[k]? v[k] : zone.max[k];
+        }
+        zone.minUsec = min( zone.minUsec, r.usec );
+        zone.maxUsec = max( zone.maxUsec, r.usec );
+        zone.ops |= op[i] < 64? uint64_t( 1 ) << op[i] : ~uint64_t( 0 );      // all KeyEvts fit
+    }
+    memcpy( b, &h, sizeof( h ) );
+    bool ok = msync( p, off, MS_SYNC ) == 0;
+    munmap( p, off );
+    if( ! ok || rename( tmp.c_str(), path.c_str() ) != 0 ) {
+        int err = errno;
+        unlink( tmp.c_str() );                                  // don't leave a partial store behind
+        throw runtime_error( "cannot write history store " + path + ": " + strerror( err ) );
+    }
+    return h.rows;
+}
+
+
+/**
+ * @brief Predicate kernels AND the rows of 'n' values matching a predicate
+ * into 'mask', one bit per row. Words of the mask without candidates are
+ * skipped.
+ */
+static void rangeMask( const double *x, size_t n, double lo, double hi, uint64_t *mask ) {
+    for( size_t w=0; w * 64 < n; w++ ) {
+        if( mask[w] == 0 ) {
+            continue;
+        }
+        size_t i = w * 64, end = min( n, i + 64 );
+        uint64_t m = 0;
+#ifdef __SSE2__
+        __m128d vlo = _mm_set1_pd( lo ), vhi = _mm_set1_pd( hi );
+        for( ; i + 2 <= end; i += 2 ) {
+            __m128d v = _mm_loadu_pd( x + i );
+            uint64_t bits = uint64_t( _mm_movemask_pd( _mm_and_pd( _mm_cmpge_pd( v, vlo ), _mm_cmple_pd( v, vhi ) ) ) );
+            m |= bits << ( i - w * 64 );
+        }
+#endif
+        for( ; i < end; i++ ) {
+            m |= uint64_t( x[i] >= lo && x[i] <= hi ) << ( i - w * 64 );
+        }
+        mask[w] &= m;
+    }
+}
+
+static void eqMask8( const uint8_t *x, size_t n, uint8_t v, uint64_t *mask ) {
+    for( size_t w=0; w * 64 < n; w++ ) {
+        if( mask[w] == 0 ) {
+            continue;
+        }
+        size_t i = w * 64, end = min( n, i + 64 );
+        uint64_t m = 0;
+#ifdef __SSE2__
+        __m128i vv = _mm_set1_epi8( char( v ) );
+        for( ; i + 16 <= end; i += 16 ) {
+            __m128i c = _mm_cmpeq_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i *>( x + i ) ), vv );
+            m |= uint64_t( uint16_t( _mm_movemask_epi8( c ) ) ) << ( i - w * 64 );
+        }
+#endif
+        for( ; i < end; i++ ) {
+            m |= uint64_t( x[i] == v ) << ( i - w * 64 );
+        }
+        mask[w] &= m;
+    }
+}
+
+static void eqMask32( const uint32_t *x, size_t n, uint32_t v, uint64_t *mask ) {
+    for( size_t w=0; w * 64 < n; w++ ) {
+        if( mask[w] == 0 ) {
+            continue;
+        }
+        size_t i = w * 64, end = min( n, i + 64 );
+        uint64_t m = 0;
+#ifdef __SSE2__
+        __m128i vv = _mm_set1_epi32( int( v ) );
+        for( ; i + 4 <= end; i += 4 ) {
+            __m128i c = _mm_cmpeq_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i *>( x + i ) ), vv );
+            m |= uint64_t( _mm_movemask_ps( _mm_castsi128_ps( c ) ) ) << ( i - w * 64 );
+        }
+#endif
+        for( ; i < end; i++ ) {
+            m |= uint64_t( x[i] == v ) << ( i - w * 64 );
+        }
+        mask[w] &= m;
+    }
+}
+
+static void timeMask( const uint64_t *x, size_t n, uint64_t from, uint64_t to, uint64_t *mask ) {
+    for( size_t w=0; w * 64 < n; w++ ) {
+        if( mask[w] == 0 ) {
+            continue;
+        }
+        size_t i = w * 64, end = min( n, i + 64 );
+        uint64_t m = 0;
+        for( ; i < end; i++ ) {
+            m |= uint64_t( x[i] >= from && x[i] < to ) << ( i - w * 64 );
+        }
+        mask[w] &= m;
+    }
+}
+
+
+/**
+ * @brief HistoryStore::select evaluates a query. With index, the time
+ * index limits the blocks to the queried time range and zone maps skip
+ * blocks that cannot contain matches.
+ * @param q query.
+ * @param rows optional vector to which indices of matching rows are appended.
+ * @param useIndex skip blocks by zone maps and time index.
+ * @return statistics of query.
+ */
+HistoryStore::Stats HistoryStore::select( const Query& q, vector<uint64_t> *rows, bool useIndex ) const {
+    Stats s = { 0, 0, header->blocks };
+    const Zone *first = zones, *last = zones + header->blocks;
+    if( useIndex && header->sorted ) {
+        first = lower_bound( first, last, q.from, []( const Zone& z, uint64_t t ) { return z.maxUsec < t; } );
+        last = lower_bound( first, last, q.to, []( const Zone& z, uint64_t t ) { return z.minUsec < t; } );
+    }
+    for( const Zone *z = first; z < last; z++ ) {
+        if( useIndex && ! mayMatch( *z, q ) ) {
+            continue;
+        }
+        s.scanned++;
+        s.matches += scan( uint32_t( z - zones ), q, rows );
+    }
+    return s;
+}
+
+/**
+ * @brief HistoryStore::mayMatch checks whether a block may contain rows
+ * matching a query by its zone map.
+ * @param z zone map of block.
+ * @param q query.
+ * @return false if the block cannot contain matches.
+ */
+bool HistoryStore::mayMatch( const Zone& z, const Query& q ) const {
+    const Range *r[ 3 ] = { &q.operand1, &q.operand2, &q.result };
+    if( z.maxUsec < q.from || z.minUsec >= q.to || ( q.op >= 0 && q.op < 64 && ! ( z.ops >> q.op & 1 ) ) ) {
+        return false;
+    }
+    for( int k=0; k < 3; k++ ) {
+        if( ! r[k]->any() && ( z.max[k] < r[k]->lo || z.min[k] > r[k]->hi ) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief HistoryStore::scan evaluates the predicates of a query column by
+ * column on the rows of a block. The time predicate is skipped if the
+ * whole block lies in the queried time range.
+ * @param block index of block.
+ * @param q query.
+ * @param rows optional vector to which indices of matching rows are appended.
+ * @return number of matching rows.
+ */
+uint64_t HistoryStore::scan( uint32_t block, const Query& q, vector<uint64_t> *rows ) const {
+    uint64_t begin = uint64_t( block ) * BLOCK_ROWS;
+    size_t n = size_t( min( uint64_t( BLOCK_ROWS ), header->rows - begin ) );
+    size_t words = ( n + 63 ) / 64;
+    uint64_t mask[ BLOCK_ROWS / 64 ];
+    for( size_t w=0; w < words; w++ ) {
+        mask[w] = n - w * 64 >= 64? ~uint64_t( 0 ) : ( uint64_t( 1 ) << ( n - w * 64 ) ) - 1;
+    }
+    const Zone& z = zones[ block ];
+    if( ( q.from > 0 || q.to < UINT64_MAX ) && ( z.minUsec < q.from || z.maxUsec >= q.to ) ) {
+        timeMask( usec + begin, n, q.from, q.to, mask );
+    }
+    if( q.op >= 0 ) {
+        eqMask8( op + begin, n, uint8_t( q.op ), mask );
+    }
+    if( q.session >= 0 ) {
+        eqMask32( session + begin, n, uint32_t( q.session ), mask );
+    }
+    const Range *r[ 3 ] = { &q.operand1, &q.operand2, &q.result };
+    const double *col[ 3 ] = { operand1, operand2, result };
+    for( int k=0; k < 3; k++ ) {
+        if( ! r[k]->any() ) {
+            rangeMask( col[k] + begin, n, r[k]->lo, r[k]->hi, mask );
+        }
+    }
+
+    uint64_t matches = 0;
+    for( size_t w=0; w < words; w++ ) {
+        matches += uint64_t( __builtin_popcountll( mask[w] ) );
+        for( uint64_t m = mask[w]; rows != nullptr && m != 0; m &= m - 1 ) {
+            rows->push_back( begin + w * 64 + uint64_t( __builtin_ctzll( m ) ) );
+        }
+    }
+    return matches;
+}
+
+
+/**
+ * @brief HistoryStore::row returns the record of row 'i'.
+ * @param i index of row.
+ * @return record.
+ */
+Journal::Record HistoryStore::row( uint64_t i ) const {
+    Journal::Record r = { usec[i], session[i], int32_t( op[i] ), operand1[i], operand2[i], result[i] };
+    return r;
+}
+
+
+/**
+ * @brief parseTime parses YYYY-MM-DD[THH:MM:SS], today or yesterday in
+ * local time.
+ * @param s time string.
+ * @return time in usec since epoch.
+ * @throws invalid_argument if the time cannot be parsed.
+ */
+static uint64_t parseTime( const string& s ) {
+    struct tm tm;
+    memset( &tm, 0, sizeof( tm ) );
+    if( s == "today" || s == "yesterday" ) {
+        time_t now = time( nullptr );
+        localtime_r( &now, &tm );
+        tm.tm_hour = tm.tm_min = tm.tm_sec = 0;
+        tm.tm_mday -= s == "yesterday"? 1 : 0;
+    } else {
+        int n = sscanf( s.c_str(), "%d-%d-%dT%d:%d:%d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+                        &tm.tm_hour, &tm.tm_min, &tm.tm_sec );
+        if( n != 3 && n != 6 ) {
+            throw invalid_argument( "invalid time: " + s );
+        }
+        tm.tm_year -= 1900;
+        tm.tm_mon -= 1;
+    }
+    tm.tm_isdst = -1;
+    return uint64_t( mktime( &tm ) ) * 1000000;
+}
+
+/**
+ * @brief HistoryStore::Query::parse parses a query expression.
+ * @param expr predicates separated by blanks, e.g. "day=yesterday result>1000".
+ * @return query.
+ * @throws invalid_argument if a predicate cannot be parsed.
+ */
+HistoryStore::Query HistoryStore::Query::parse( const string& expr ) {
+    Query q;
+    istringstream in( expr );
+    string token;
+    while( in >> token ) {
+        size_t i = token.find_first_of( "<>=" );
+        if( i == string::npos || i == 0 ) {
+            throw invalid_argument( "invalid predicate: " + token );
+        }
+        string field = token.substr( 0, i );
+        string cmp = token.substr( i, token[i] != '=' && i + 1 < token.length() && token[ i + 1 ] == '=' ? 2 : 1 );
+        string value = token.substr( i + cmp.length() );
+        if( value.empty() ) {
+            throw invalid_argument( "missing value: " + token );
+        }
+
+        if( field == "time" ) {
+            uint64_t t = parseTime( value );
+            q.from = cmp == ">"? max( q.from, t + 1 ) : cmp == ">=" || cmp == "="? max( q.from, t ) : q.from;
+            q.to = cmp == "<"? min( q.to, t ) : cmp == "<="? min( q.to, t + 1 ) : cmp == "="? min( q.to, t + 1 ) : q.to;
+
+        } else if( field == "day" && cmp == "=" ) {
+            uint64_t t = parseTime( value );
+            time_t next = time_t( t / 1000000 ) + 36 * 3600;          // midnight of next day, DST safe
+            struct tm tm;
+            localtime_r( &next, &tm );
+            tm.tm_hour = tm.tm_min = tm.tm_sec = 0;
+            tm.tm_isdst = -1;
+            q.from = max( q.from, t );
+            q.to = min( q.to, uint64_t( mktime( &tm ) ) * 1000000 );
+
+        } else if( field == "op" && cmp == "=" ) {
+            for( int k=GuiFacade::Plus; k <= GuiFacade::Pow && q.op < 0; k++ ) {
+                const char *name = Journal::opName( k );
+                q.op = name && value == name? k : -1;
+            }
+            if( q.op < 0 ) {
+                throw invalid_argument( "invalid operator: " + token );
+            }
+
+        } else if( field == "session" && cmp == "=" ) {
+            char *end;
+            q.session = strtoll( value.c_str(), &end, 10 );
+            if( *end != '\0' || q.session < 0 ) {
+                throw invalid_argument( "invalid session: " + token );
+            }
+
+        } else if( field == "operand1" || field == "operand2" || field == "result" ) {
+            char *end;
+            double v = strtod( value.c_str(), &end );
+            if( *end != '\0' ) {
+                throw invalid_argument( "invalid number: " + token );
+            }
+            Range& r = field == "operand1"? q.operand1 : field == "operand2"? q.operand2 : q.result;
+            if( cmp == ">" || cmp == ">=" || cmp == "=" ) {
+                r.lo = max( r.lo, cmp == ">"? nextafter( v, HUGE_VAL ) : v );
+            }
+            if( cmp == "<" || cmp == "<=" || cmp == "=" ) {
+                r.hi = min( r.hi, cmp == "<"? nextafter( v, -HUGE_VAL ) : v );
+            }
+
+        } else {
+            throw invalid_argument( "invalid predicate: " + token );
+        }
+    }
+    return q;
+}
+
+
+/**
+ * @brief HistoryStore::run builds a store from a journal and/or runs a
+ * query on it. The first matches are printed as tape, followed by the
+ * number of matches, scanned blocks and the time taken.
+ * @param path of store file.
+ * @param journal path of journal to build the store from or nullptr.
+ * @param query expression or nullptr.
+ * @param useIndex false to run the query as full scan.
+ * @return exit code.
+ */
+int HistoryStore::run( const string& path, const char *journal, const char *query, bool useIndex ) {
+    static const size_t PRINT = 20;
+    char line[ 160 ];
+    try {
+        if( journal != nullptr ) {
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            uint64_t n = build( journal, path );
+            double msec = chrono::duration<double, milli>( chrono::steady_clock::now() - t0 ).count();
+            sprintf( line, "History: %llu rows built from %s in %.1f ms.", (unsigned long long) n, journal, msec );
+            cout << line << endl;
+        }
+        if( query != nullptr ) {
+            HistoryStore store( path );
+            Query q = Query::parse( query );
+            vector<uint64_t> rows;
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            Stats s = store.select( q, &rows, useIndex );
+            double msec = chrono::duration<double, milli>( chrono::steady_clock::now() - t0 ).count();
+            for( size_t i=0; i < rows.size() && i < PRINT; i++ ) {
+                cout << Journal::format( store.row( rows[i] ) ) << "\n";
+            }
+            if( rows.size() > PRINT ) {
+                cout << "... " << rows.size() - PRINT << " more.\n";
+            }
+            sprintf( line, "Query: %llu of %llu rows match, %u of %u blocks scanned (%s) in %.2f ms.",
+                     (unsigned long long) s.matches, (unsigned long long) store.size(), s.scanned, s.blocks,
+                     useIndex? "indexed" : "full scan", msec );
+            cout << line << endl;
+        }
+
+    } catch( exception& e ) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,169 @@
+#ifndef HISTORYSTORE_H
+#define HISTORYSTORE_H
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include "journal.h"
+using namespace std;
+
+
+/**
+ * @brief The HistoryStore class answers queries over the calculation
+ * journal, such as "all results over 1000 yesterday", without reading
+ * every record (Linux only).
+ *
+ * The store is a read-only columnar copy of a journal, built by build()
+ * and mapped from its file. Each field is stored as contiguous column.
+ * Rows are grouped into blocks of BLOCK_ROWS, for which a zone map holds
+ * the minimum and maximum of time, operands and result and the set of
+ * operators. Operators are stored without the precision bits of the
+ * journal. A query first skips all blocks whose zones cannot match.
+ * If the journal is in time order, the blocks of the queried time range
+ * are found by binary search on the zones (time index). Predicates are
+ * then evaluated column by column on the remaining blocks into a bitmap
+ * of matching rows, using SSE2 where available.
+ */
+class HistoryStore {
+
+  public:
+    static const uint32_t BLOCK_ROWS = 4096;
+
+    /**
+     * @brief Range is a closed range of values of a column, which is
+     * unbounded by default.
+     */
+    struct Range {
+        double lo = -HUGE_VAL;
+        double hi = HUGE_VAL;
+        bool any() const { return lo == -HUGE_VAL && hi == HUGE_VAL; }
+    };
+
+    /**
+     * @brief Query is a conjunction of predicates on the fields of a
+     * record, e.g. parsed from "day=yesterday result>1000" or from
+     * "op=/ operand2<0.01". Fields are time, day, session, op, operand1,
+     * operand2 and result, operators are =, <, <=, > and >=. Times are
+     * given as YYYY-MM-DD[THH:MM:SS] in local time, days also as today or
+     * yesterday.
+     */
+    struct Query {
+        uint64_t from = 0;              // time range [from, to) in usec
+        uint64_t to = UINT64_MAX;
+        int op = -1;                    // operator as GuiFacade::KeyEvt, -1 for any
+        int64_t session = -1;           // session, -1 for any
+        Range operand1;
+        Range operand2;
+        Range result;
+
+        /**
+         * @brief parse a query expression.
+         * @param expr predicates separated by blanks.
+         * @return query.
+         * @throws invalid_argument if a predicate cannot be parsed.
+         */
+        static Query parse( const string& expr );
+    };
+
+    struct Stats {
+        uint64_t matches;               // matching rows
+        uint32_t scanned;               // blocks whose columns were scanned
+        uint32_t blocks;                // blocks of the store
+    };
+
+    /**
+     * @brief HistoryStore constructor maps a store file.
+     * @param path of store file.
+     * @throws runtime_error if the file cannot be mapped or is no store.
+     */
+    HistoryStore( const string& path );
+    ~HistoryStore();
+
+    /**
+     * @brief build writes a store file from a journal file.
+     * @param journal path of journal file.
+     * @param path of store file.
+     * @return number of rows.
+     * @throws runtime_error if a file cannot be read or written.
+     */
+    static uint64_t build( const string& journal, const string& path );
+
+    /**
+     * @brief select evaluates a query.
+     * @param q query.
+     * @param rows optional vector to which the indices of matching rows
+     * are appended.
+     * @param useIndex skip blocks by zone maps and time index, otherwise
+     * scan all blocks (full scan).
+     * @return statistics of query.
+     */
+    Stats select( const Query& q, vector<uint64_t> *rows = nullptr, bool useIndex = true ) const;
+
+    /**
+     * @brief row returns the record of row 'i'.
+     * @param i index of row.
+     * @return record.
+     */
+    Journal::Record row( uint64_t i ) const;
+
+    uint64_t size() const { return header->rows; }
+
+    /**
+     * @brief run builds a store from a journal and/or runs a query on it
+     * and prints matches and statistics. Invoked from main() for options
+     * --history, --history-build and --query.
+     * @param path of store file.
+     * @param journal path of journal to build the store from or nullptr.
+     * @param query expression or nullptr.
+     * @param useIndex false to run the query as full scan.
+     * @return exit code.
+     */
+    static int run( const string& path, const char *journal, const char *query, bool useIndex );
+
+  private:
+    HistoryStore( const HistoryStore& ) = delete;
+    HistoryStore& operator=( const HistoryStore& ) = delete;
+
+    static const uint32_t MAGIC = 0x48324553;       // "SE2H"
+    static const uint32_t VERSION = 2;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t rows;
+        uint32_t blocks;
+        uint32_t sorted;                // rows are in time order
+        uint64_t zones;                 // file offsets of zone maps and columns
+        uint64_t usec;
+        uint64_t session;
+        uint64_t op;
+        uint64_t operand1;
+        uint64_t operand2;
+        uint64_t result;
+    };
+
+    struct Zone {
+        uint64_t minUsec;
+        uint64_t maxUsec;
+        double min[ 3 ];                // operand1, operand2, result
+        double max[ 3 ];
+        uint64_t ops;                   // bit set of operators, all set for operators >= 64
+    };
+
+    bool mayMatch( const Zone& z, const Query& q ) const;
+    uint64_t scan( uint32_t block, const Query& q, vector<uint64_t> *rows ) const;
+
+    const char *base = nullptr;
+    size_t length = 0;
+    const Header *header = nullptr;
+    const Zone *zones = nullptr;
+    const uint64_t *usec = nullptr;
+    const uint32_t *session = nullptr;
+    const uint8_t *op = nullptr;
+    const double *operand1 = nullptr;
+    const double *operand2 = nullptr;
+    const double *result = nullptr;
+};
+
+#endif // HISTORYSTORE_H
@@ -16,12 +16,16 @@ string to_string2( double d );
  * @param name name of the InputProcessor instance.
  * @param builder reference to builder instance.
  * @param alu reference to Calculator logic (algorithmic logical unit).
+ * @param countdowns reference to countdown engine used in TimerMode.
+ * @param display reference to display controller input is mirrored to.
  * @param pub reference to optional publisher of controller events.
  * @return reference to singleton InputProcessor instance.
  */
-InputProcessor& InputProcessor::getInstance( const string name, Builder& builder, Calculator& alu, PublisherIntf *pub ) {
+InputProcessor& InputProcessor::getInstance( const string name, Builder& builder, Calculator& alu,
+                                             CountdownEngine& countdowns, DisplayController& display,
+                                             PublisherIntf *pub ) {
     if( _this == nullptr ) {
-        _this = new InputProcessor( name, builder, alu, pub );
+        _this = new InputProcessor( name, builder, alu, countdowns, display, pub );
     }
     return *_this;
 }
@@ -34,208 +38,476 @@ InputProcessor::~InputProcessor() {
 
 
 /**
- * @brief InputProcessor::probe perform functional controller test.
+ * @brief InputProcessor::probe perform functional controller test, which
+ * completes immediately.
  * @param cb optional callback object at which the callback(XEvent *e)-
  * method is invoked when the probe-cycle has completed.
  */
-void InputProcessor::probe( Callback * /* cb */ ) {}
+void InputProcessor::probe( Callback *cb ) {
+    if( cb != nullptr ) {
+        XEventFactory& ef = builder.getEventFactory();
+        cb->callback( &ef.getEvent( XEvent::Type::callbackEvents, MainController::OpSt::RUNNING ) );
+    }
+}
 
 /**
  * @brief InputProcessor::start InputProcessor.
  */
 void InputProcessor::start() {
-    XEventFactory& ef = builder.getEventFactory();
-    publish( ef.getEvent( getName() + " started." ) );
+    publishMsg( builder.getEventFactory(), getName() + " started." );
 }
 
 /**
  * @brief InputProcessor::stop InputProcessor.
  */
 void InputProcessor::stop( bool /* exit */ ) {
-    XEventFactory& ef = builder.getEventFactory();
-    publish( ef.getEvent( getName() + " stopped." ) );
+    publishMsg( builder.getEventFactory(), getName() + " stopped." );
+}
+
+
+/**
+ * @brief InputProcessor::reset returns the input processor to its initial
+ * logical state for a warm restart. The display is not updated.
+ */
+void InputProcessor::reset() {
+    mode = CalculatorMode;
+    inpmode_ = numbers;
+    err = false;
+    bufNumber = "0";
+    bufTime = "12:00:00";
+    bufStat = "0";
+    statmode_ = numbers;
+    timer.reset();
+    alu.clearAll();
+    stats.clear();
+    undoSteps.clear();
+    redoSteps.clear();
+}
+
+/**
+ * @brief InputProcessor::refresh mirrors the buffer of the current mode to
+ * the display or shows the error condition.
+ */
+void InputProcessor::refresh() {
+    if( err ) {
+        display.setError();
+    } else {
+        display.updateDisplay( buffer() );
+    }
+}
+
+
+/**
+ * @brief Transition table of the input state machine indexed by
+ * [ mode ][ inpmode_ ][ err ][ key ]. Entries are action codes combined
+ * with flags NEXT_MODE (switch to next mode before action) and CLEAR_ERR
+ * (clear error condition before action). The table is computed at
+ * compile time from the functions below.
+ */
+constexpr uint8_t InputProcessor::calcAction( int sub, int key ) {
+    return key <= GuiFacade::K9? ( sub == op? CalcDigitAfterOp : CalcDigit ) :
+           key == GuiFacade::Comma? ( sub == op? CalcCommaAfterOp : CalcComma ) :
+           key == GuiFacade::K000? CalcK000 :
+           key <= GuiFacade::EQ || key == GuiFacade::Pow? ( sub == op? CalcSetOperator : CalcOperator ) :
+           key >= GuiFacade::Sqrt && key <= GuiFacade::Cos? CalcFunction :
+           key == GuiFacade::BS? CalcBackspace :
+           key == GuiFacade::C? CalcClearAll :
+           key == GuiFacade::CE? CalcClearEntry :
+           key == GuiFacade::Undo? CalcUndo :
+           key == GuiFacade::Redo? CalcRedo :
+           key == GuiFacade::Category? CalcCategory : Show;
+}
+
+constexpr uint8_t InputProcessor::timerAction( int key ) {
+    return key <= GuiFacade::K9? TimerDigit :
+           key == GuiFacade::Start? TimerStart :
+           key == GuiFacade::Stop? TimerStop :
+           key == GuiFacade::BS || key == GuiFacade::C? TimerClear :
+           key == GuiFacade::CE? TimerPreset : Show;
+}
+
+constexpr uint8_t InputProcessor::statAction( int sub, int key ) {
+    return key <= GuiFacade::K9? ( sub == op? CalcDigitAfterOp : CalcDigit ) :
+           key == GuiFacade::Comma? ( sub == op? CalcCommaAfterOp : CalcComma ) :
+           key == GuiFacade::K000? CalcK000 :
+           key == GuiFacade::Plus || key == GuiFacade::EQ? ( sub == op? Show : StatEnter ) :
+           key == GuiFacade::Percent? ( sub == op? Show : StatShow ) :
+           key == GuiFacade::Mul || key == GuiFacade::Div ||
+           key == GuiFacade::Sqrt || key == GuiFacade::Square ||
+           key == GuiFacade::ParOpen || key == GuiFacade::ParClose? StatShow :
+           key == GuiFacade::BS? CalcBackspace :
+           key == GuiFacade::C? StatClear :
+           key == GuiFacade::CE? StatClearEntry : Show;
+}
+
+constexpr uint8_t InputProcessor::transition( int mode, int sub, int err, int key ) {
+    return key == GuiFacade::Mode? uint8_t( NEXT_MODE | ( err? None : Show ) ) :
+           err && ( key == GuiFacade::C || key == GuiFacade::CE ||
+                    ( mode == CalculatorMode && key == GuiFacade::Undo ) )?
+                uint8_t( CLEAR_ERR | transition( mode, sub, 0, key ) ) :
+           err? uint8_t( None ) :
+           mode == CalculatorMode? calcAction( sub, key ) :
+           mode == TimerMode? timerAction( key ) : statAction( sub, key );
 }
 
+#define T_KEYS( m, s, e ) \
+    transition( m, s, e, 0 ), transition( m, s, e, 1 ), transition( m, s, e, 2 ), transition( m, s, e, 3 ), \
+    transition( m, s, e, 4 ), transition( m, s, e, 5 ), transition( m, s, e, 6 ), transition( m, s, e, 7 ), \
+    transition( m, s, e, 8 ), transition( m, s, e, 9 ), transition( m, s, e, 10 ), transition( m, s, e, 11 ), \
+    transition( m, s, e, 12 ), transition( m, s, e, 13 ), transition( m, s, e, 14 ), transition( m, s, e, 15 ), \
+    transition( m, s, e, 16 ), transition( m, s, e, 17 ), transition( m, s, e, 18 ), transition( m, s, e, 19 ), \
+    transition( m, s, e, 20 ), transition( m, s, e, 21 ), transition( m, s, e, 22 ), transition( m, s, e, 23 ), \
+    transition( m, s, e, 24 ), transition( m, s, e, 25 ), transition( m, s, e, 26 ), transition( m, s, e, 27 ), \
+    transition( m, s, e, 28 ), transition( m, s, e, 29 ), transition( m, s, e, 30 ), transition( m, s, e, 31 ), \
+    transition( m, s, e, 32 ), transition( m, s, e, 33 ), transition( m, s, e, 34 ), transition( m, s, e, 35 ), \
+    transition( m, s, e, 36 ), transition( m, s, e, 37 )
+#define T_ERR( m, s )   { { T_KEYS( m, s, 0 ) }, { T_KEYS( m, s, 1 ) } }
+#define T_SUB( m )      { T_ERR( m, numbers ), T_ERR( m, op ) }
+
+const uint8_t InputProcessor::transitions[ MODES ][ 2 ][ 2 ][ KEYS ] = {
+    T_SUB( CalculatorMode ), T_SUB( TimerMode ), T_SUB( StatisticsMode )
+};
+
 
 /**
  * @brief notify method inherited from SubscriberIntf is invoked when
  * an input event such as keypad- or keypress-event has occured.
- * notify() dispatches events to sub-methods notify_CalcMode and
- * notify_TimerMode depending on InputProcessor mode.
+ * notify() dispatches events to step(), which performs the action of
+ * the transition table. Errors switch to the error condition. Events,
+ * errors and the time spent are counted.
  * @param e input event.
  */
 void InputProcessor::notify( XEvent& e ) {
+    uint64_t t0 = ControllerStats::nsec();
     try {
-        switch( e.ev ) {
-
-        case GuiFacade::Mode:   // toggle mode
-            switch( mode ) {
-            case InputProcessor::CalculatorMode: mode = InputProcessor::TimerMode; break;
-            case InputProcessor::TimerMode: mode = InputProcessor::CalculatorMode; break;
-            } break;
-
-        case GuiFacade::C:
-        case GuiFacade::CE:
-            err = false;
-        }
-        if( ! err ) {
-            switch( mode ) {
-            case InputProcessor::CalculatorMode: notify_CalcMode( e ); break;
-            case InputProcessor::TimerMode: notify_TimerMode( e ); break;
-            }
-        }
+        step( e.ev );
 
     } catch( exception& e ) {
         err = true;
+        counters.add( ControllerStats::Errors );
         cerr << e.what() << endl;
-        builder.getDisplayController().setError();
+        display.setError();
     }
+    counters.add( ControllerStats::Events );
+    counters.add( ControllerStats::NotifyNsec, ControllerStats::nsec() - t0 );
 }
 
 
 /**
- * @brief notify_CalcMode sub-method invoked by notify() in CalculatorMode.
- * @param e input event.
+ * @brief step looks up the action for 'key' in the transition table,
+ * performs it and mirrors the buffer of the current mode to the display.
+ * @param key input event as GuiFacade::KeyEvt.
  */
-void InputProcessor::notify_CalcMode( XEvent& e ) {
-    bool hasDot = bufNumber.find( "." ) != string::npos;
-    switch( e.ev ) {
-
-    case GuiFacade::EQ:
-    case GuiFacade::Minus:
-    case GuiFacade::Plus:
-    case GuiFacade::Mul:
-    case GuiFacade::Div:
-    case GuiFacade::Percent:
-    case GuiFacade::VAT: {
-            if( inpmode_ == INPUT_MODE::numbers ) {
-                double d1 = stod( bufNumber );
-                alu.push( d1 );
-                alu.pushOp( e.ev );
-            }
-            alu.setOp( e.ev );
-
-            double d = alu.top();
-            if( d <= 9999999999.999999 && d >= -999999999.999999 ) {
-                string d2str = to_string2( d );
-                bufNumber = d2str;
+void InputProcessor::step( int key ) {
+    static_assert( KEYS == GuiFacade::Category + 1, "KEYS must match GuiFacade::KeyEvt" );
+    if( key < 0 || key >= KEYS ) {
+        return;
+    }
+    uint8_t a = transitions[ mode ][ subMode() ][ err ][ key ];
+    if( a & NEXT_MODE ) {
+        mode = MODE( ( mode + 1 ) % MODES );
+    }
+    if( a & CLEAR_ERR ) {
+        err = false;
+    }
+    switch( a & ACTION_MASK ) {
+    case None:              return;
+    case Show:              break;
+    case CalcOperator:      record(); calcOperator( key, true ); break;
+    case CalcSetOperator:   record(); calcOperator( key, false ); break;
+    case CalcFunction:      record(); calcFunction( key ); break;
+    case CalcCategory:      record(); calcCategory(); break;
+    case CalcDigit:         calcDigit( key, false ); break;
+    case CalcDigitAfterOp:  calcDigit( key, true ); break;
+    case CalcComma:         calcDigit( key, false ); break;
+    case CalcCommaAfterOp:  calcDigit( key, true ); break;
+    case CalcBackspace:
+        if( buffer().length() > 1 ) {
+            buffer().pop_back();
+        } else {
+            clearBuffer( &buffer(), "0" );
+        }
+        break;
+    case CalcClearAll:
+        record();
+        alu.clearAll();
+        alu.clearTop();
+        bufNumber = "0";
+        break;
+    case CalcClearEntry:
+        record();
+        alu.clearTop();
+        bufNumber = "0";
+        break;
+    case CalcUndo:
+        undo( ( a & CLEAR_ERR ) != 0 );
+        break;
+    case CalcRedo:
+        redo();
+        break;
+    case StatEnter:
+        stats.add( stod( bufStat ) );
+        bufStat = to_string( stats.count() );
+        statmode_ = INPUT_MODE::op;
+        break;
+    case StatShow:
+        statShow( key );
+        break;
+    case StatClear:
+        stats.clear();
+        bufStat = "0";
+        statmode_ = INPUT_MODE::numbers;
+        break;
+    case StatClearEntry:
+        bufStat = "0";
+        break;
+    case CalcK000:
+        step( GuiFacade::K0 );
+        step( GuiFacade::K0 );
+        step( GuiFacade::K0 );
+        break;
+    case TimerStart:
+        if( ! timer.isRunning() ) {
+            if( timer.remaining() > 0 && bufTime == Countdown::format( timer.seconds() ) ) {
+                timer.resume();
             } else {
-                cout << "OVERFLOW." << endl;
-                throw overflow_error( "OVERFLOW." );
+                timer.start( uint64_t( Countdown::parse( bufTime ) ) * 1000 );
             }
-            inpmode_ = INPUT_MODE::op;
-        } break;
+        }
+        break;
+    case TimerStop:
+        timer.stop();
+        break;
+    case TimerDigit:
+        timerDigit( key );
+        break;
+    case TimerClear:
+        timer.reset();
+        clearBuffer( &bufTime, "12:00:00" );
+        break;
+    case TimerPreset:
+        timer.reset();
+        clearBuffer( &bufTime, "23:59:59" );
+        break;
+    }
+    display.updateDisplay( buffer() );
+}
+
+
+/**
+ * @brief calcOperator performs operator keys in CalculatorMode. After
+ * number input, the number is pushed as operand before the operator.
+ * After operator input, the previous operator is replaced.
+ * Results beyond the display overflow in Double precision, in Big and
+ * Fraction precision they are shown in scientific view.
+ * @param key operator key.
+ * @param afterNumber true if number was input before.
+ */
+void InputProcessor::calcOperator( int key, bool afterNumber ) {
+    counters.add( ControllerStats::CalcOps );
+    if( afterNumber ) {
+        alu.push( bufNumber );
+        alu.pushOp( key );
+    } else {
+        alu.setOp( key );
+    }
 
-    case GuiFacade::ParOpen:
-    case GuiFacade::ParClose:
+    if( alu.getPrecision() != Calculator::Double ) {
+        bufNumber = alu.topText( DisplayController::len );
+    } else {
+        showNumber( alu.top() );
+    }
+    inpmode_ = INPUT_MODE::op;
+}
+
+/**
+ * @brief calcFunction applies a function key such as sqrt to the number
+ * shown, which is replaced by the result like an input number, e.g. as
+ * operand of the next operator. Results are computed in double precision
+ * in all precisions.
+ * @param key function key.
+ */
+void InputProcessor::calcFunction( int key ) {
+    counters.add( ControllerStats::CalcOps );
+    double d = alu.function( key, stod( bufNumber ) );
+    if( alu.getPrecision() != Calculator::Double ) {
+        bufNumber = BigDecimal::fromDouble( d ).format( DisplayController::len );
+    } else {
+        showNumber( d );
+    }
+    inpmode_ = INPUT_MODE::numbers;
+}
+
+/**
+ * @brief calcCategory selects the VAT rate of the product category whose
+ * index is shown and shows the rate. The rate applies to subsequent VAT
+ * keys. Like operators, selecting a category records an undo step, which
+ * restores the index shown; the selected rate is kept.
+ * @throws out_of_range if there is no such category.
+ */
+void InputProcessor::calcCategory() {
+    const Calculator::VatRate& r = alu.selectVat( size_t( stoul( bufNumber ) ) );
+    bufNumber = to_string2( r.percent );
+    inpmode_ = INPUT_MODE::op;
+}
+
+/**
+ * @brief statShow shows the statistic of a key in StatisticsMode, for
+ * Percent the quantile of the percentage shown.
+ * @param key statistic key.
+ * @throws out_of_range if the percentage is beyond 100, overflow_error if
+ * the statistic exceeds the display.
+ */
+void InputProcessor::statShow( int key ) {
+    double d = 0.0;
+    switch( key ) {
+    case GuiFacade::Mul:        d = stats.sum(); break;
+    case GuiFacade::Div:        d = stats.mean(); break;
+    case GuiFacade::Sqrt:       d = stats.stddev(); break;
+    case GuiFacade::Square:     d = stats.variance(); break;
+    case GuiFacade::ParOpen:    d = stats.min(); break;
+    case GuiFacade::ParClose:   d = stats.max(); break;
+    case GuiFacade::Percent:
+        d = stod( bufStat );
+        if( d > 100 ) {
+            throw out_of_range( "quantile beyond 100%" );
+        }
+        d = stats.quantile( d / 100.0 );
         break;
+    }
+    showNumber( d );
+    statmode_ = INPUT_MODE::op;
+}
+
+/**
+ * @brief showNumber sets the buffer of the current mode to a result in
+ * Double precision.
+ * @param d result.
+ * @throws overflow_error if the result exceeds the display.
+ */
+void InputProcessor::showNumber( double d ) {
+    if( d <= 9999999999.999999 && d >= -999999999.999999 ) {
+        string d2str = to_string2( d );
+        buffer() = d2str;
+    } else {
+        cout << "OVERFLOW." << endl;
+        throw overflow_error( "OVERFLOW." );
+    }
+}
 
-    case GuiFacade::Comma:
-        if( hasDot ) {
-            break;
+/**
+ * @brief calcDigit appends a digit or comma to the buffer of Calculator-
+ * or StatisticsMode. After operator input, the buffer is cleared first. A
+ * second comma is ignored.
+ * @param key digit or comma key.
+ * @param afterOp true if operator was input before.
+ */
+void InputProcessor::calcDigit( int key, bool afterOp ) {
+    static const char digits [] = {'0','1','2','3','4','5','6','7','8','9','.'};
+    char dig = digits[ key - GuiFacade::K0 ];
+    string& buf = buffer();
+    bool hasDot = buf.find( "." ) != string::npos;
+    if( key == GuiFacade::Comma && hasDot ) {
+        return;
+    }
+    if( afterOp ) {
+        clearBuffer( &buf, "0" );
+    }
+    unsigned int maxdigits = DisplayController::len + ( hasDot? 1 : 0 );
+    bool isleadingZero = buf.length()==1 && buf.at( 0 )=='0';
+    if( ! isleadingZero || key == GuiFacade::Comma ) {
+        if( buf.length() < maxdigits ) {
+            buf.append( string( 1, dig ) );
         }
-        // case fall-through
-    case GuiFacade::K0:
-    case GuiFacade::K1:
-    case GuiFacade::K2:
-    case GuiFacade::K3:
-    case GuiFacade::K4:
-    case GuiFacade::K5:
-    case GuiFacade::K6:
-    case GuiFacade::K7:
-    case GuiFacade::K8:
-    case GuiFacade::K9: {
-            static const char digits [] = {'0','1','2','3','4','5','6','7','8','9','.'};
-            char dig = digits[ e.ev - GuiFacade::K0 ];
-
-            if( inpmode_ == INPUT_MODE::op ) {
-                clearBuffer( &bufNumber, "0" );
-            }
-            unsigned int maxdigits = DisplayController::len + ( hasDot? 1 : 0 );
-            bool isleadingZero = bufNumber.length()==1 && bufNumber.at( 0 )=='0';
-            if( ! isleadingZero || e.ev == GuiFacade::Comma ) {
-                if( bufNumber.length() < maxdigits ) {
-                    bufNumber.append( string( 1, dig ) );
-                }
-            } else {
-                bufNumber[0] = dig;
-            }
-            inpmode_ = INPUT_MODE::numbers;
+    } else {
+        buf[0] = dig;
+    }
+    subMode() = INPUT_MODE::numbers;
+}
 
-        } break;
+/**
+ * @brief record records a checkpoint before an operation. Redo steps are
+ * discarded, the oldest checkpoint beyond UNDO_STEPS is dropped.
+ */
+void InputProcessor::record() {
+    undoSteps.push_back( current() );
+    if( undoSteps.size() > UNDO_STEPS ) {
+        undoSteps.pop_front();
+    }
+    redoSteps.clear();
+}
 
-    case GuiFacade::BS: {
-            if( bufNumber.length() > 1 ) {
-                bufNumber.pop_back();
-            } else {
-               clearBuffer( &bufNumber, "0" );
-            }
-        }  break;
-
-    case GuiFacade::C:
-            alu.clearAll();
-            // case fall-through
-    case GuiFacade::CE: {
-            alu.clearTop();
-            bufNumber = "0";
-        } break;
-
-    case GuiFacade::K000: {
-            XEventFactory& ef = builder.getEventFactory();
-            XEvent& xe0 = ef.getEvent( GuiFacade::KeyEvt::K0 );
-            notify( xe0 );
-            notify( xe0 );
-            notify( xe0 );
-        } break;
+/**
+ * @brief undo returns to the checkpoint before the last operation, which
+ * becomes a redo step unless the operation failed.
+ * @param failed the last operation caused the error condition.
+ */
+void InputProcessor::undo( bool failed ) {
+    if( ! undoSteps.empty() ) {
+        if( ! failed ) {
+            redoSteps.push_back( current() );
+        }
+        apply( undoSteps.back() );
+        undoSteps.pop_back();
+    }
+}
+
+/**
+ * @brief redo repeats the last undone operation by returning to the
+ * checkpoint after it.
+ */
+void InputProcessor::redo() {
+    if( ! redoSteps.empty() ) {
+        undoSteps.push_back( current() );
+        apply( redoSteps.back() );
+        redoSteps.pop_back();
     }
-    builder.getDisplayController().updateDisplay( bufNumber );
+}
+
+InputProcessor::Checkpoint InputProcessor::current() const {
+    return Checkpoint{ alu.checkpoint(), bufNumber, inpmode_ };
+}
+
+void InputProcessor::apply( const Checkpoint& c ) {
+    alu.restore( c.state );
+    bufNumber = c.bufNumber;
+    inpmode_ = c.inpmode;
 }
 
 
 /**
- * @brief notify_CalcMode sub-method invoked by notify() in CalculatorMode.
- * @param e input event.
+ * @brief timerDigit shifts a digit into bufTime from the right in
+ * TimerMode. Digits are ignored while the countdown is running.
+ * @param key digit key.
  */
-void InputProcessor::notify_TimerMode( XEvent& e ) {
-    switch( e.ev ) {
+void InputProcessor::timerDigit( int key ) {
+    char dig = char( '0' + key - GuiFacade::K0 );
+    if( ! timer.isRunning() ) {
+        bufTime[0] = bufTime[1];
+        bufTime[1] = bufTime[3];
+        bufTime[3] = bufTime[4];
+        bufTime[4] = bufTime[6];
+        bufTime[6] = bufTime[7];
+        bufTime[7] = dig;
+    }
+}
 
-    case GuiFacade::Start:
-        break;
-    case GuiFacade::Stop:
-        break;
 
-    case GuiFacade::K0:
-    case GuiFacade::K1:
-    case GuiFacade::K2:
-    case GuiFacade::K3:
-    case GuiFacade::K4:
-    case GuiFacade::K5:
-    case GuiFacade::K6:
-    case GuiFacade::K7:
-    case GuiFacade::K8:
-    case GuiFacade::K9: {
-            static const char digits [] = {'0','1','2','3','4','5','6','7','8','9','.'};
-            char dig = digits[ e.ev - GuiFacade::K0 ];
-
-            if( dig >= '0' && dig <= '9' ) {
-                bufTime[0] = bufTime[1];
-                bufTime[1] = bufTime[3];
-                bufTime[3] = bufTime[4];
-                bufTime[4] = bufTime[6];
-                bufTime[6] = bufTime[7];
-                bufTime[7] = dig;
-            }
-        } break;
-
-    case GuiFacade::BS:
-    case GuiFacade::C:
-            clearBuffer( &bufTime, "12:00:00" );
-            break;
-    case GuiFacade::CE:
-            clearBuffer( &bufTime, "23:59:59" );
-            break;
+
+/**
+ * @brief countdownChanged is invoked when the displayed time of the
+ * countdown has changed. bufTime is updated and mirrored to the display
+ * in TimerMode.
+ * @param c countdown.
+ */
+void InputProcessor::countdownChanged( Countdown& c ) {
+    bufTime = Countdown::format( c.seconds() );
+    if( mode == TimerMode && ! err ) {
+        display.updateDisplay( bufTime );
+    }
+    if( c.seconds() == 0 && pub ) {
+        publishMsg( builder.getEventFactory(), getName() + ": " + c.getName() + " expired." );
     }
-    builder.getDisplayController().updateDisplay( bufTime );
 }
 
 
@@ -1,9 +1,13 @@
 #ifndef INPUTPROCESSOR_H
 #define INPUTPROCESSOR_H
 
+#include <deque>
 #include "controllerintf.h"
+#include "countdown.h"
+#include "calculator.h"
+#include "statistics.h"
 class Builder;
-class Calculator;
+class DisplayController;
 using namespace std;
 
 
@@ -16,16 +20,43 @@ using namespace std;
  * input events. Input events are collected in buffers where they can be edited
  * (backspace event). Buffer content is mirrored to the display.
  *
- * Inputprocessor is in one of the following MODE's {CalculatorMode,TimerMode}.
+ * Inputprocessor is in one of the following MODE's {CalculatorMode,TimerMode,
+ * StatisticsMode}.
  * In CalculatorMode, input is processed for calculator functions (construct
  * numerical numbers as operands and operators from input events and invoke
  * calculator logic to perform calculations).
  * In TimerMode, input for the time/timer function is processed and the timer
- * logic is invoked.
- * Receiving a mode-event, toggles mode.
+ * logic is invoked. Start/Stop start and pause the "Timer" countdown, which
+ * is mirrored to the display whenever its displayed time changes.
+ * In StatisticsMode, numbers are entered as in CalculatorMode, but into a
+ * buffer and sub-mode of their own, and added to running statistics by +
+ * or =, which shows the count. + and = are ignored unless a number was
+ * entered since, e.g. after a statistic is shown. Keys show a statistic:
+ * * the sum, / the mean, sqrt the standard deviation, x^2 the variance,
+ * ( and ) the minimum and maximum, % the quantile of the percent entered
+ * (e.g. 50 % the median; ignored after a statistic). C clears the statistics, CE the entry. The
+ * calculator state is kept while in StatisticsMode.
+ * Receiving a mode-event, switches to the next mode.
+ *
+ * Input events are processed by a table-driven state machine. The
+ * transition table maps state (mode, sub-mode, error condition) and input
+ * event to an action and is generated at compile time.
+ *
+ * Function keys (sqrt, x^2, 1/x, ln, exp, sin, cos) replace the number
+ * shown by the function value, x^y is a binary operator. Percent and VAT
+ * are postfix operators, e.g. "200 + 10 %" and "100 VAT". The category key
+ * selects the VAT rate of the product category whose index is shown.
+ *
+ * Operations (operators, functions, C and CE) can be undone and redone in
+ * CalculatorMode. Before each operation, a checkpoint of the calculator
+ * stacks, which is O(1) with persistent stacks, and of the number buffer
+ * is recorded. Undo also clears an error condition caused by the undone
+ * operation. The last UNDO_STEPS operations are kept.
  */
-class InputProcessor : public ControllerIntf, public SubscriberIntf {
+class InputProcessor : public ControllerIntf, public SubscriberIntf, public Countdown::ListenerIntf {
     friend class Builder;
+    friend class Session;
+    friend class StateSnapshot;
 
   public:
     /**
@@ -40,12 +71,32 @@ class InputProcessor : public ControllerIntf, public SubscriberIntf {
     /**
      * @brief notify method inherited from SubscriberIntf is invoked when
      * an input event such as keypad- or keypress-event has occured.
-     * notify() dispatches events to sub-methods notify_CalcMode and
-     * notify_TimerMode depending on InputProcessor mode.
+     * notify() dispatches events to step(), which performs the action of
+     * the transition table for the current state.
      * @param e input event.
      */
     virtual void notify( XEvent& e );
 
+    /**
+     * @brief reset returns the input processor to its initial logical state
+     * for a warm restart: CalculatorMode, cleared buffers and calculator
+     * stacks, no error condition and a reset countdown.
+     */
+    void reset();
+
+    /**
+     * @brief refresh mirrors the buffer of the current mode to the display,
+     * e.g. after the logical state has been restored from a snapshot.
+     */
+    void refresh();
+
+    /**
+     * @brief countdownChanged method inherited from Countdown::ListenerIntf
+     * is invoked when the displayed time of the countdown has changed.
+     * @param c countdown.
+     */
+    virtual void countdownChanged( Countdown& c );
+
     /**
      * @brief getName returns the name of the InputProcessor instance.
      * @return name of the InputProcessor instance.
@@ -58,12 +109,14 @@ class InputProcessor : public ControllerIntf, public SubscriberIntf {
      * @param name name of the InputProcessor instance.
      * @param builder reference to builder instance.
      * @param alu reference to Calculator logic (algorithmic logical unit).
+     * @param countdowns reference to countdown engine used in TimerMode.
+     * @param display reference to display controller input is mirrored to.
      * @param pub reference to optional publisher of controller events.
      */
-    InputProcessor( const std::string name, Builder& builder,
-        Calculator& alu, PublisherIntf *pub = nullptr )
+    InputProcessor( const std::string name, Builder& builder, Calculator& alu,
+        CountdownEngine& countdowns, DisplayController& display, PublisherIntf *pub = nullptr )
       : ControllerIntf( name, pub ), SubscriberIntf( name ),
-        builder( builder ), alu( alu )
+        builder( builder ), alu( alu ), display( display ), timer( countdowns.get( "Timer", this ) )
     {}
 
     virtual ~InputProcessor();
@@ -75,40 +128,115 @@ class InputProcessor : public ControllerIntf, public SubscriberIntf {
      * @param name name of the InputProcessor instance.
      * @param builder reference to builder instance.
      * @param alu reference to Calculator logic (algorithmic logical unit).
+     * @param countdowns reference to countdown engine used in TimerMode.
+     * @param display reference to display controller input is mirrored to.
      * @param pub reference to optional publisher of controller events.
      * @return reference to singleton InputProcessor instance.
      */
-    static InputProcessor& getInstance( std::string name, Builder& builder, Calculator& alu, PublisherIntf *pub = nullptr );
+    static InputProcessor& getInstance( std::string name, Builder& builder, Calculator& alu,
+        CountdownEngine& countdowns, DisplayController& display, PublisherIntf *pub = nullptr );
 
     /**
-     * @brief notify_CalcMode sub-method invoked by notify() in CalculatorMode.
-     * @param e input event.
+     * @brief step performs the action of the transition table for input
+     * event 'key' in the current state and updates the display.
+     * @param key input event as GuiFacade::KeyEvt.
      */
-    void notify_CalcMode( XEvent& e );
+    void step( int key );
 
     /**
-     * @brief notify_TimerMode sub-method invoked by notify() in TimerMode.
-     * @param e input event.
+     * @brief Actions invoked by step() in CalculatorMode and TimerMode.
+     * @param key input event as GuiFacade::KeyEvt.
+     * @param afterNumber, afterOp sub-mode in which the key was received.
      */
-    void notify_TimerMode( XEvent& e );
+    void calcOperator( int key, bool afterNumber );
+    void calcFunction( int key );
+    void calcCategory();
+    void calcDigit( int key, bool afterOp );
+    void timerDigit( int key );
+    void showNumber( double d );
+    void statShow( int key );
+
+    /**
+     * @brief buffer and subMode return the buffer and sub-mode of the
+     * current mode. TimerMode has no sub-mode and shares inpmode_.
+     */
+    string& buffer() { return mode == TimerMode? bufTime : mode == StatisticsMode? bufStat : bufNumber; }
+    int& subMode() { return mode == StatisticsMode? statmode_ : inpmode_; }
+
+    /**
+     * @brief Checkpoint is an undo step holding the calculator state and
+     * the number buffer and sub-mode before an operation.
+     */
+    struct Checkpoint {
+        Calculator::State state;
+        string bufNumber;
+        int inpmode;
+    };
+
+    /**
+     * @brief record records a checkpoint before an operation and discards
+     * redo steps. undo() and redo() return to the previous or next
+     * checkpoint, if any.
+     * @param failed the undone operation caused the error condition.
+     */
+    void record();
+    void undo( bool failed );
+    void redo();
+    Checkpoint current() const;
+    void apply( const Checkpoint& c );
 
 
     /*
      * @brief Private member variables.
      */
-    enum MODE { CalculatorMode, TimerMode };
+    enum MODE { CalculatorMode, TimerMode, StatisticsMode };
     MODE mode = CalculatorMode;
 
     string bufNumber = "0";         // buffer to collect and display input in CalculatorMode
     string bufTime = "12:00:00";    // buffer to collect and display input in TimerMode
+    string bufStat = "0";           // buffer to collect and display input in StatisticsMode
 
     bool err = false;                   // indicates Error-condition
 
+    static const size_t UNDO_STEPS = 1000;
+    deque<Checkpoint> undoSteps;        // checkpoints before operations, latest last
+    vector<Checkpoint> redoSteps;       // checkpoints of undone operations, latest last
+
+    Statistics stats;                   // statistics of numbers entered in StatisticsMode
+
     enum INPUT_MODE { numbers, op };    // sub-mode in CalculatorMode indicating whether
     int inpmode_ = numbers;             // input events relate to numbers or operators
+    int statmode_ = numbers;            // sub-mode in StatisticsMode
+
+    /*
+     * @brief Transition table of the input state machine. The state
+     * consists of mode, sub-mode of the mode (subMode()) and err. For each
+     * state and input event, the table holds the action performed by step()
+     * and flags for the transition of mode and err. The table is generated
+     * at compile time.
+     */
+    enum ACTION {
+        None, Show, CalcOperator, CalcSetOperator, CalcFunction, CalcDigit, CalcDigitAfterOp,
+        CalcComma, CalcCommaAfterOp, CalcBackspace, CalcClearAll, CalcClearEntry, CalcK000,
+        CalcUndo, CalcRedo, CalcCategory,
+        StatEnter, StatShow, StatClear, StatClearEntry,
+        TimerStart, TimerStop, TimerDigit, TimerClear, TimerPreset,
+        ACTION_MASK = 0x3f, NEXT_MODE = 0x40, CLEAR_ERR = 0x80
+    };
+    static const int MODES = 3;
+    static const int KEYS = 38;         // number of GuiFacade::KeyEvt events
+
+    static constexpr uint8_t calcAction( int sub, int key );
+    static constexpr uint8_t timerAction( int key );
+    static constexpr uint8_t statAction( int sub, int key );
+    static constexpr uint8_t transition( int mode, int sub, int err, int key );
+
+    static const uint8_t transitions[ MODES ][ 2 ][ 2 ][ KEYS ];
 
     Builder& builder;                   // reference to builder instance
     Calculator& alu;                    // reference to calculator logic
+    DisplayController& display;         // display controller input is mirrored to
+    Countdown& timer;                   // countdown used in TimerMode
 
     static InputProcessor *_this;       // private static pointer declaration
                                         // for singleton instance
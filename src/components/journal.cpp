@@ -0,0 +1,352 @@
+#include <stdexcept>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "journal.h"
+#include "guifacade.h"
+
+
+static_assert( sizeof( Journal::Record ) == 40, "Record must have no padding" );
+
+
+/**
+ * @brief Journal constructor opens or creates the journal file and starts
+ * the writer thread. A new file gets a header. An existing file is checked
+ * and a truncated last record is cut off, such that appended records stay
+ * aligned.
+ * @param path of journal file.
+ * @param commitMsec maximum delay of writing appended records.
+ * @param syncMsec minimum period of fdatasync().
+ * @throws runtime_error if the file cannot be opened or is no journal.
+ */
+Journal::Journal( const string path, int commitMsec, int syncMsec )
+    : path( path ), commitMsec( commitMsec ), syncMsec( syncMsec )
+{
+    fd = open( path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644 );
+    if( fd < 0 ) {
+        throw runtime_error( "cannot open journal " + path + ": " + strerror( errno ) );
+    }
+    struct stat st;
+    uint32_t h[ HEADER_SIZE / 4 ] = { MAGIC, VERSION, uint32_t( sizeof( Record ) ), 0 };
+    bool ok = fstat( fd, &st ) == 0;
+    if( ok && st.st_size == 0 ) {
+        ok = ::write( fd, h, HEADER_SIZE ) == ssize_t( HEADER_SIZE ) && fdatasync( fd ) == 0;
+    } else if( ok ) {
+        uint32_t r[ HEADER_SIZE / 4 ];
+        ok = pread( fd, r, HEADER_SIZE, 0 ) == ssize_t( HEADER_SIZE ) && memcmp( r, h, 12 ) == 0;
+        off_t records = ( st.st_size - off_t( HEADER_SIZE ) ) / off_t( sizeof( Record ) );
+        end = off_t( HEADER_SIZE ) + records * off_t( sizeof( Record ) );
+        ok = ok && ftruncate( fd, end ) == 0;
+    }
+    if( ! ok ) {
+        ::close( fd );
+        throw runtime_error( "cannot open journal or unsupported version: " + path );
+    }
+    pending.reserve( GROUP_BYTES / sizeof( Record ) );
+    t = thread( &Journal::writer, this );
+}
+
+/**
+ * @brief Journal destructor commits all appended records and stops the
+ * writer thread.
+ */
+Journal::~Journal() {
+    {
+        lock_guard<mutex> l( lock );
+        running = false;
+        wakeup.notify_one();
+    }
+    t.join();
+    ::close( fd );
+    for( vector<Tap *>::iterator it = taps.begin(); it != taps.end(); it++ ) {
+        delete *it;
+    }
+}
+
+
+/**
+ * @brief Journal::attach a calculator tagging its reductions with 'session'.
+ * @param alu calculator.
+ * @param session of calculator.
+ */
+void Journal::attach( Calculator& alu, uint32_t session ) {
+    lock_guard<mutex> l( lock );
+    Tap *tap = new Tap( *this, alu, session );
+    alu.setListener( tap );
+    taps.push_back( tap );
+}
+
+/**
+ * @brief Journal::detach a calculator.
+ * @param alu calculator.
+ */
+void Journal::detach( Calculator& alu ) {
+    lock_guard<mutex> l( lock );
+    for( vector<Tap *>::iterator it = taps.begin(); it != taps.end(); it++ ) {
+        if( &( *it )->alu == &alu ) {
+            alu.setListener( nullptr );
+            delete *it;
+            taps.erase( it );
+            return;
+        }
+    }
+}
+
+
+/**
+ * @brief Journal::Tap::reduced appends a reduction of the attached
+ * calculator tagged with its precision.
+ */
+void Journal::Tap::reduced( double operand1, int op, double operand2, double result ) {
+    Record r = { Journal::now(), session, int32_t( op | alu.getPrecision() << PRECISION_SHIFT ),
+                 operand1, operand2, result };
+    journal.append( r );
+}
+
+
+/**
+ * @brief Journal::append copies a record into the buffer of pending
+ * records. The writer thread is only woken up early when a group of
+ * GROUP_BYTES has been collected.
+ * @param r record.
+ */
+void Journal::append( const Record& r ) {
+    lock_guard<mutex> l( lock );
+    pending.push_back( r );
+    appended++;
+    if( pending.size() == GROUP_BYTES / sizeof( Record ) ) {
+        wakeup.notify_one();
+    }
+}
+
+/**
+ * @brief Journal::commit blocks until all records appended before are
+ * written and synced to disk.
+ * @throws runtime_error if writing or syncing the journal has failed,
+ * also in an earlier commit.
+ */
+void Journal::commit() {
+    unique_lock<mutex> l( lock );
+    uint64_t n = appended;
+    if( durable < n && error.empty() ) {
+        syncRequested = true;
+        wakeup.notify_one();
+        while( durable < n && running && error.empty() ) {
+            committed.wait( l );
+        }
+    }
+    if( ! error.empty() ) {
+        throw runtime_error( error );
+    }
+}
+
+uint64_t Journal::size() const {
+    lock_guard<mutex> l( lock );
+    return appended;
+}
+
+
+/**
+ * @brief Journal::writer is the loop of the writer thread. Pending records
+ * are swapped out and written with one write() outside the lock, such that
+ * appending is not blocked by I/O. fdatasync() follows the write when
+ * 'syncMsec' have passed since the last sync, when commit() waits or when
+ * the journal is closed.
+ *
+ * If write() fails, the file is truncated to the end of the last record
+ * written, such that records stay aligned, and the group is written again
+ * with the next one (or given up when the journal is closed). Records only
+ * become durable after a successful write and fdatasync(); any failure is
+ * kept as sticky error reported by commit().
+ */
+void Journal::writer() {
+    vector<Record> group;
+    group.reserve( pending.capacity() );
+    chrono::steady_clock::time_point synced = chrono::steady_clock::now();
+    uint64_t written = durable;         // records written to the file
+    unique_lock<mutex> l( lock );
+    for( ;; ) {
+        bool stop = ! running;
+        if( ! stop && ! syncRequested && pending.size() < GROUP_BYTES / sizeof( Record ) ) {
+            wakeup.wait_for( l, chrono::milliseconds( commitMsec ) );
+        }
+        if( group.empty() ) {
+            group.swap( pending );
+        } else {
+            group.insert( group.end(), pending.begin(), pending.end() );
+            pending.clear();
+        }
+        uint64_t n = appended;
+        bool sync = syncRequested || ! running;
+        syncRequested = false;
+        l.unlock();
+
+        string failed;
+        const char *p = reinterpret_cast<const char *>( group.data() );
+        size_t bytes = group.size() * sizeof( Record );
+        while( bytes > 0 ) {
+            ssize_t w = ::write( fd, p, bytes );
+            if( w < 0 && errno == EINTR ) {
+                continue;
+            }
+            if( w <= 0 ) {
+                failed = "cannot write journal " + path + ": " + strerror( w < 0? errno : EIO );
+                if( ftruncate( fd, end ) < 0 ) {
+                    failed += string( ", cannot truncate: " ) + strerror( errno );
+                }
+                break;
+            }
+            p += w;
+            bytes -= size_t( w );
+        }
+        if( failed.empty() ) {
+            end += off_t( group.size() * sizeof( Record ) );
+            written = n;
+            group.clear();
+        }
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        sync = sync || ( written > durable && now - synced >= chrono::milliseconds( syncMsec ) );
+        if( sync && failed.empty() ) {
+            if( fdatasync( fd ) < 0 ) {
+                failed = "cannot sync journal " + path + ": " + strerror( errno );
+            }
+            synced = now;
+        }
+
+        l.lock();
+        if( ! failed.empty() && error.empty() ) {
+            cerr << failed << endl;
+            error = failed;
+        }
+        if( sync && failed.empty() ) {
+            durable = written;
+        }
+        if( sync || ! failed.empty() ) {
+            committed.notify_all();
+        }
+        if( stop && ( pending.empty() || ! failed.empty() ) ) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Journal::now returns the wall-clock time in usec.
+ */
+uint64_t Journal::now() {
+    return uint64_t( chrono::duration_cast<chrono::microseconds>(
+                         chrono::system_clock::now().time_since_epoch() ).count() );
+}
+
+
+/**
+ * @brief Journal::dump prints a journal file as tape to cout, one
+ * reduction per line with local time and session.
+ * @param path of journal file.
+ * @return exit code.
+ */
+int Journal::dump( const string& path ) {
+    try {
+        JournalReader journal( path );
+        for( const Record *r = journal.begin(); r != journal.end(); r++ ) {
+            cout << format( *r ) << "\n";
+        }
+        cout << journal.size() << " reductions." << endl;
+
+    } catch( exception& e ) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief Journal::format returns a record as line of the tape with local
+ * time and session.
+ * @param r record.
+ * @return line without newline.
+ */
+string Journal::format( const Record& r ) {
+    int key = r.op & OP_MASK;
+    time_t sec = time_t( r.usec / 1000000 );
+    struct tm tm;
+    char stamp[ 32 ], line[ 160 ];
+    strftime( stamp, sizeof( stamp ), "%Y-%m-%d %H:%M:%S", localtime_r( &sec, &tm ) );
+    const char *op = opName( key );
+    if( key >= GuiFacade::Sqrt && key <= GuiFacade::Cos ) {
+        sprintf( line, "%s.%03u  session %u:  %s %.10g = %.10g", stamp, unsigned( r.usec / 1000 % 1000 ),
+                 r.session, op, r.operand1, r.result );
+    } else if( key == GuiFacade::Percent ) {
+        sprintf( line, "%s.%03u  session %u:  %.10g %s = %.10g", stamp, unsigned( r.usec / 1000 % 1000 ),
+                 r.session, r.operand1, op, r.result );
+    } else {
+        sprintf( line, "%s.%03u  session %u:  %.10g %s %.10g = %.10g", stamp, unsigned( r.usec / 1000 % 1000 ),
+                 r.session, r.operand1, op? op : "?", r.operand2, r.result );
+    }
+    return line;
+}
+
+/**
+ * @brief Journal::opName returns the symbol of an operator or function
+ * (without precision bits).
+ * Functions and Percent are unary and recorded with operand2 = 0, VAT is
+ * recorded with the rate in percent as operand2.
+ * @param op operator as GuiFacade::KeyEvt.
+ */
+const char *Journal::opName( int op ) {
+    static const char *ops[] = { "+", "-", "*", "/", "%", "VAT", "=" };
+    static const char *functions[] = { "sqrt", "sqr", "1/x", "ln", "exp", "sin", "cos", "^" };
+    if( op >= GuiFacade::Plus && op <= GuiFacade::EQ ) {
+        return ops[ op - GuiFacade::Plus ];
+    }
+    if( op >= GuiFacade::Sqrt && op <= GuiFacade::Pow ) {
+        return functions[ op - GuiFacade::Sqrt ];
+    }
+    return nullptr;
+}
+
+
+/**
+ * @brief JournalReader constructor maps the journal file read-only. A
+ * truncated last record is ignored.
+ * @param path of journal file.
+ * @throws runtime_error if the file cannot be mapped or is no journal.
+ */
+JournalReader::JournalReader( const string& path ) {
+    int fd = open( path.c_str(), O_RDONLY );
+    struct stat st;
+    if( fd < 0 || fstat( fd, &st ) < 0 || size_t( st.st_size ) < Journal::HEADER_SIZE ) {
+        if( fd >= 0 ) {
+            ::close( fd );
+        }
+        throw runtime_error( "cannot read journal: " + path );
+    }
+    length = size_t( st.st_size );
+    base = mmap( nullptr, length, PROT_READ, MAP_SHARED, fd, 0 );
+    ::close( fd );
+    if( base == MAP_FAILED ) {
+        base = nullptr;
+        throw runtime_error( "cannot map journal " + path + ": " + strerror( errno ) );
+    }
+    const uint32_t *h = static_cast<const uint32_t *>( base );
+    if( h[0] != Journal::MAGIC || h[1] != Journal::VERSION || h[2] != sizeof( Journal::Record ) ) {
+        munmap( base, length );
+        throw runtime_error( "no journal or unsupported version: " + path );
+    }
+    madvise( base, length, MADV_SEQUENTIAL );
+    records = reinterpret_cast<const Journal::Record *>( static_cast<const char *>( base ) + Journal::HEADER_SIZE );
+    count = ( length - Journal::HEADER_SIZE ) / sizeof( Journal::Record );
+}
+
+JournalReader::~JournalReader() {
+    if( base != nullptr ) {
+        munmap( base, length );
+    }
+}
@@ -0,0 +1,193 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <sys/types.h>
+#include "calculator.h"
+using namespace std;
+
+
+/**
+ * @brief The Journal class appends every reduction of attached calculators
+ * to an append-only binary journal file, the history tape used to audit
+ * till operations (Linux only).
+ *
+ * The file consists of a 16-byte header (magic "SE2J", version, record
+ * size, reserved) followed by fixed-size records in host byte order, such
+ * that JournalReader can scan a mapped file without decoding. A truncated
+ * last record, e.g. after a crash while writing, is ignored by readers and
+ * cut off when the journal is opened again for appending.
+ *
+ * Operands and results are recorded as doubles. Calculators in Big or
+ * Fraction precision record the nearest doubles of their exact values and
+ * tag the operator with the precision (bits PRECISION_SHIFT and up of op,
+ * 0 for Double as in older journals), such that replays can tell results
+ * computed in double from rounded exact ones.
+ *
+ * append() only copies the record into a buffer. A writer thread commits
+ * all records appended in the meantime with one write() every 'commitMsec'
+ * or when the buffer has grown to GROUP_BYTES (group commit) and makes them
+ * durable with fdatasync() at most every 'syncMsec'. commit() blocks until
+ * all records appended before are durable and reports a failed write or
+ * sync. After a failed write, the file is cut back to the last complete
+ * record. Records can be appended from several threads, e.g. by sessions
+ * of a SessionExecutor.
+ */
+class Journal {
+
+  public:
+    struct Record {
+        uint64_t usec;              // wall-clock time in usec since epoch
+        uint32_t session;           // session of calculator
+        int32_t op;                 // operator as GuiFacade::KeyEvt | precision << PRECISION_SHIFT
+        double operand1;
+        double operand2;
+        double result;
+    };
+
+    static const uint32_t MAGIC = 0x4a324553;       // "SE2J"
+    static const uint32_t VERSION = 1;
+    static const size_t HEADER_SIZE = 16;
+    static const size_t GROUP_BYTES = 64 * 1024;
+    static const int32_t OP_MASK = 0xff;            // operator bits of Record::op
+    static const int PRECISION_SHIFT = 8;           // Calculator::Precision in Record::op
+
+    /**
+     * @brief Journal constructor opens or creates the journal file and
+     * starts the writer thread.
+     * @param path of journal file.
+     * @param commitMsec maximum delay of writing appended records.
+     * @param syncMsec minimum period of fdatasync().
+     * @throws runtime_error if the file cannot be opened or is no journal.
+     */
+    Journal( const string path, int commitMsec = 10, int syncMsec = 1000 );
+    ~Journal();
+
+    /**
+     * @brief attach a calculator, whose reductions are appended tagged with
+     * 'session'. A calculator must be detached before it is deleted.
+     * Calculators can be attached and detached from several threads.
+     * @param alu calculator.
+     * @param session of calculator.
+     */
+    void attach( Calculator& alu, uint32_t session );
+    void detach( Calculator& alu );
+
+    /**
+     * @brief append a record, which is committed by the writer thread.
+     * commit() blocks until all records appended before are durable.
+     * @param r record.
+     * @throws runtime_error (commit) if the journal could not be written
+     * or synced.
+     */
+    void append( const Record& r );
+    void commit();
+
+    uint64_t size() const;
+
+    /**
+     * @brief dump prints a journal file as tape to cout. Invoked from
+     * main() for option --journal-dump.
+     * @param path of journal file.
+     * @return exit code.
+     */
+    static int dump( const string& path );
+
+    /**
+     * @brief format returns a record as line of the tape, e.g.
+     * "2026-10-18 09:15:02.125  session 0:  12 + 3 = 15".
+     * @param r record.
+     * @return line without newline.
+     */
+    static string format( const Record& r );
+
+    /**
+     * @brief opName returns the symbol of an operator or function as
+     * used on the tape, e.g. "+" or "sqrt", nullptr for other keys.
+     * @param op operator as GuiFacade::KeyEvt.
+     */
+    static const char *opName( int op );
+
+    /**
+     * @brief now returns the wall-clock time in usec used as timestamp.
+     */
+    static uint64_t now();
+
+  private:
+    Journal( const Journal& ) = delete;
+    Journal& operator=( const Journal& ) = delete;
+
+    /**
+     * @brief Tap is the listener of an attached calculator.
+     */
+    class Tap : public Calculator::ListenerIntf {
+      public:
+        Tap( Journal& journal, Calculator& alu, uint32_t session ) : journal( journal ), alu( alu ), session( session ) {}
+        void reduced( double operand1, int op, double operand2, double result );
+
+        Journal& journal;
+        Calculator& alu;
+        const uint32_t session;
+    };
+
+    /**
+     * @brief writer is the loop of the writer thread.
+     */
+    void writer();
+
+    const string path;
+    const int commitMsec;
+    const int syncMsec;
+    int fd = -1;
+    off_t end = HEADER_SIZE;            // end of last record written, used by writer thread
+    vector<Tap *> taps;
+
+    mutable mutex lock;
+    condition_variable wakeup;          // signals the writer thread
+    condition_variable committed;       // signals commit()
+    vector<Record> pending;             // appended, not yet written
+    uint64_t appended = 0;              // number of appended records
+    uint64_t durable = 0;               // number of records synced to disk
+    string error;                       // first write or sync failure, sticky
+    bool syncRequested = false;
+    bool running = true;
+    thread t;
+};
+
+
+/**
+ * @brief JournalReader maps a journal file read-only for fast scanning
+ * of its records.
+ */
+class JournalReader {
+
+  public:
+    /**
+     * @brief JournalReader constructor maps the journal file.
+     * @param path of journal file.
+     * @throws runtime_error if the file cannot be mapped or is no journal.
+     */
+    JournalReader( const string& path );
+    ~JournalReader();
+
+    size_t size() const { return count; }
+    const Journal::Record& operator[]( size_t i ) const { return records[i]; }
+    const Journal::Record *begin() const { return records; }
+    const Journal::Record *end() const { return records + count; }
+
+  private:
+    JournalReader( const JournalReader& ) = delete;
+    JournalReader& operator=( const JournalReader& ) = delete;
+
+    void *base = nullptr;
+    size_t length = 0;
+    const Journal::Record *records = nullptr;
+    size_t count = 0;
+};
+
+#endif // JOURNAL_H
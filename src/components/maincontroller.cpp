@@ -4,6 +4,7 @@
 #include "inputprocessor.h"
 #include "eventfactory.h"
 #include "guifacade.h"
+#include "startupprofile.h"
 
 
 /**
@@ -29,6 +30,21 @@ ControllerIntf::~ControllerIntf() {
     //logDestructor( getName() );
 }
 
+/**
+ * @brief publishMsg publishes a log message, if a publisher instance is
+ * provided. Subscribers are notified synchronously, the message event is
+ * released when publish() returns.
+ * @param ef event factory.
+ * @param msg message.
+ */
+void ControllerIntf::publishMsg( XEventFactory& ef, const string& msg ) {
+    if( pub ) {
+        XEvent& e = ef.getEvent( msg );
+        publish( e );
+        ef.release( e );
+    }
+}
+
 MainController::~MainController() {
     logDestructor( getName() );
 }
@@ -36,58 +52,99 @@ MainController::~MainController() {
 
 /**
  * @brief probe propagates probe() invocations to other controllers and
- * attempts to transition operational state to Probing.
+ * attempts to transition operational state to Probing. Input processor
+ * and display are probed concurrently, completion is joined by 'probing'.
  * @param cb optional callback object at which the callback(XEvent *e)-
  * method is invoked when the probe-cycle has completed.
  */
-void MainController::probe( Callback* /* cb */ ) {
+void MainController::probe( Callback *cb ) {
+    counters.add( ControllerStats::Events );
     if( opState==Stopped || opState==RUNNING ) {
         opState = transitionTo( OpSt::Probing );
+        probeCb = cb;
 
-        builder.getInputProcessor().probe();
-
-        class DisplayControllerProbeCallback : public Callback {
-          public:
-            DisplayControllerProbeCallback( MainController& me ) : me( me ) {}
-            virtual ~DisplayControllerProbeCallback() {}
-
-            void callback( XEvent *probeResult ) {
-                if( probeResult->ev == RUNNING ) {
-                    // completes probing stage and transitions to running
-                    me.opState = me.transitionTo( OpSt::RUNNING );
-                    Builder::getInstance().getDisplayController().start();
-                    XEventFactory& ef = Builder::getInstance().getEventFactory();
-                    XEvent& xe_C = ef.getEvent( GuiFacade::KeyEvt::C );
-                    Builder::getInstance().getInputProcessor().notify( xe_C );
-                }
-            }
-          private:
-            MainController& me;
-        };
-
-        DisplayControllerProbeCallback *cb1 = new DisplayControllerProbeCallback( *this );
-        builder.getDisplayController().probe( cb1 );
+        probing.begin( &probed );
+        builder.getInputProcessor().probe( probing.fork() );
+        builder.getDisplayController().probe( probing.fork() );
+        probing.end();
+    }
+}
+
+/**
+ * @brief ProbeCompletion::callback is invoked when all controllers have
+ * been probed. If all probes succeeded, the probing stage is completed and
+ * operational state transitions to RUNNING.
+ * @param probeResult result of joined probes.
+ */
+void MainController::ProbeCompletion::callback( XEvent *probeResult ) {
+    if( me.opState==Probing && probeResult != nullptr && probeResult->ev == RUNNING ) {
+        // completes probing stage and transitions to running
+        me.opState = me.transitionTo( OpSt::RUNNING );
+        me.builder.getDisplayController().start();
+        XEventFactory& ef = me.builder.getEventFactory();
+        XEvent& xe_C = ef.getEvent( GuiFacade::KeyEvt::C );
+        me.builder.getInputProcessor().notify( xe_C );
+    }
+    Callback *cb = me.probeCb;
+    me.probeCb = nullptr;
+    if( cb != nullptr ) {
+        cb->callback( probeResult );
     }
 }
 
 /**
  * @brief start propagates start() invocations to other controllers and
- * attempts to transition operational state to RUNNING.
+ * attempts to transition operational state to RUNNING. The first start
+ * probes controllers if probing is enabled, subsequent starts are warm.
  */
 void MainController::start() {
+    counters.add( ControllerStats::Events );
     if( opState==Undef ) {  // initial state
         opState = transitionTo( OpSt::Stopped );
     }
     if( opState==Stopped ) {
-        if( enableProbing ) {
+        if( enableProbing && ! warm && ! restored ) {
             probe();
         } else {
-            opState = transitionTo( OpSt::RUNNING );
-            Builder::getInstance().getDisplayController().start();
+            warmStart();
         }
-        XEventFactory& ef = builder.getEventFactory();
-        publish( ef.getEvent( getName() + " started." ) );
+        warm = true;
+        publishMsg( builder.getEventFactory(), getName() + " started." );
+    }
+}
+
+/**
+ * @brief warmStart resets the logical state and transitions to RUNNING
+ * without probing. A state restored from a snapshot is kept and shown
+ * instead.
+ */
+void MainController::warmStart() {
+    InputProcessor& input = builder.getInputProcessor();
+    if( ! restored ) {
+        input.reset();
+    }
+    opState = transitionTo( OpSt::RUNNING );
+    builder.getDisplayController().start();
+    if( restored ) {
+        input.refresh();
+        restored = false;
+    }
+}
+
+/**
+ * @brief restart performs a warm restart keeping all components.
+ * @param probing run the probe cycle.
+ */
+void MainController::restart( bool probing ) {
+    uint64_t t0 = ControllerStats::nsec();
+    stop();
+    if( probing ) {
+        builder.getInputProcessor().reset();
+        probe();
+    } else {
+        start();
     }
+    counters.set( ControllerStats::RestartNsec, ControllerStats::nsec() - t0 );
 }
 
 /**
@@ -96,34 +153,45 @@ void MainController::start() {
  * @param exit terminate programm if set to true.
  */
 void MainController::stop( bool exit ) {
+    counters.add( ControllerStats::Events );
     XEventFactory& ef = builder.getEventFactory();
     if( opState==Probing || opState==RUNNING ) {
-        publish( ef.getEvent( getName() + " stopping." ) );
+        publishMsg( ef, getName() + " stopping." );
                 opState = transitionTo( OpSt::Stopping );
         builder.getDisplayController().stop( false );
 
-        publish( ef.getEvent( getName() + " stopped." ) );
+        publishMsg( ef, getName() + " stopped." );
         opState = transitionTo( OpSt::Stopped );
     }
     if( exit ) {
         opState = transitionTo( OpSt::Undef );
-        publish( ef.getEvent( "Exiting." ) );
-        builder.destroy();
-        delete &builder;
+        publishMsg( ef, "Exiting." );
+        Builder& b = builder;       // this instance is deleted by destroy()
+        b.destroy();
+        delete &b;
     }
 }
 
 /**
  * @brief transitionTo internal method to perform transitions of operational state.
+ * Transitions, the time spent in transitions and the time spent in the
+ * state left are counted.
  * @param to desired next state.
  * @return state that actually has been achieved.
  */
 MainController::OpSt MainController::transitionTo( OpSt to ) {
+    uint64_t t0 = ControllerStats::nsec();
     if( opState != RUNNING && to==RUNNING ) {
         builder.getInputProcessor().start();
+        StartupProfile::getInstance().ready( opState==Probing? "probe" : "start" );
     }
     if( opState==RUNNING && to != RUNNING ) {
         builder.getInputProcessor().stop();
     }
+    uint64_t t1 = ControllerStats::nsec();
+    counters.add( ControllerStats::Transitions );
+    counters.add( ControllerStats::TransitionNsec, t1 - t0 );
+    counters.set( ControllerStats::StateNsec, stateSince > 0? t0 - stateSince : 0 );
+    stateSince = t1;
     return to;
 }
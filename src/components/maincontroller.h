@@ -2,6 +2,7 @@
 #define MAINCONTROLLER_H
 
 #include "controllerintf.h"
+#include "join.h"
 class Builder;
 using namespace std;
 
@@ -17,6 +18,13 @@ using namespace std;
  * Input events received asynchronously from the Gui are only passed for further
  * processing in state RUNNING and ignored in other states.
  *
+ * Only the first start() is a cold start with probe cycle. Subsequent starts,
+ * e.g. by the On/Off key, and restart() are warm: the component graph is kept
+ * and only the logical state of InputProcessor and Calculator is reset.
+ *
+ * Controllers are probed concurrently. Their completions are joined by a Join
+ * embedded in MainController, which transitions to RUNNING when all probes
+ * have succeeded.
  */
 class MainController : public ControllerIntf {
     friend class Builder;
@@ -31,7 +39,8 @@ class MainController : public ControllerIntf {
      * @brief probe propagates probe() invocations to other controllers and
      * attempts to transition operational state to Probing.
      * @param cb optional callback object at which the callback(XEvent *e)-
-     * method is invoked when the probe-cycle has completed.
+     * method is invoked when the probe-cycle has completed, which must
+     * remain valid until then.
      */
     virtual void probe( Callback *cb = nullptr );
 
@@ -48,6 +57,14 @@ class MainController : public ControllerIntf {
      */
     virtual void stop( bool exit = false );
 
+    /**
+     * @brief restart performs a warm restart: stop() followed by a warm
+     * start that resets the logical state without probing, unless 'probing'
+     * is set. The duration is counted as ControllerStats::RestartNsec.
+     * @param probing run the probe cycle.
+     */
+    void restart( bool probing = false );
+
     /**
      * @brief isRunning test application is in RUNNING state.
      * @return true if application is in RUNNING state.
@@ -63,7 +80,7 @@ class MainController : public ControllerIntf {
      * @param pub reference to optional publisher of controller events.
      */
     MainController( const string name, Builder& builder, PublisherIntf *pub = nullptr )
-        : ControllerIntf( name, pub ), builder( builder ) {}
+        : ControllerIntf( name, pub ), probing( RUNNING ), probed( *this ), builder( builder ) {}
 
     virtual ~MainController();
 
@@ -85,12 +102,36 @@ class MainController : public ControllerIntf {
      */
     OpSt transitionTo( OpSt to );
 
+    /**
+     * @brief warmStart resets the logical state and transitions to RUNNING
+     * without probing. A state restored from a snapshot is kept instead.
+     */
+    void warmStart();
+
+    /**
+     * @brief ProbeCompletion is the continuation of the probe join, which
+     * completes the probing stage and transitions to RUNNING.
+     */
+    class ProbeCompletion : public Callback {
+      public:
+        ProbeCompletion( MainController& me ) : me( me ) {}
+        void callback( XEvent *probeResult );
+      private:
+        MainController& me;
+    };
+
 
     /*
      * @brief Private member variables.
      */
     bool enableProbing = true;      // flag to disable probe cycle.
+    bool warm = false;              // components have been started before
+    bool restored = false;          // state restored by Builder, start without reset
     OpSt opState = OpSt::Undef;     // operational state variable initialized with Undef.
+    Join probing;                   // joins completions of concurrent controller probes
+    ProbeCompletion probed;
+    Callback *probeCb = nullptr;    // callback passed to probe()
+    uint64_t stateSince = 0;        // time of last transition in nsec
 
     Builder& builder;
     static MainController *_this;   // private static pointer declaration
@@ -0,0 +1,407 @@
+#include <stdexcept>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <cmath>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "statesnapshot.h"
+#include "inputprocessor.h"
+#include "calculator.h"
+
+
+/**
+ * @brief StateSnapshot constructor opens or creates and maps the file. A
+ * created file is zero-filled, i.e. both slots are empty.
+ * @param path of snapshot file.
+ * @param input InputProcessor whose state is saved.
+ * @param alu Calculator whose stacks are saved.
+ * @param syncMsec delay of batched flushes, 0 to flush each save.
+ * @param wheel timer wheel driving batched flushes.
+ * @throws runtime_error if the file cannot be opened or mapped.
+ */
+StateSnapshot::StateSnapshot( const string path, InputProcessor& input, Calculator& alu, int syncMsec,
+                              TimerWheel& wheel )
+    : SubscriberIntf( "State Snapshot" ), path( path ), input( input ), alu( alu ),
+      syncMsec( syncMsec ), wheel( wheel )
+{
+    static_assert( sizeof( Slot ) == SLOT_SIZE, "Slot must fill one page" );
+    int fd = open( path.c_str(), O_RDWR | O_CREAT, 0600 );
+    if( fd < 0 ) {
+        throw runtime_error( "cannot open snapshot " + path + ": " + strerror( errno ) );
+    }
+    struct stat st;
+    if( fstat( fd, &st ) < 0 || ( st.st_size < off_t( 2 * SLOT_SIZE ) && ftruncate( fd, 2 * SLOT_SIZE ) < 0 ) ) {
+        ::close( fd );
+        throw runtime_error( "cannot size snapshot " + path + ": " + strerror( errno ) );
+    }
+    void *p = mmap( nullptr, 2 * SLOT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    ::close( fd );
+    if( p == MAP_FAILED ) {
+        throw runtime_error( "cannot map snapshot " + path + ": " + strerror( errno ) );
+    }
+    pages = static_cast<Slot *>( p );
+    for( int i=0; i < 2; i++ ) {
+        if( isValid( pages[i] ) && pages[i].seq > seq ) {
+            seq = pages[i].seq;
+        }
+    }
+}
+
+StateSnapshot::~StateSnapshot() {
+    wheel.cancel( *this );
+    if( dirty ) {
+        flush();
+    }
+    munmap( pages, 2 * SLOT_SIZE );
+}
+
+
+/**
+ * @brief StateSnapshot::notify saves the state after an input event or
+ * control message.
+ * @param e event.
+ */
+void StateSnapshot::notify( XEvent& /* e */ ) {
+    save();
+}
+
+/**
+ * @brief StateSnapshot::save writes the state to the slot not holding the
+ * latest snapshot, which stays valid until the new one is complete: the
+ * slot is invalidated first, its sequence number is written last. Nothing
+ * is written if the state equals the latest snapshot.
+ * @return false if the state does not fit into a slot.
+ */
+bool StateSnapshot::save() {
+    uint8_t buf[ sizeof( Slot::payload ) ];
+    uint32_t n = encode( buf );
+    if( n == 0 ) {
+        return false;
+    }
+    const Slot& last = pages[ seq & 1 ];
+    if( seq > 0 && last.length == n && memcmp( last.payload, buf, n ) == 0 ) {
+        return true;
+    }
+    Slot& s = pages[ ( seq + 1 ) & 1 ];
+    s.seq = 0;
+    atomic_thread_fence( memory_order_release );
+    memcpy( s.payload, buf, n );
+    s.length = n;
+    s.checksum = checksum( seq + 1, buf, n );
+    s.version = VERSION;
+    s.magic = MAGIC;
+    atomic_thread_fence( memory_order_release );
+    s.seq = ++seq;
+    saves++;
+
+    if( syncMsec <= 0 ) {
+        flush();
+    } else if( ! dirty ) {
+        dirty = true;
+        wheel.schedule( *this, uint64_t( syncMsec ) );
+    }
+    return true;
+}
+
+/**
+ * @brief StateSnapshot::restore applies the latest valid snapshot.
+ * @return false if the file holds no valid snapshot.
+ */
+bool StateSnapshot::restore() {
+    const Slot& s = pages[ seq & 1 ];
+    return seq > 0 && isValid( s ) && s.seq == seq && decode( s.payload, s.length );
+}
+
+
+/**
+ * @brief wallMsec returns the wall-clock time in msec, which unlike the
+ * monotonic clock continues across reboots.
+ */
+static uint64_t wallMsec() {
+    return uint64_t( chrono::duration_cast<chrono::milliseconds>(
+                         chrono::system_clock::now().time_since_epoch() ).count() );
+}
+
+/**
+ * @brief put appends 'n' bytes at p, putText() a u16 length and chars.
+ * @return false if they do not fit before 'end'.
+ */
+static bool put( uint8_t *& p, const uint8_t *end, const void *v, size_t n ) {
+    if( size_t( end - p ) < n ) {
+        return false;
+    }
+    memcpy( p, v, n );
+    p += n;
+    return true;
+}
+
+static bool putText( uint8_t *& p, const uint8_t *end, const string& s ) {
+    uint16_t n = uint16_t( s.length() );
+    return s.length() <= UINT16_MAX && put( p, end, &n, 2 ) && put( p, end, s.data(), n );
+}
+
+/**
+ * @brief get reads 'n' bytes at p, getText() a u16 length and chars.
+ * @return false if they exceed 'end'.
+ */
+static bool get( const uint8_t *& p, const uint8_t *end, void *v, size_t n ) {
+    if( size_t( end - p ) < n ) {
+        return false;
+    }
+    memcpy( v, p, n );
+    p += n;
+    return true;
+}
+
+static bool getText( const uint8_t *& p, const uint8_t *end, string& s ) {
+    uint16_t n;
+    if( ! get( p, end, &n, 2 ) || size_t( end - p ) < n ) {
+        return false;
+    }
+    s.assign( reinterpret_cast<const char *>( p ), n );
+    p += n;
+    return true;
+}
+
+/**
+ * @brief StateSnapshot::encode serializes the state into 'buf' in host
+ * byte order: u8 mode, u8 inpmode, u8 err, u8 countdown running, u8
+ * precision, i64 wall-clock deadline in msec if running or else remaining
+ * msec, u8 length and chars of bufNumber and of bufTime, u16 count and
+ * operands, u16 count and i32 of operator stack. Operands are exact: a
+ * double in Double precision, i32 scale and u16 length and digits of the
+ * unscaled value in Big precision, and in Fraction precision u8 0 and i64
+ * numerator and denominator, or u8 1 and u16 length and digits of both if
+ * they exceed 18 digits.
+ * @param buf payload of a slot.
+ * @return length of payload, 0 if it does not fit.
+ */
+uint32_t StateSnapshot::encode( uint8_t *buf ) const {
+    if( input.bufNumber.length() > 255 || input.bufTime.length() > 255 ) {
+        return 0;
+    }
+    const uint8_t *end = buf + sizeof( Slot::payload );
+    Countdown& timer = input.timer;
+    Calculator::Precision precision = alu.getPrecision();
+    uint8_t head[] = { uint8_t( input.mode ), uint8_t( input.inpmode_ ), uint8_t( input.err ),
+                       uint8_t( timer.isRunning() ), uint8_t( precision ) };
+    int64_t t = int64_t( timer.isRunning()? wallMsec() + timer.remaining() : timer.remaining() );
+    uint8_t numberLength = uint8_t( input.bufNumber.length() ), timeLength = uint8_t( input.bufTime.length() );
+    uint8_t *p = buf;
+    bool ok = put( p, end, head, 5 ) && put( p, end, &t, 8 )
+        && put( p, end, &numberLength, 1 ) && put( p, end, input.bufNumber.data(), numberLength )
+        && put( p, end, &timeLength, 1 ) && put( p, end, input.bufTime.data(), timeLength );
+
+    if( precision == Calculator::Big ) {
+        const vector<BigDecimal> big = alu.bigSt.elements();
+        uint16_t count = uint16_t( big.size() );
+        ok = ok && big.size() <= UINT16_MAX && put( p, end, &count, 2 );
+        for( size_t i=0; ok && i < big.size(); i++ ) {
+            int32_t scale = big[i].getScale();
+            ok = put( p, end, &scale, 4 ) && putText( p, end, big[i].getUnscaled().toString() );
+        }
+    } else if( precision == Calculator::Fraction ) {
+        const vector<Rational> rat = alu.ratSt.elements();
+        uint16_t count = uint16_t( rat.size() );
+        ok = ok && rat.size() <= UINT16_MAX && put( p, end, &count, 2 );
+        for( size_t i=0; ok && i < rat.size(); i++ ) {
+            BigInt num, den;
+            rat[i].parts( num, den );
+            uint8_t kind = num.isSmall() && den.isSmall()? 0 : 1;
+            if( kind == 0 ) {
+                int64_t n = num.toInt64(), d = den.toInt64();
+                ok = put( p, end, &kind, 1 ) && put( p, end, &n, 8 ) && put( p, end, &d, 8 );
+            } else {
+                ok = put( p, end, &kind, 1 ) && putText( p, end, num.toString() ) && putText( p, end, den.toString() );
+            }
+        }
+    } else {
+        const vector<double> operands = alu.operandSt.elements();
+        uint16_t count = uint16_t( operands.size() );
+        ok = ok && operands.size() <= UINT16_MAX && put( p, end, &count, 2 )
+                && put( p, end, operands.data(), operands.size() * 8 );
+    }
+
+    const vector<int> ops = alu.opSt.elements();
+    uint16_t count = uint16_t( ops.size() );
+    ok = ok && ops.size() <= UINT16_MAX && put( p, end, &count, 2 );
+    for( size_t i=0; ok && i < ops.size(); i++ ) {
+        int32_t op = ops[i];
+        ok = put( p, end, &op, 4 );
+    }
+    return ok? uint32_t( p - buf ) : 0;
+}
+
+/**
+ * @brief StateSnapshot::decode validates a payload and applies it.
+ * Operands saved in another precision than the current one are converted
+ * via double. A countdown whose deadline has passed while the application
+ * was down expires immediately.
+ * @param buf payload of a slot.
+ * @param length of payload.
+ * @return false if the payload is malformed.
+ */
+bool StateSnapshot::decode( const uint8_t *buf, uint32_t length ) {
+    const uint8_t *p = buf, *end = buf + length;
+    uint8_t head[5], len;
+    int64_t t;
+    if( ! get( p, end, head, 5 ) || head[0] >= InputProcessor::MODES || head[1] > 1 || head[2] > 1
+        || head[3] > 1 || head[4] > Calculator::Fraction || ! get( p, end, &t, 8 ) ) {
+        return false;
+    }
+    bool running = head[3] != 0;
+    Calculator::Precision saved = Calculator::Precision( head[4] );
+    string bufNumber, bufTime;
+    if( ! get( p, end, &len, 1 ) || size_t( end - p ) < len ) {
+        return false;
+    }
+    bufNumber.assign( reinterpret_cast<const char *>( p ), len );
+    p += len;
+    if( ! get( p, end, &len, 1 ) || size_t( end - p ) < len ) {
+        return false;
+    }
+    bufTime.assign( reinterpret_cast<const char *>( p ), len );
+    p += len;
+
+    vector<double> operands;
+    vector<BigDecimal> big;
+    vector<Rational> rat;
+    uint16_t count;
+    if( ! get( p, end, &count, 2 ) ) {
+        return false;
+    }
+    try {
+        for( unsigned i=0; i < count; i++ ) {
+            if( saved == Calculator::Big ) {
+                int32_t scale;
+                string digits;
+                if( ! get( p, end, &scale, 4 ) || ! getText( p, end, digits ) ) {
+                    return false;
+                }
+                big.push_back( BigDecimal( BigInt::parse( digits ), scale ) );
+            } else if( saved == Calculator::Fraction ) {
+                uint8_t kind;
+                int64_t n, d;
+                string num, den;
+                if( ! get( p, end, &kind, 1 ) || kind > 1 ) {
+                    return false;
+                }
+                if( kind == 0? ! get( p, end, &n, 8 ) || ! get( p, end, &d, 8 )
+                             : ! getText( p, end, num ) || ! getText( p, end, den ) ) {
+                    return false;
+                }
+                rat.push_back( kind == 0? Rational::fromParts( BigInt( n ), BigInt( d ) )
+                                        : Rational::fromParts( BigInt::parse( num ), BigInt::parse( den ) ) );
+            } else {
+                double d;
+                if( ! get( p, end, &d, 8 ) ) {
+                    return false;
+                }
+                operands.push_back( d );
+            }
+        }
+    } catch( exception& ) {
+        return false;
+    }
+    if( ! get( p, end, &count, 2 ) || size_t( end - p ) != count * 4u ) {
+        return false;
+    }
+
+    Calculator::State state;
+    Calculator::Precision precision = alu.getPrecision();
+    if( precision != saved ) {
+        for( unsigned i=0; i < big.size(); i++ ) {
+            operands.push_back( big[i].toDouble() );
+        }
+        for( unsigned i=0; i < rat.size(); i++ ) {
+            operands.push_back( rat[i].toDouble() );
+        }
+        big.clear();
+        rat.clear();
+    }
+    for( unsigned i=0; i < big.size(); i++ ) {
+        state.bigOperands.push( big[i] );
+    }
+    for( unsigned i=0; i < rat.size(); i++ ) {
+        state.ratOperands.push( rat[i] );
+    }
+    for( unsigned i=0; i < operands.size(); i++ ) {
+        if( precision != Calculator::Double && ! std::isfinite( operands[i] ) ) {
+            return false;
+        }
+        if( precision == Calculator::Big ) {
+            state.bigOperands.push( BigDecimal::fromDouble( operands[i] ) );
+        } else if( precision == Calculator::Fraction ) {
+            state.ratOperands.push( Rational::fromDouble( operands[i] ) );
+        } else {
+            state.operands.push( operands[i] );
+        }
+    }
+    for( unsigned i=0; i < count; i++, p += 4 ) {
+        int32_t op;
+        memcpy( &op, p, 4 );
+        state.ops.push( op );
+    }
+    if( bufNumber.empty() || bufTime.length() != 8 ) {
+        return false;
+    }
+
+    input.mode = InputProcessor::MODE( head[0] );
+    input.inpmode_ = head[1];
+    input.err = head[2] != 0;
+    input.bufNumber = bufNumber;
+    input.bufTime = bufTime;
+    alu.restore( state );
+    if( running ) {
+        int64_t now = int64_t( wallMsec() );
+        input.timer.start( uint64_t( t > now? t - now : 0 ) );
+    } else if( t > 0 ) {
+        input.timer.preset( uint64_t( t ) );
+    } else {
+        input.timer.reset();
+    }
+    return true;
+}
+
+
+/**
+ * @brief StateSnapshot::checksum is a 32-bit FNV-1a hash of the sequence
+ * number and payload of a slot.
+ */
+uint32_t StateSnapshot::checksum( uint64_t seq, const uint8_t *buf, uint32_t length ) {
+    uint32_t h = 2166136261u;
+    for( int i=0; i < 8; i++ ) {
+        h = ( h ^ uint8_t( seq >> ( 8 * i ) ) ) * 16777619u;
+    }
+    for( uint32_t i=0; i < length; i++ ) {
+        h = ( h ^ buf[i] ) * 16777619u;
+    }
+    return h;
+}
+
+bool StateSnapshot::isValid( const Slot& s ) const {
+    return s.magic == MAGIC && s.version == VERSION && s.seq > 0 && s.length <= sizeof( s.payload )
+        && s.checksum == checksum( s.seq, s.payload, s.length );
+}
+
+
+/**
+ * @brief StateSnapshot::expired flushes batched saves.
+ */
+void StateSnapshot::expired() {
+    flush();
+}
+
+/**
+ * @brief StateSnapshot::flush writes modified pages of the mapping to disk.
+ */
+void StateSnapshot::flush() {
+    dirty = false;
+    if( msync( pages, 2 * SLOT_SIZE, MS_SYNC ) < 0 ) {
+        cerr << "cannot flush snapshot " << path << ": " << strerror( errno ) << endl;
+    }
+}
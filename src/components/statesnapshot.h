@@ -0,0 +1,118 @@
+#ifndef STATESNAPSHOT_H
+#define STATESNAPSHOT_H
+
+#include <iostream>
+#include <cstdint>
+#include "pubsub.h"
+#include "timerwheel.h"
+class InputProcessor;
+class Calculator;
+using namespace std;
+
+
+/**
+ * @brief The StateSnapshot class keeps a compact binary snapshot of the
+ * logical state in a memory-mapped file (Linux only), from which the state
+ * is restored after a crash or power cycle: the operand and operator stacks
+ * of Calculator, buffers and modes of InputProcessor and the countdown of
+ * TimerMode, whose deadline is kept as wall-clock time such that it also
+ * runs down while the application is down. Operands are saved exactly in
+ * the precision of Calculator. Statistics of StatisticsMode do not fit a
+ * slot and are not saved.
+ *
+ * The file holds two slots of one page each. A snapshot is written to the
+ * slot not holding the latest snapshot and becomes valid with its sequence
+ * number and checksum, such that a torn write leaves the previous snapshot
+ * intact. restore() picks the valid slot with the highest sequence number.
+ *
+ * StateSnapshot subscribes to input events and control messages and saves
+ * after each of them if the state has changed. Saving copies a few hundred
+ * bytes into the mapping, which survives a crash of the process. Pages are
+ * flushed to disk on each save or, if 'syncMsec' is set, batched once per
+ * period on the timer wheel.
+ */
+class StateSnapshot : public SubscriberIntf, private TimerWheel::Entry {
+
+  public:
+    /**
+     * @brief StateSnapshot constructor opens or creates and maps the file.
+     * @param path of snapshot file.
+     * @param input InputProcessor whose state is saved.
+     * @param alu Calculator whose stacks are saved.
+     * @param syncMsec delay of batched flushes, 0 to flush each save.
+     * @param wheel timer wheel driving batched flushes.
+     * @throws runtime_error if the file cannot be opened or mapped.
+     */
+    StateSnapshot( const string path, InputProcessor& input, Calculator& alu, int syncMsec = 0,
+                   TimerWheel& wheel = TimerWheel::getInstance() );
+    ~StateSnapshot();
+
+    /**
+     * @brief notify method inherited from SubscriberIntf saves the state
+     * after an input event or control message.
+     * @param e event.
+     */
+    void notify( XEvent& e );
+
+    /**
+     * @brief save writes the state to the next slot, unless it equals the
+     * last snapshot.
+     * @return false if the state does not fit into a slot.
+     */
+    bool save();
+
+    /**
+     * @brief restore applies the latest valid snapshot to InputProcessor,
+     * Calculator and the countdown.
+     * @return false if the file holds no valid snapshot.
+     */
+    bool restore();
+
+    uint64_t getSaves() const { return saves; }
+
+  private:
+    StateSnapshot( const StateSnapshot& ) = delete;
+    StateSnapshot& operator=( const StateSnapshot& ) = delete;
+
+    static const uint32_t SLOT_SIZE = 4096;
+    static const uint32_t MAGIC = 0x53453253;       // "SE2S"
+    static const uint32_t VERSION = 2;
+
+    struct Slot {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t seq;                   // written last, 0 for an empty slot
+        uint32_t length;                // bytes of payload
+        uint32_t checksum;              // of seq and payload
+        uint8_t payload[ SLOT_SIZE - 24 ];
+    };
+
+    /**
+     * @brief encode serializes the state into 'buf', decode() applies it.
+     * @return length of payload, 0 if it does not fit.
+     */
+    uint32_t encode( uint8_t *buf ) const;
+    bool decode( const uint8_t *buf, uint32_t length );
+
+    static uint32_t checksum( uint64_t seq, const uint8_t *buf, uint32_t length );
+    bool isValid( const Slot& s ) const;
+
+    /**
+     * @brief expired is invoked by the timer wheel to flush batched saves.
+     */
+    void expired();
+    void flush();
+
+    const string path;
+    InputProcessor& input;
+    Calculator& alu;
+    const int syncMsec;
+    TimerWheel& wheel;
+
+    Slot *pages = nullptr;              // two slots mapped from the file
+    uint64_t seq = 0;                   // sequence number of latest snapshot
+    bool dirty = false;                 // saved, but not flushed
+    uint64_t saves = 0;
+};
+
+#endif // STATESNAPSHOT_H
@@ -0,0 +1,48 @@
+#include <fstream>
+#include <cstdio>
+#include "statsdumper.h"
+#include "controllerintf.h"
+
+
+/**
+ * @brief StatsDumper::start writes the file and schedules periodic writes.
+ */
+void StatsDumper::start() {
+    if( ! dump() ) {
+        cerr << "cannot write stats file " << path << endl;
+    }
+    wheel.schedule( *this, uint64_t( msec ) );
+}
+
+/**
+ * @brief StatsDumper::expired writes the file and schedules the next
+ * period relative to this expiry.
+ */
+void StatsDumper::expired() {
+    dump();
+    wheel.scheduleAt( *this, getExpiry() + uint64_t( msec ) );
+}
+
+/**
+ * @brief StatsDumper::dump writes snapshots of all controllers to a
+ * temporary file, which then replaces the stats file.
+ * @return false if the file could not be written.
+ */
+bool StatsDumper::dump() {
+    string tmp = path + ".tmp";
+    ofstream out( tmp.c_str(), ios::out | ios::trunc );
+    if( ! out ) {
+        return false;
+    }
+    for( int c=0; c < ControllerStats::COUNTERS; c++ ) {
+        const char *name = ControllerStats::name( ControllerStats::Counter( c ) );
+        bool gauge = c == ControllerStats::StateNsec || c == ControllerStats::RestartNsec;
+        out << "# TYPE calculator_" << name << ( gauge? " gauge" : " counter" ) << "\n";
+        for( vector<ControllerIntf *>::const_iterator it = controllers.begin(); it != controllers.end(); it++ ) {
+            ControllerStats::Snapshot s = ( *it )->stats();
+            out << "calculator_" << name << "{controller=\"" << s.controller << "\"} " << s.values[c] << "\n";
+        }
+    }
+    out.close();
+    return ! out.fail() && rename( tmp.c_str(), path.c_str() ) == 0;
+}
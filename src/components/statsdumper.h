@@ -0,0 +1,61 @@
+#ifndef STATSDUMPER_H
+#define STATSDUMPER_H
+
+#include <iostream>
+#include <vector>
+#include "timerwheel.h"
+class ControllerIntf;
+using namespace std;
+
+
+/**
+ * @brief The StatsDumper class periodically writes the statistics of
+ * controllers to a stats file, from which monitoring can scrape them.
+ *
+ * The file uses the Prometheus text format with one line per counter and
+ * controller, e.g. calculator_events{controller="InputProcessor"} 42.
+ * It is written to a temporary file first and renamed, such that readers
+ * never see a partially written file. The dumper is driven by a timer
+ * wheel on the thread that runs the controllers.
+ */
+class StatsDumper : private TimerWheel::Entry {
+
+  public:
+    /**
+     * @brief StatsDumper constructor.
+     * @param path of stats file.
+     * @param controllers whose statistics are written.
+     * @param msec period of writing the file.
+     * @param wheel timer wheel driving the dumper.
+     */
+    StatsDumper( const string path, const vector<ControllerIntf *>& controllers, int msec = 1000,
+                 TimerWheel& wheel = TimerWheel::getInstance() )
+        : path( path ), controllers( controllers ), msec( msec ), wheel( wheel ) {}
+    ~StatsDumper() {}
+
+    /**
+     * @brief start writes the file and schedules periodic writes, stop()
+     * cancels them.
+     */
+    void start();
+    void stop() { wheel.cancel( *this ); }
+
+    /**
+     * @brief dump writes the stats file once.
+     * @return false if the file could not be written.
+     */
+    bool dump();
+
+  private:
+    /**
+     * @brief expired is invoked by the timer wheel each period.
+     */
+    void expired();
+
+    const string path;
+    const vector<ControllerIntf *> controllers;
+    const int msec;
+    TimerWheel& wheel;
+};
+
+#endif // STATSDUMPER_H
@@ -0,0 +1,137 @@
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "vattable.h"
+
+
+/**
+ * @brief fields splits the line [s, end) at blanks, tabs and '\r'.
+ */
+static vector<string> fields( const char *s, const char *end ) {
+    vector<string> f;
+    while( s < end ) {
+        while( s < end && ( *s == ' ' || *s == '\t' || *s == '\r' ) ) {
+            s++;
+        }
+        const char *b = s;
+        while( s < end && *s != ' ' && *s != '\t' && *s != '\r' ) {
+            s++;
+        }
+        if( s > b ) {
+            f.push_back( string( b, size_t( s - b ) ) );
+        }
+    }
+    return f;
+}
+
+/**
+ * @brief intern returns the index of a name, which is appended if new.
+ */
+static size_t intern( unordered_map<string, size_t>& index, vector<string>& names, const string& name ) {
+    auto it = index.find( name );
+    if( it != index.end() ) {
+        return it->second;
+    }
+    index[ name ] = names.size();
+    names.push_back( name );
+    return names.size() - 1;
+}
+
+
+/**
+ * @brief VatTable constructor maps the file read-only and parses it in
+ * place. Rates are parsed into their precomputed factors once, here.
+ * @param path of rate file.
+ * @throws runtime_error if the file cannot be read, invalid_argument if
+ * a line is malformed or a rate is missing or defined twice.
+ */
+VatTable::VatTable( const string& path ) {
+    int fd = open( path.c_str(), O_RDONLY );
+    struct stat st;
+    if( fd < 0 || fstat( fd, &st ) < 0 || st.st_size == 0 ) {
+        if( fd >= 0 ) {
+            ::close( fd );
+        }
+        throw runtime_error( "cannot read VAT table: " + path );
+    }
+    size_t length = size_t( st.st_size );
+    void *p = mmap( nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0 );
+    ::close( fd );
+    if( p == MAP_FAILED ) {
+        throw runtime_error( "cannot map VAT table " + path + ": " + strerror( errno ) );
+    }
+
+    struct Entry {
+        size_t region;
+        size_t category;
+        string percent;
+        unsigned line;
+    };
+    vector<Entry> entries;
+    const char *s = static_cast<const char *>( p ), *end = s + length;
+    for( unsigned line = 1; s < end; line++ ) {
+        const char *eol = static_cast<const char *>( memchr( s, '\n', size_t( end - s ) ) );
+        if( eol == nullptr ) {
+            eol = end;
+        }
+        const char *hash = static_cast<const char *>( memchr( s, '#', size_t( eol - s ) ) );
+        vector<string> f = fields( s, hash != nullptr? hash : eol );      // comments run to the end of the line
+        s = eol + 1;
+        if( f.empty() ) {
+            continue;
+        }
+        if( f.size() != 3 ) {
+            munmap( p, length );
+            throw invalid_argument( path + ":" + to_string( line ) + ": expected region, category and rate" );
+        }
+        entries.push_back( Entry{ intern( regionIndex, regionNames, f[0] ),
+                                  intern( categoryIndex, categoryNames, f[1] ), f[2], line } );
+    }
+    munmap( p, length );
+    if( entries.empty() ) {
+        throw invalid_argument( "no VAT rates in " + path );
+    }
+
+    table.resize( regions() * categories() );
+    vector<bool> defined( table.size() );
+    for( const Entry& e : entries ) {
+        size_t i = e.region * categories() + e.category;
+        string at = path + ":" + to_string( e.line ) + ": ";
+        if( defined[i] ) {
+            throw invalid_argument( at + "rate defined twice" );
+        }
+        try {
+            table[i] = Calculator::VatRate::parse( e.percent );
+        } catch( exception& ) {
+            throw invalid_argument( at + "invalid rate " + e.percent );
+        }
+        defined[i] = true;
+    }
+    for( size_t i=0; i < table.size(); i++ ) {
+        if( ! defined[i] ) {
+            throw invalid_argument( "no VAT rate for " + regionNames[ i / categories() ] + " " +
+                                    categoryNames[ i % categories() ] + " in " + path );
+        }
+    }
+}
+
+
+size_t VatTable::region( const string& name ) const {
+    return indexOf( regionIndex, name, "region" );
+}
+
+size_t VatTable::category( const string& name ) const {
+    return indexOf( categoryIndex, name, "category" );
+}
+
+size_t VatTable::indexOf( const unordered_map<string, size_t>& index, const string& name, const char *what ) {
+    auto it = index.find( name );
+    if( it == index.end() ) {
+        throw invalid_argument( string( "unknown VAT " ) + what + ": " + name );
+    }
+    return it->second;
+}
@@ -0,0 +1,62 @@
+#ifndef VATTABLE_H
+#define VATTABLE_H
+
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include "calculator.h"
+using namespace std;
+
+
+/**
+ * @brief The VatTable class holds the VAT rates of product categories in
+ * regions, loaded once from a configuration file (Linux only).
+ *
+ * The file is mapped read-only and parsed in place. Each line holds a
+ * region, a category and a rate in percent separated by blanks, e.g.
+ * "DE food 7"; comments from '#' to the end of a line and empty lines
+ * are ignored. Every region must define a rate for every category. Names
+ * are resolved to indexes once, e.g. for command line options. Rates are stored as a
+ * dense region x category matrix of Calculator::VatRate, such that the
+ * rates of a region are one array a calculator selects from by category
+ * index in O(1).
+ */
+class VatTable {
+
+  public:
+    /**
+     * @brief VatTable constructor maps and parses the file.
+     * @param path of rate file.
+     * @throws runtime_error if the file cannot be read, invalid_argument
+     * if a line is malformed or a rate is missing or defined twice.
+     */
+    VatTable( const string& path );
+
+    size_t regions() const { return regionNames.size(); }
+    size_t categories() const { return categoryNames.size(); }
+
+    /**
+     * @brief region and category return the index of a name.
+     * @throws invalid_argument if there is no such name.
+     */
+    size_t region( const string& name ) const;
+    size_t category( const string& name ) const;
+
+    /**
+     * @brief rates returns the rates of all categories of a region.
+     * @param region index.
+     * @return array of categories() rates.
+     */
+    const Calculator::VatRate *rates( size_t region ) const { return &table[ region * categories() ]; }
+
+  private:
+    static size_t indexOf( const unordered_map<string, size_t>& index, const string& name, const char *what );
+
+    vector<string> regionNames;
+    vector<string> categoryNames;
+    unordered_map<string, size_t> regionIndex;
+    unordered_map<string, size_t> categoryIndex;
+    vector<Calculator::VatRate> table;      // rate of [ region ][ category ]
+};
+
+#endif // VATTABLE_H
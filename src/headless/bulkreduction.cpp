@@ -0,0 +1,185 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <stdexcept>
+#include "bulkreduction.h"
+
+static const size_t BATCH = 4096;       // numbers parsed at a time
+static const size_t LANES = 4;          // independent accumulators
+static const size_t BLOCK = 256;        // values multiplied before lanes are normalised
+
+
+/**
+ * @brief BulkReduction::reduce parses a chunk in batches and reduces them
+ * into the part of the chunk.
+ * @param chunk index of chunk.
+ * @param begin, end of chunk.
+ * @throws invalid_argument if a number is malformed.
+ */
+void BulkReduction::reduce( size_t chunk, const char *begin, const char *end ) {
+    double values[ BATCH ];
+    Part p;
+    size_t n;
+    while( ( n = file.parse( begin, end, values, BATCH ) ) > 0 ) {
+        if( op == Product ) {
+            multiply( p, values, n );
+        } else {
+            sum( p, values, n );
+        }
+        p.count += n;
+    }
+    parts[ chunk ] = p;
+}
+
+/**
+ * @brief BulkReduction::sum adds values in LANES independent Neumaier
+ * sums, which do not wait for each other's additions, and adds the lanes
+ * to the part.
+ */
+void BulkReduction::sum( Part& p, const double *x, size_t len ) const {
+    double s[ LANES ] = { 0, 0, 0, 0 }, c[ LANES ] = { 0, 0, 0, 0 };
+    size_t i = 0;
+    for( ; i + LANES <= len; i += LANES ) {
+        for( size_t j=0; j < LANES; j++ ) {
+            double t = s[j] + x[ i + j ];
+            c[j] += fabs( s[j] ) >= fabs( x[ i + j ] )? ( s[j] - t ) + x[ i + j ] : ( x[ i + j ] - t ) + s[j];
+            s[j] = t;
+        }
+    }
+    for( ; i < len; i++ ) {
+        double t = s[0] + x[i];
+        c[0] += fabs( s[0] ) >= fabs( x[i] )? ( s[0] - t ) + x[i] : ( x[i] - t ) + s[0];
+        s[0] = t;
+    }
+    for( size_t j=0; j < LANES; j++ ) {
+        Part lane;
+        lane.sum = s[j];
+        lane.error = c[j];
+        p.combine( lane );
+    }
+}
+
+/**
+ * @brief BulkReduction::multiply multiplies values into LANES products
+ * of mantissas in [1, 2) and sums of exponents, which are taken from the
+ * bits of normal numbers. Zeros, infinities and NaNs are multiplied into
+ * the special factor, subnormals are split by frexp(). The lanes, which
+ * stay below 2^(BLOCK / LANES), are multiplied into the part after each
+ * BLOCK values.
+ */
+void BulkReduction::multiply( Part& p, const double *x, size_t len ) const {
+    const uint64_t EXP = uint64_t( 0x7ff ) << 52;
+    for( size_t b = 0; b < len; b += BLOCK ) {
+        size_t k = len - b < BLOCK? len - b : BLOCK;
+        double m[ LANES ] = { 1, 1, 1, 1 };
+        int64_t e[ LANES ] = { 0, 0, 0, 0 };
+        for( size_t i=0; i < k; i++ ) {
+            double v = x[ b + i ];
+            uint64_t bits;
+            memcpy( &bits, &v, 8 );
+            uint64_t be = ( bits & EXP ) >> 52;
+            if( be != 0 && be != 0x7ff ) {
+                bits = ( bits & ~EXP ) | ( uint64_t( 1023 ) << 52 );
+                double f;
+                memcpy( &f, &bits, 8 );
+                m[ i % LANES ] *= f;
+                e[ i % LANES ] += int64_t( be ) - 1023;
+            } else if( v == 0 || ! isfinite( v ) ) {
+                p.special *= v;
+            } else {
+                int n;
+                m[ i % LANES ] *= 2 * frexp( v, &n );
+                e[ i % LANES ] += n - 1;
+            }
+        }
+        for( size_t j=0; j < LANES; j++ ) {
+            Part lane;
+            lane.mantissa = m[j];
+            lane.exponent = e[j];
+            p.combine( lane );
+        }
+    }
+}
+
+/**
+ * @brief BulkReduction::Part::combine accumulates the part of the
+ * following numbers: the sums are added by Neumaier's step, the products
+ * multiplied and the mantissa normalised to [1, 2).
+ */
+void BulkReduction::Part::combine( const Part& o ) {
+    count += o.count;
+    double t = sum + o.sum;
+    error += fabs( sum ) >= fabs( o.sum )? ( sum - t ) + o.sum : ( o.sum - t ) + sum;
+    error += o.error;
+    sum = t;
+    int k;
+    mantissa = 2 * frexp( mantissa * o.mantissa, &k );
+    exponent += o.exponent + k - 1;
+    special *= o.special;
+}
+
+/**
+ * @brief BulkReduction::combine combines the parts of chunks [begin, end)
+ * pairwise: both halves are combined first, then with each other.
+ */
+BulkReduction::Part BulkReduction::combine( size_t begin, size_t end ) const {
+    if( end - begin <= 1 ) {
+        return begin < end? parts[ begin ] : Part();
+    }
+    size_t mid = begin + ( end - begin ) / 2;
+    Part p = combine( begin, mid );
+    p.combine( combine( mid, end ) );
+    return p;
+}
+
+
+/**
+ * @brief BulkReduction::run reduces a file of numbers and prints the sum,
+ * product or mean. A product beyond the range of double is printed with
+ * its decimal exponent, which is computed from the binary one in long
+ * double.
+ * @param path of file.
+ * @param op reduction.
+ * @param threads number of threads, 0 for one per core.
+ * @return exit code.
+ */
+int BulkReduction::run( const string& path, Op op, unsigned threads ) {
+    char line[ 160 ];
+    try {
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        NumberFile file( path );
+        BulkReduction reduction( file, op );
+        file.forChunks( threads, reduction );
+        Part p = reduction.getTotal();
+        double sec = chrono::duration<double>( chrono::steady_clock::now() - t0 ).count();
+        if( op == Mean && p.count == 0 ) {
+            throw invalid_argument( "no numbers in " + path );
+        }
+
+        sprintf( line, "Reduce: %llu numbers, %.1f MB in %zu chunks reduced in %.1f ms (%.2f GB/s).",
+                 (unsigned long long) p.count, file.size() / 1e6, file.chunks(), sec * 1e3,
+                 sec > 0? file.size() / 1e9 / sec : 0.0 );
+        cout << line << endl;
+        if( op == Sum ) {
+            sprintf( line, "  sum %.15g", p.sum + p.error );
+        } else if( op == Mean ) {
+            sprintf( line, "  mean %.15g", ( p.sum + p.error ) / double( p.count ) );
+        } else if( p.special != 1.0 ) {
+            sprintf( line, "  product %.15g", p.special * copysign( 1.0, p.mantissa ) );
+        } else if( p.exponent >= -1074 && p.exponent <= 1023 ) {
+            sprintf( line, "  product %.15g", ldexp( p.mantissa, int( p.exponent ) ) );
+        } else {
+            long double l = log10l( fabsl( p.mantissa ) ) + p.exponent * log10l( 2.0L );
+            long double e10 = floorl( l );
+            sprintf( line, "  product %s%.8Lge%+lld", p.mantissa < 0? "-" : "",
+                     powl( 10.0L, l - e10 ), (long long) e10 );
+        }
+        cout << line << endl;
+
+    } catch( exception& e ) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+#ifndef BULKREDUCTION_H
+#define BULKREDUCTION_H
+
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include "numberfile.h"
+using namespace std;
+
+
+/**
+ * @brief BulkReduction sums, multiplies or averages a file of numbers,
+ * e.g. hundreds of millions of operands, in double arithmetic as the
+ * calculator in Double precision (Linux only).
+ *
+ * Each chunk of the file is reduced on its own into a Part: the sum is
+ * compensated (Neumaier), the product is carried as mantissa and separate
+ * binary exponent, such that it neither overflows nor underflows. Parts
+ * are combined pairwise in a fixed tree over the chunks after all chunks
+ * are reduced, such that results are identical for any number of threads
+ * and the rounding error of the combination grows with log(chunks).
+ */
+class BulkReduction : public NumberFile::ReducerIntf {
+
+  public:
+    enum Op { Sum, Product, Mean };
+
+    /**
+     * @brief Part is the reduction of a chunk or of consecutive chunks.
+     * The product is special * mantissa * 2^exponent, where special is 1
+     * or the product of zeros, infinities and NaNs.
+     */
+    struct Part {
+        uint64_t count = 0;
+        double sum = 0.0;
+        double error = 0.0;         // compensation of sum
+        double mantissa = 1.0;      // magnitude in [1, 2)
+        int64_t exponent = 0;
+        double special = 1.0;
+
+        void combine( const Part& o );
+    };
+
+    BulkReduction( const NumberFile& file, Op op )
+      : file( file ), op( op ), parts( file.chunks() ) {}
+
+    /**
+     * @brief reduce method inherited from NumberFile::ReducerIntf
+     * reduces the numbers of a chunk into its Part.
+     */
+    virtual void reduce( size_t chunk, const char *begin, const char *end );
+
+    /**
+     * @brief getTotal combines the parts of all chunks pairwise.
+     */
+    Part getTotal() const { return combine( 0, parts.size() ); }
+
+    /**
+     * @brief run reduces a file of numbers and prints the result and the
+     * throughput. Invoked from main() for option --reduce.
+     * @param path of file.
+     * @param op reduction.
+     * @param threads number of threads, 0 for one per core.
+     * @return exit code.
+     */
+    static int run( const string& path, Op op, unsigned threads );
+
+  private:
+    void sum( Part& p, const double *x, size_t len ) const;
+    void multiply( Part& p, const double *x, size_t len ) const;
+    Part combine( size_t begin, size_t end ) const;
+
+    const NumberFile& file;
+    Op op;
+    vector<Part> parts;             // written by one thread per chunk
+};
+
+#endif // BULKREDUCTION_H
@@ -0,0 +1,251 @@
+#include "executor.h"
+#include "session.h"
+#include "clock.h"
+
+
+SessionExecutor::ListenerIntf::~ListenerIntf() {}
+
+
+/**
+ * @brief SessionExecutor constructor creates workers and shards. Shards
+ * are assigned to home workers round-robin.
+ * @param workers number of worker threads, 0 for one per core.
+ * @param shards number of shards, 0 for 4 per worker.
+ * @param queueSize capacity of the event queue of a shard.
+ */
+SessionExecutor::SessionExecutor( unsigned workers, unsigned shards, size_t queueSize ) : running( false ) {
+    if( workers == 0 ) {
+        workers = thread::hardware_concurrency();
+        workers = workers > 0? workers : 1;
+    }
+    if( shards == 0 ) {
+        shards = 4 * workers;
+    }
+    for( unsigned i=0; i < workers; i++ ) {
+        this->workers.push_back( new Worker( i, shards ) );
+    }
+    for( unsigned i=0; i < shards; i++ ) {
+        Shard *s = new Shard( i % workers, queueSize );
+        this->shards.push_back( s );
+        this->workers[ s->home ]->home.push_back( s );
+    }
+}
+
+SessionExecutor::~SessionExecutor() {
+    stop();
+    // sessions first, their countdowns are pending at the shards' wheels
+    for( vector<Session *>::iterator it = sessions.begin(); it != sessions.end(); it++ ) {
+        delete *it;
+    }
+    for( vector<Shard *>::iterator it = shards.begin(); it != shards.end(); it++ ) {
+        delete *it;
+    }
+    for( vector<Worker *>::iterator it = workers.begin(); it != workers.end(); it++ ) {
+        delete *it;
+    }
+}
+
+
+/**
+ * @brief SessionExecutor::addSession creates a session in the next shard
+ * (round-robin) with countdowns on the shard's wheel.
+ * @param name of session.
+ * @param mirror optional backend rendered frames are passed to.
+ * @return index of session.
+ */
+unsigned SessionExecutor::addSession( const string name, DisplayBackendIntf *mirror ) {
+    unsigned index = unsigned( sessions.size() );
+    Shard *s = shards[ index % shards.size() ];
+    sessions.push_back( new Session( name, s->wheel, mirror ) );
+    return index;
+}
+
+
+/**
+ * @brief SessionExecutor::start starts the worker threads.
+ */
+void SessionExecutor::start() {
+    if( running ) {
+        return;
+    }
+    running = true;
+    for( vector<Worker *>::iterator it = workers.begin(); it != workers.end(); it++ ) {
+        ( *it )->t = thread( &SessionExecutor::work, this, ref( **it ) );
+    }
+}
+
+/**
+ * @brief SessionExecutor::stop waits until all submitted events have been
+ * processed and stops the worker threads. Pending countdowns are kept,
+ * but not advanced until the next start().
+ */
+void SessionExecutor::stop() {
+    if( ! running ) {
+        return;
+    }
+    running = false;
+    for( vector<Worker *>::iterator it = workers.begin(); it != workers.end(); it++ ) {
+        lock_guard<mutex> l( ( *it )->lock );
+        ( *it )->wakeup.notify_one();
+    }
+    for( vector<Worker *>::iterator it = workers.begin(); it != workers.end(); it++ ) {
+        ( *it )->t.join();
+    }
+}
+
+
+/**
+ * @brief SessionExecutor::submit appends an input event to the queue of
+ * the session's shard. If the shard is not owned yet, the submitting
+ * thread takes ownership on behalf of the home worker and queues the
+ * shard there.
+ * @param session index of session.
+ * @param key input event as GuiFacade::KeyEvt.
+ * @param stamp passed to the listener.
+ * @return false if the event queue of the shard is full.
+ */
+bool SessionExecutor::submit( unsigned session, int key, uint64_t stamp ) {
+    Shard& s = *shards[ session % shards.size() ];
+    Event e = { session, uint8_t( key ), stamp };
+    if( ! s.events.push( e ) ) {
+        return false;
+    }
+    // pairs with the fence in run() after the shard has been released
+    atomic_thread_fence( memory_order_seq_cst );
+    if( ! s.owned.load( memory_order_relaxed ) && ! s.owned.exchange( true ) ) {
+        Worker& h = *workers[ s.home ];
+        h.ready.push( &s );         // never full, a shard is queued at most once
+        wake( h );
+    }
+    return true;
+}
+
+
+SessionExecutor::Stats SessionExecutor::getStats( unsigned worker ) const {
+    Stats stats;
+    stats.events = workers[ worker ]->events.load( memory_order_relaxed );
+    stats.steals = workers[ worker ]->steals.load( memory_order_relaxed );
+    return stats;
+}
+
+
+/**
+ * @brief SessionExecutor::work is the loop of a worker thread. A worker
+ * runs the shards queued at it, then the shards with affinity whose
+ * countdowns are due. Without own work, it tries to steal a queued shard
+ * from another worker and finally sleeps until woken up, the next
+ * countdown is due or IDLE_MSEC have passed. After stop(), the worker
+ * terminates once it has found no more work.
+ * @param w worker.
+ */
+void SessionExecutor::work( Worker& w ) {
+    MonotonicClock& clock = MonotonicClock::getInstance();
+    for( ;; ) {
+        bool busy = false;
+        Shard *s;
+        for( size_t i=0; i < shards.size() && w.ready.pop( s ); i++ ) {
+            run( w, *s );
+            busy = true;
+        }
+
+        uint64_t now = clock.now();
+        uint64_t next = UINT64_MAX;
+        for( vector<Shard *>::iterator it = w.home.begin(); it != w.home.end(); it++ ) {
+            uint64_t due = ( *it )->due.load( memory_order_relaxed );
+            if( due > now ) {
+                next = due < next? due : next;
+            } else if( ! ( *it )->owned.load( memory_order_relaxed ) && ! ( *it )->owned.exchange( true ) ) {
+                run( w, **it );
+                busy = true;
+            }
+        }
+        if( busy || steal( w ) ) {
+            continue;
+        }
+        if( ! running ) {
+            break;
+        }
+
+        unique_lock<mutex> l( w.lock );
+        w.sleeping.store( true, memory_order_relaxed );
+        atomic_thread_fence( memory_order_seq_cst );
+        if( w.ready.empty() && running ) {
+            uint64_t msec = next > now && next - now < uint64_t( IDLE_MSEC )? next - now : uint64_t( IDLE_MSEC );
+            w.wakeup.wait_for( l, chrono::milliseconds( msec ) );
+        }
+        w.sleeping.store( false, memory_order_relaxed );
+    }
+}
+
+/**
+ * @brief SessionExecutor::run processes the events of an owned shard in
+ * batches and advances its timer wheel. After a full batch, the shard is
+ * queued again at its home worker to give other shards a turn. Otherwise,
+ * the shard is released. Events submitted concurrently are either seen
+ * after the release or their submitter takes ownership.
+ * @param w worker running the shard.
+ * @param s shard owned by the worker.
+ */
+void SessionExecutor::run( Worker& w, Shard& s ) {
+    uint64_t n = 0;
+    for( ;; ) {
+        Event e;
+        unsigned i = 0;
+        while( i < BATCH && s.events.pop( e ) ) {
+            sessions[ e.session ]->publish( e.key );
+            if( listener != nullptr ) {
+                listener->processed( w.id, e.session, e.stamp );
+            }
+            i++;
+        }
+        n += i;
+        if( s.wheel.size() > 0 ) {
+            s.wheel.advance();
+        }
+        s.due.store( s.wheel.size() > 0? s.wheel.nextExpiry() : UINT64_MAX, memory_order_relaxed );
+
+        if( i == BATCH ) {
+            Worker& h = *workers[ s.home ];
+            h.ready.push( &s );
+            wake( h );
+            break;
+        }
+        s.owned.store( false, memory_order_release );    // publishes session state to next owner
+        atomic_thread_fence( memory_order_seq_cst );
+        if( s.events.empty() || s.owned.load( memory_order_relaxed ) || s.owned.exchange( true ) ) {
+            break;
+        }
+    }
+    w.events.store( w.events.load( memory_order_relaxed ) + n, memory_order_relaxed );
+}
+
+/**
+ * @brief SessionExecutor::steal takes a queued shard from the next worker
+ * that has one and runs it.
+ * @param w stealing worker.
+ * @return true if a shard has been stolen.
+ */
+bool SessionExecutor::steal( Worker& w ) {
+    size_t n = workers.size();
+    for( size_t i=1; i < n; i++ ) {
+        Shard *s;
+        if( workers[ ( w.id + i ) % n ]->ready.pop( s ) ) {
+            w.steals.store( w.steals.load( memory_order_relaxed ) + 1, memory_order_relaxed );
+            run( w, *s );
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief SessionExecutor::wake wakes up a worker if it sleeps.
+ * @param w worker.
+ */
+void SessionExecutor::wake( Worker& w ) {
+    atomic_thread_fence( memory_order_seq_cst );
+    if( w.sleeping.load( memory_order_relaxed ) ) {
+        lock_guard<mutex> l( w.lock );
+        w.wakeup.notify_one();
+    }
+}
@@ -0,0 +1,251 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "timerwheel.h"
+class Session;
+class DisplayBackendIntf;
+using namespace std;
+
+
+/**
+ * @brief MpmcQueue is a bounded lock-free multi-producer/multi-consumer
+ * FIFO queue. Each cell carries a sequence number that tells producers and
+ * consumers whether the cell is free or filled for their position, such
+ * that a push or pop costs a single compare-and-swap on the position.
+ */
+template <typename T>
+class MpmcQueue {
+
+  public:
+    /**
+     * @brief MpmcQueue constructor.
+     * @param capacity minimum number of elements, rounded up to a power of 2.
+     */
+    MpmcQueue( size_t capacity ) : enqueuePos( 0 ), dequeuePos( 0 ) {
+        size_t n = 2;
+        while( n < capacity ) {
+            n <<= 1;
+        }
+        mask = n - 1;
+        cells = new Cell[ n ];
+        for( size_t i=0; i < n; i++ ) {
+            cells[i].seq.store( i, memory_order_relaxed );
+        }
+    }
+    ~MpmcQueue() { delete[] cells; }
+
+    /**
+     * @brief push appends an element.
+     * @param e element.
+     * @return false if the queue is full.
+     */
+    bool push( const T& e ) {
+        size_t pos = enqueuePos.load( memory_order_relaxed );
+        for( ;; ) {
+            Cell& c = cells[ pos & mask ];
+            intptr_t dif = intptr_t( c.seq.load( memory_order_acquire ) ) - intptr_t( pos );
+            if( dif == 0 ) {
+                if( enqueuePos.compare_exchange_weak( pos, pos + 1, memory_order_relaxed ) ) {
+                    c.data = e;
+                    c.seq.store( pos + 1, memory_order_release );
+                    return true;
+                }
+            } else if( dif < 0 ) {
+                return false;
+            } else {
+                pos = enqueuePos.load( memory_order_relaxed );
+            }
+        }
+    }
+
+    /**
+     * @brief pop removes the oldest element.
+     * @param e element removed.
+     * @return false if the queue is empty.
+     */
+    bool pop( T& e ) {
+        size_t pos = dequeuePos.load( memory_order_relaxed );
+        for( ;; ) {
+            Cell& c = cells[ pos & mask ];
+            intptr_t dif = intptr_t( c.seq.load( memory_order_acquire ) ) - intptr_t( pos + 1 );
+            if( dif == 0 ) {
+                if( dequeuePos.compare_exchange_weak( pos, pos + 1, memory_order_relaxed ) ) {
+                    e = c.data;
+                    c.seq.store( pos + mask + 1, memory_order_release );
+                    return true;
+                }
+            } else if( dif < 0 ) {
+                return false;
+            } else {
+                pos = dequeuePos.load( memory_order_relaxed );
+            }
+        }
+    }
+
+    /**
+     * @brief empty returns true if no element is ready to be popped.
+     */
+    bool empty() const {
+        size_t pos = dequeuePos.load( memory_order_relaxed );
+        return cells[ pos & mask ].seq.load( memory_order_acquire ) != pos + 1;
+    }
+
+  private:
+    MpmcQueue( const MpmcQueue& ) = delete;
+    MpmcQueue& operator=( const MpmcQueue& ) = delete;
+
+    struct Cell {
+        atomic<size_t> seq;
+        T data;
+    };
+
+    Cell *cells;
+    size_t mask;
+    char pad0[ 64 ];
+    atomic<size_t> enqueuePos;      // producers and consumers on separate cache lines
+    char pad1[ 64 ];
+    atomic<size_t> dequeuePos;
+    char pad2[ 64 ];
+};
+
+
+/**
+ * @brief SessionExecutor processes input events of many independent
+ * sessions hosted in one process on a pool of worker threads, one per
+ * core by default.
+ *
+ * Sessions are grouped into shards. A shard has its own event queue and
+ * timer wheel for the countdowns of its sessions, and a home worker it is
+ * normally processed by (affinity). A shard is owned by at most one worker
+ * at a time, which keeps the events of a session in order and the timer
+ * wheel single-threaded. When a shard receives events, it is queued at its
+ * home worker. Idle workers steal queued shards from other workers, such
+ * that an overloaded worker is relieved. No global locks are taken: shard
+ * ownership is a flag, event and ready queues are lock-free. A worker only
+ * blocks on its own condition variable when idle.
+ *
+ * Events of one session must be submitted by one thread at a time. Sessions
+ * must be added before start(). stop() processes all submitted events.
+ */
+class SessionExecutor {
+
+  public:
+    /**
+     * @brief Abstract class that defines the interface of listeners that
+     * are notified by the worker that has processed an event.
+     */
+    class ListenerIntf {
+      public:
+        virtual ~ListenerIntf();
+        virtual void processed( unsigned worker, unsigned session, uint64_t stamp ) = 0;
+    };
+
+    struct Stats {
+        uint64_t events;            // processed events
+        uint64_t steals;            // shards stolen from other workers
+    };
+
+    /**
+     * @brief SessionExecutor constructor.
+     * @param workers number of worker threads, 0 for one per core.
+     * @param shards number of shards, 0 for 4 per worker.
+     * @param queueSize capacity of the event queue of a shard.
+     */
+    SessionExecutor( unsigned workers = 0, unsigned shards = 0, size_t queueSize = 4096 );
+    ~SessionExecutor();
+
+    /**
+     * @brief addSession creates a session in the next shard (round-robin).
+     * Requires a built application (e.g. Headless::launch()).
+     * @param name of session.
+     * @param mirror optional backend rendered frames are passed to, which
+     * is invoked by worker threads.
+     * @return index of session.
+     */
+    unsigned addSession( const string name, DisplayBackendIntf *mirror = nullptr );
+
+    /**
+     * @brief start the worker threads. stop() waits until all submitted
+     * events have been processed and stops the worker threads.
+     */
+    void start();
+    void stop();
+
+    /**
+     * @brief submit an input event for a session.
+     * @param session index of session.
+     * @param key input event as GuiFacade::KeyEvt.
+     * @param stamp passed to the listener, e.g. the submit time.
+     * @return false if the event queue of the session's shard is full.
+     */
+    bool submit( unsigned session, int key, uint64_t stamp = 0 );
+
+    /**
+     * @brief getSession returns a session, which must only be accessed
+     * while the executor is stopped.
+     * @param session index of session.
+     * @return reference to session.
+     */
+    Session& getSession( unsigned session ) { return *sessions[ session ]; }
+    size_t size() const { return sessions.size(); }
+
+    unsigned getWorkers() const { return unsigned( workers.size() ); }
+    Stats getStats( unsigned worker ) const;
+    void setListener( ListenerIntf *listener ) { this->listener = listener; }
+
+  private:
+    SessionExecutor( const SessionExecutor& ) = delete;
+    SessionExecutor& operator=( const SessionExecutor& ) = delete;
+
+    static const unsigned BATCH = 64;       // events per shard run before yielding
+    static const int IDLE_MSEC = 1;         // wait of idle worker before stealing again
+
+    struct Event {
+        uint32_t session;
+        uint8_t key;
+        uint64_t stamp;
+    };
+
+    struct Shard {
+        Shard( unsigned home, size_t queueSize )
+            : home( home ), events( queueSize ), owned( false ), due( UINT64_MAX ) {}
+        const unsigned home;            // worker with affinity
+        MpmcQueue<Event> events;
+        atomic<bool> owned;             // queued at or run by a worker
+        atomic<uint64_t> due;           // next expiry of the wheel
+        TimerWheel wheel;               // countdowns of the shard's sessions
+    };
+
+    struct Worker {
+        Worker( unsigned id, size_t shards ) : id( id ), ready( shards ), sleeping( false ), events( 0 ), steals( 0 ) {}
+        const unsigned id;
+        MpmcQueue<Shard *> ready;       // owned shards with events
+        vector<Shard *> home;           // shards with affinity to worker
+        atomic<bool> sleeping;
+        mutex lock;                     // only taken to sleep and wake up
+        condition_variable wakeup;
+        atomic<uint64_t> events;        // written by worker only
+        atomic<uint64_t> steals;
+        thread t;
+    };
+
+    void work( Worker& w );
+    void run( Worker& w, Shard& s );
+    bool steal( Worker& w );
+    void wake( Worker& w );
+
+    vector<Worker *> workers;
+    vector<Shard *> shards;
+    vector<Session *> sessions;
+    ListenerIntf *listener = nullptr;
+    atomic<bool> running;
+};
+
+#endif // EXECUTOR_H
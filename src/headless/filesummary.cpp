@@ -0,0 +1,66 @@
+#include <chrono>
+#include <cstdio>
+#include "filesummary.h"
+
+static const size_t BATCH = 4096;       // numbers parsed per Statistics::add()
+
+
+/**
+ * @brief FileSummary::reduce parses a chunk in batches, accumulates them
+ * and merges all chunks reduced in order into the total.
+ * @param chunk index of chunk.
+ * @param begin, end of chunk.
+ * @throws invalid_argument if a number is malformed.
+ */
+void FileSummary::reduce( size_t chunk, const char *begin, const char *end ) {
+    double values[ BATCH ];
+    Statistics s;
+    size_t n;
+    while( ( n = file.parse( begin, end, values, BATCH ) ) > 0 ) {
+        s.add( values, n );
+    }
+    lock_guard<mutex> l( lock );
+    parts[ chunk ] = move( s );
+    done[ chunk ] = true;
+    for( ; merged < parts.size() && done[ merged ]; merged++ ) {
+        total.merge( parts[ merged ] );
+        parts[ merged ] = Statistics();
+    }
+}
+
+
+/**
+ * @brief FileSummary::run reduces a file of numbers and prints count, sum,
+ * mean, standard deviation, variance, minimum, maximum and quantiles.
+ * @param path of file.
+ * @param threads number of threads, 0 for one per core.
+ * @return exit code.
+ */
+int FileSummary::run( const string& path, unsigned threads ) {
+    char line[ 160 ];
+    try {
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        NumberFile file( path );
+        FileSummary summary( file );
+        file.forChunks( threads, summary );
+        double sec = chrono::duration<double>( chrono::steady_clock::now() - t0 ).count();
+
+        const Statistics& s = summary.getTotal();
+        sprintf( line, "Summary: %llu numbers, %.1f MB in %zu chunks reduced in %.1f ms (%.2f GB/s).",
+                 (unsigned long long) s.count(), file.size() / 1e6, file.chunks(), sec * 1e3,
+                 sec > 0? file.size() / 1e9 / sec : 0.0 );
+        cout << line << endl;
+        sprintf( line, "  count %llu  sum %.15g  mean %.15g", (unsigned long long) s.count(), s.sum(), s.mean() );
+        cout << line << endl;
+        sprintf( line, "  stddev %.15g  variance %.15g", s.stddev(), s.variance() );
+        cout << line << endl;
+        sprintf( line, "  min %.15g  p50 %.6g  p90 %.6g  p99 %.6g  p99.9 %.6g  max %.15g", s.min(),
+                 s.quantile( 0.5 ), s.quantile( 0.9 ), s.quantile( 0.99 ), s.quantile( 0.999 ), s.max() );
+        cout << line << endl;
+
+    } catch( exception& e ) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,58 @@
+#ifndef FILESUMMARY_H
+#define FILESUMMARY_H
+
+#include <iostream>
+#include <vector>
+#include <mutex>
+#include "numberfile.h"
+#include "statistics.h"
+using namespace std;
+
+
+/**
+ * @brief FileSummary reduces a file of numbers to the statistics of
+ * StatisticsMode, e.g. for shift-end summaries of tens of millions of
+ * entries (Linux only).
+ *
+ * Chunks of the file are parsed and accumulated in parallel, each into
+ * its own Statistics. Reduced chunks are merged into the total strictly
+ * in chunk order as soon as their predecessors are merged, such that the
+ * summary is identical for any number of threads and only a few chunks
+ * are held at a time.
+ */
+class FileSummary : public NumberFile::ReducerIntf {
+
+  public:
+    FileSummary( const NumberFile& file )
+      : file( file ), parts( file.chunks() ), done( file.chunks(), false ) {}
+
+    /**
+     * @brief reduce method inherited from NumberFile::ReducerIntf
+     * accumulates the numbers of a chunk.
+     */
+    virtual void reduce( size_t chunk, const char *begin, const char *end );
+
+    /**
+     * @brief getTotal returns the statistics of all chunks reduced.
+     */
+    const Statistics& getTotal() const { return total; }
+
+    /**
+     * @brief run reduces a file of numbers and prints the summary and the
+     * throughput. Invoked from main() for option --summary.
+     * @param path of file.
+     * @param threads number of threads, 0 for one per core.
+     * @return exit code.
+     */
+    static int run( const string& path, unsigned threads );
+
+  private:
+    const NumberFile& file;
+    mutex lock;                     // guards members below
+    vector<Statistics> parts;       // reduced chunks not merged yet
+    vector<bool> done;
+    size_t merged = 0;              // chunks merged into total
+    Statistics total;
+};
+
+#endif // FILESUMMARY_H
@@ -0,0 +1,71 @@
+#include "headless.h"
+#include "display.h"
+#include "builder.h"
+#include "eventfactory.h"
+#include "guifacade.h"
+#include "maincontroller.h"
+#include "timerwheel.h"
+
+
+/**
+ * @brief Headless constructor. With virtual time, the default timer
+ * wheel is switched to a VirtualClock, which requires an idle wheel.
+ * @param virtualTime run timers on a VirtualClock instead of the
+ * monotonic clock.
+ */
+Headless::Headless( bool virtualTime ) : wheel( TimerWheel::getInstance() ) {
+    if( virtualTime ) {
+        virtualClock.sleepUntil( wheel.now() );
+        wheel.setClock( virtualClock );
+    }
+}
+
+Headless::~Headless() {
+    shutdown();
+    wheel.setClock( MonotonicClock::getInstance() );
+}
+
+
+/**
+ * @brief launch builds and starts the application in fast-start mode
+ * with a display that has no widgets bound.
+ * @param config options of components built.
+ */
+void Headless::launch( const BuildConfig& config ) {
+    if( builder == nullptr ) {
+        static const Ui::Display::Digit noWidgets[ 10 ] = {};
+        Ui::Display *uiDisplay = new Ui::Display( noWidgets, 10 );
+        builder = &Builder::getInstance( *uiDisplay );
+        if( builder->build( config, true ) ) {
+            builder->getMainController()->start();
+        }
+    }
+}
+
+/**
+ * @brief shutdown stops the application and tears down all components.
+ */
+void Headless::shutdown() {
+    if( builder != nullptr ) {
+        builder->getMainController()->stop( true );
+        builder = nullptr;
+    }
+}
+
+
+/**
+ * @brief publish injects an input event through GuiFacade.
+ * @param key input event as GuiFacade::KeyEvt.
+ */
+void Headless::publish( int key ) {
+    XEventFactory& ef = builder->getEventFactory();
+    builder->getGui()->publish( ef.getEvent( key ) );
+}
+
+/**
+ * @brief getFrame returns the last rendered display frame.
+ * @return display frame.
+ */
+const SegmentFrame& Headless::getFrame() const {
+    return builder->getGui()->getFrame();
+}
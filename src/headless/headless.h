@@ -0,0 +1,65 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <iostream>
+#include "clock.h"
+#include "segmentframe.h"
+#include "buildconfig.h"
+class Builder;
+class TimerWheel;
+using namespace std;
+
+
+/**
+ * @brief Headless is the counterpart of MainWindow for running the
+ * application without a GUI and without a Qt event loop. It builds the
+ * application with a display that has no widgets bound, such that tools
+ * (e.g. replay of recorded key events) can inject input events through
+ * GuiFacade and read the rendered display frame.
+ *
+ * Timers are driven by the default TimerWheel, which tools advance by
+ * TimerWheel::runUntil(). With virtual time, the wheel runs on a
+ * VirtualClock and timers expire instantly in order of their expiry.
+ */
+class Headless {
+
+  public:
+    /**
+     * @brief Headless constructor.
+     * @param virtualTime run timers on a VirtualClock instead of the
+     * monotonic clock.
+     */
+    Headless( bool virtualTime = false );
+    ~Headless();
+
+    /**
+     * @brief launch builds and starts the application in fast-start mode
+     * (no probe cycle, no loggers). shutdown() stops the application and
+     * tears down all components.
+     * @param config options of components built.
+     */
+    void launch( const BuildConfig& config = BuildConfig() );
+    void shutdown();
+
+    /**
+     * @brief publish injects an input event through GuiFacade.
+     * @param key input event as GuiFacade::KeyEvt.
+     */
+    void publish( int key );
+
+    /**
+     * @brief getFrame returns the last rendered display frame.
+     * @return display frame.
+     */
+    const SegmentFrame& getFrame() const;
+
+    TimerWheel& getWheel() { return wheel; }
+    Builder& getBuilder() { return *builder; }
+
+  private:
+    VirtualClock virtualClock;
+    TimerWheel& wheel;
+    Builder *builder = nullptr;
+};
+
+#endif // HEADLESS_H
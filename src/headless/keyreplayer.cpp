@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include "keyreplayer.h"
+#include "headless.h"
+#include "timerwheel.h"
+
+
+/**
+ * @brief KeyReplayer::replay injects recorded events in order. Before each
+ * event, the timer wheel is run until the recorded time of the event such
+ * that timers expire in between events as they did during recording.
+ * @param log recorded events.
+ * @return report of replay.
+ */
+KeyReplayer::Report KeyReplayer::replay( const vector<KeyLog::Record>& log ) {
+    TimerWheel& wheel = headless.getWheel();
+    vector<double> latency;
+    latency.reserve( log.size() );
+
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    uint64_t start = wheel.now();
+    for( vector<KeyLog::Record>::const_iterator it = log.begin(); it != log.end(); it++ ) {
+        wheel.runUntil( start + it->msec );
+        chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+        headless.publish( it->key );
+        chrono::duration<double, micro> d = chrono::steady_clock::now() - t1;
+        latency.push_back( d.count() );
+    }
+    chrono::duration<double> total = chrono::steady_clock::now() - t0;
+
+    Report r = { log.size(), total.count(), 0.0, 0.0, 0.0, 0.0, headless.getFrame().toString() };
+    if( ! latency.empty() ) {
+        sort( latency.begin(), latency.end() );
+        size_t n = latency.size() - 1;
+        r.p50 = latency[ n * 50 / 100 ];
+        r.p90 = latency[ n * 90 / 100 ];
+        r.p99 = latency[ n * 99 / 100 ];
+        r.max = latency[ n ];
+    }
+    return r;
+}
+
+
+/**
+ * @brief KeyReplayer::print report to cout.
+ * @param r report of replay.
+ */
+void KeyReplayer::print( const Report& r ) {
+    char line[ 160 ];
+    sprintf( line, "Replayed %lu events in %.3f s (%.0f events/s).",
+             ( unsigned long )r.events, r.seconds, r.seconds > 0.0? r.events / r.seconds : 0.0 );
+    cout << line << endl;
+    sprintf( line, "Latency: p50 %.2f us, p90 %.2f us, p99 %.2f us, max %.2f us.", r.p50, r.p90, r.p99, r.max );
+    cout << line << endl;
+    cout << "Display: [" << r.display << "]" << endl;
+}
+
+
+/**
+ * @brief KeyReplayer::run replays a key log file in a headless application
+ * and prints the report.
+ * @param path of key log file.
+ * @param fast replay as fast as possible on virtual time.
+ * @param build options of components built.
+ * @return exit code.
+ */
+int KeyReplayer::run( const string& path, bool fast, const BuildConfig& build ) {
+    vector<KeyLog::Record> log;
+    try {
+        log = KeyLog::load( path );
+
+    } catch( exception& e ) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    Headless headless( fast );
+    headless.launch( build );
+    KeyReplayer replayer( headless );
+    Report r = replayer.replay( log );
+    headless.shutdown();
+    print( r );
+    return 0;
+}
@@ -0,0 +1,64 @@
+#ifndef KEYREPLAYER_H
+#define KEYREPLAYER_H
+
+#include <iostream>
+#include <vector>
+#include "keylog.h"
+class Headless;
+struct BuildConfig;
+using namespace std;
+
+
+/**
+ * @brief KeyReplayer injects recorded key events into GuiFacade::publish
+ * of a headless application. Events are replayed at their recorded time
+ * on the clock of the timer wheel: on the monotonic clock this is the
+ * original timing, on a virtual clock replay runs as fast as possible
+ * while timers (e.g. countdowns) still expire at their recorded times.
+ *
+ * The replay reports events per second, the final display state and
+ * percentiles of the latency of processing an event.
+ */
+class KeyReplayer {
+
+  public:
+    struct Report {
+        size_t events;      // number of replayed events
+        double seconds;     // wall time of replay
+        double p50;         // latency percentiles in usec
+        double p90;
+        double p99;
+        double max;
+        string display;     // final display state
+    };
+
+    KeyReplayer( Headless& headless ) : headless( headless ) {}
+
+    /**
+     * @brief replay injects recorded events in order.
+     * @param log recorded events.
+     * @return report of replay.
+     */
+    Report replay( const vector<KeyLog::Record>& log );
+
+    /**
+     * @brief print report to cout.
+     * @param r report of replay.
+     */
+    static void print( const Report& r );
+
+    /**
+     * @brief run replays a key log file in a headless application and
+     * prints the report. Invoked from main() for option --replay.
+     * @param path of key log file.
+     * @param fast replay as fast as possible on virtual time.
+     * @param build options of components built.
+     * @return exit code.
+     */
+    static int run( const string& path, bool fast, const BuildConfig& build );
+
+  private:
+    Headless& headless;
+};
+
+#endif // KEYREPLAYER_H
@@ -0,0 +1,328 @@
+#include <chrono>
+#include <thread>
+#include <random>
+#include <cstdio>
+#include <fstream>
+#include "loadgen.h"
+#include "headless.h"
+#include "session.h"
+#include "timerwheel.h"
+#include "guifacade.h"
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+
+/**
+ * @brief LatencyHistogram::index returns the bucket of value 'v'. Values
+ * below 16 have exact buckets, larger values 16 buckets per power of two.
+ * @param v value.
+ * @return bucket index.
+ */
+int LatencyHistogram::index( uint64_t v ) {
+    if( v < ( uint64_t( 1 ) << SUB_BITS ) ) {
+        return int( v );
+    }
+    int msb = 63 - __builtin_clzll( v );
+    return ( ( msb - SUB_BITS + 1 ) << SUB_BITS ) + int( ( v >> ( msb - SUB_BITS ) ) & ( ( 1 << SUB_BITS ) - 1 ) );
+}
+
+uint64_t LatencyHistogram::lowerBound( int i ) {
+    if( i < ( 1 << SUB_BITS ) ) {
+        return uint64_t( i );
+    }
+    int msb = ( i >> SUB_BITS ) + SUB_BITS - 1;
+    uint64_t mantissa = uint64_t( i & ( ( 1 << SUB_BITS ) - 1 ) ) | ( uint64_t( 1 ) << SUB_BITS );
+    return mantissa << ( msb - SUB_BITS );
+}
+
+void LatencyHistogram::record( uint64_t nsec ) {
+    buckets[ index( nsec ) ]++;
+    count++;
+    max = nsec > max? nsec : max;
+}
+
+void LatencyHistogram::merge( const LatencyHistogram& h ) {
+    for( int i=0; i < BUCKETS; i++ ) {
+        buckets[i] += h.buckets[i];
+    }
+    count += h.count;
+    max = h.max > max? h.max : max;
+}
+
+/**
+ * @brief LatencyHistogram::percentile returns the latency below which 'p'
+ * percent of the recorded latencies are, as lower bound of the bucket.
+ * @param p percentile in [0..100].
+ * @return latency in nsec.
+ */
+uint64_t LatencyHistogram::percentile( double p ) const {
+    uint64_t rank = uint64_t( p / 100.0 * double( count ) );
+    uint64_t n = 0;
+    for( int i=0; i < BUCKETS; i++ ) {
+        n += buckets[i];
+        if( n > rank ) {
+            uint64_t v = lowerBound( i );
+            return v < max? v : max;
+        }
+    }
+    return max;
+}
+
+
+/**
+ * @brief Key weights per 256 keys resembling real usage, indexed by
+ * GuiFacade::KeyEvt. Parentheses are not supported and not generated.
+ */
+static const int keyWeights[] = {
+    20, 16, 16, 16, 16, 16, 16, 16, 16, 16,     // K0..K9
+    6, 2,                                       // Comma, K000
+    14, 8, 8, 6, 1, 1, 14,                      // Plus, Minus, Mul, Div, Percent, VAT, EQ
+    12, 8, 4,                                   // BS, C, CE
+    2, 3, 3,                                    // Mode, Start, Stop
+    0, 0                                        // ParOpen, ParClose
+};
+
+
+static uint64_t nowNs() {
+    return uint64_t( chrono::duration_cast<chrono::nanoseconds>( chrono::steady_clock::now().time_since_epoch() ).count() );
+}
+
+void LoadGenerator::Probe::processed( unsigned worker, unsigned, uint64_t stamp ) {
+    latency[ worker ].record( nowNs() - stamp );
+}
+
+
+/**
+ * @brief LoadGenerator::work is the loop of a worker thread. The worker
+ * creates its sessions with countdowns on its own timer wheel, waits for
+ * the start signal and publishes random keys round-robin to its sessions
+ * until the configured duration has passed. With an executor, the worker
+ * submits keys to every threads-th session of the executor instead,
+ * retrying while the session's queue is full.
+ * @param w worker.
+ */
+void LoadGenerator::work( Worker& w ) {
+    uint8_t keys[ 256 ];
+    for( int k=0, i=0; k <= GuiFacade::ParClose; k++ ) {
+        for( int j=0; j < keyWeights[k]; j++ ) {
+            keys[ i++ ] = uint8_t( k );
+        }
+    }
+    mt19937 rnd( config.seed + w.id );
+
+    TimerWheel wheel;
+    vector<Session *> sessions;
+    for( unsigned i=0; executor == nullptr && i < w.sessions; i++ ) {
+        sessions.push_back( new Session( "Session-" + to_string( w.id ) + "." + to_string( i ), wheel ) );
+    }
+    ready++;
+    while( ! go ) {
+        this_thread::yield();
+    }
+
+    typedef chrono::steady_clock clk;
+    const unsigned threads = config.threads > 0? config.threads : 1;
+    const uint64_t end = startNs + uint64_t( config.seconds * 1e9 );
+    const double interval = config.rate > 0.0? 1e9 / ( config.rate * w.sessions ) : 0.0;
+    for( uint64_t n=0; w.sessions > 0; n++ ) {
+        uint64_t t = nowNs();
+        if( t >= end ) {
+            break;
+        }
+        uint64_t due = t;
+        if( interval > 0.0 ) {
+            due = startNs + uint64_t( double( n ) * interval );
+            if( due > t ) {
+                this_thread::sleep_until( clk::time_point( chrono::nanoseconds( due ) ) );
+            }
+        }
+        if( executor != nullptr ) {
+            unsigned session = w.id + unsigned( n % w.sessions ) * threads;
+            int key = keys[ rnd() & 0xff ];
+            while( ! executor->submit( session, key, due ) ) {
+                this_thread::yield();
+            }
+            w.events.store( n + 1, memory_order_relaxed );
+            continue;
+        }
+        sessions[ n % w.sessions ]->publish( keys[ rnd() & 0xff ] );
+        w.latency.record( nowNs() - due );
+        w.events.store( n + 1, memory_order_relaxed );
+        if( wheel.size() > 0 ) {
+            wheel.advance();
+        }
+    }
+
+    for( vector<Session *>::iterator it = sessions.begin(); it != sessions.end(); it++ ) {
+        delete *it;
+    }
+}
+
+
+/**
+ * @brief LoadGenerator::processed returns the number of events processed
+ * by the worker threads or the executor.
+ * @param workers worker threads.
+ * @return number of processed events.
+ */
+uint64_t LoadGenerator::processed( const vector<Worker *>& workers ) const {
+    uint64_t n = 0;
+    if( executor != nullptr ) {
+        for( unsigned i=0; i < executor->getWorkers(); i++ ) {
+            n += executor->getStats( i ).events;
+        }
+        return n;
+    }
+    for( vector<Worker *>::const_iterator it = workers.begin(); it != workers.end(); it++ ) {
+        n += ( *it )->events.load( memory_order_relaxed );
+    }
+    return n;
+}
+
+
+/**
+ * @brief LoadGenerator::generate load as configured. Sessions are spread
+ * evenly over worker threads, or over the shards of an executor if
+ * configured. While workers run, the main thread samples the number of
+ * processed events once per second.
+ * @return report of run.
+ */
+LoadGenerator::Report LoadGenerator::generate() {
+    unsigned threads = config.threads > 0? config.threads : 1;
+    Probe *probe = nullptr;
+    if( config.executor > 0 ) {
+        executor = new SessionExecutor( config.executor );
+        for( unsigned i=0; i < config.sessions; i++ ) {
+            executor->addSession( "Session-" + to_string( i ) );
+        }
+        probe = new Probe( executor->getWorkers() );
+        executor->setListener( probe );
+        executor->start();
+    }
+    vector<Worker *> workers;
+    vector<thread> pool;
+    for( unsigned i=0; i < threads; i++ ) {
+        Worker *w = new Worker();
+        w->id = i;
+        w->sessions = config.sessions / threads + ( i < config.sessions % threads? 1 : 0 );
+        w->events = 0;
+        workers.push_back( w );
+    }
+    for( unsigned i=0; i < threads; i++ ) {
+        pool.push_back( thread( &LoadGenerator::work, this, ref( *workers[i] ) ) );
+    }
+    while( ready < int( threads ) ) {
+        this_thread::sleep_for( chrono::milliseconds( 1 ) );
+    }
+
+    Report r;
+    r.rssBefore = residentKb();
+    typedef chrono::steady_clock clk;
+    clk::time_point t0 = clk::now();
+    startNs = uint64_t( chrono::duration_cast<chrono::nanoseconds>( t0.time_since_epoch() ).count() );
+    go = true;
+
+    // sample throughput of every full second
+    double sustained = -1.0;
+    uint64_t prev = 0;
+    for( int s=1; s <= int( config.seconds ); s++ ) {
+        this_thread::sleep_until( t0 + chrono::seconds( s ) );
+        uint64_t n = processed( workers );
+        double rate = double( n - prev );
+        sustained = sustained < 0.0 || rate < sustained? rate : sustained;
+        prev = n;
+    }
+    r.rssAfter = residentKb();
+
+    for( unsigned i=0; i < threads; i++ ) {
+        pool[i].join();
+    }
+    if( executor != nullptr ) {
+        executor->stop();
+    }
+    chrono::duration<double> d = clk::now() - t0;
+    r.events = processed( workers );
+    r.steals = 0;
+    for( unsigned i=0; i < threads; i++ ) {
+        r.latency.merge( workers[i]->latency );
+        delete workers[i];
+    }
+    if( executor != nullptr ) {
+        for( unsigned i=0; i < executor->getWorkers(); i++ ) {
+            r.latency.merge( probe->latency[i] );
+            r.steals += executor->getStats( i ).steals;
+        }
+        delete executor;
+        delete probe;
+        executor = nullptr;
+    }
+    r.seconds = d.count() < config.seconds? d.count() : config.seconds;
+    r.sustained = sustained < 0.0? 0.0 : sustained;
+    return r;
+}
+
+
+/**
+ * @brief LoadGenerator::print report to cout.
+ * @param r report of run.
+ */
+void LoadGenerator::print( const Report& r ) const {
+    char line[ 200 ];
+    char rate[ 64 ] = "unlimited rate";
+    if( config.rate > 0.0 ) {
+        sprintf( rate, "%g keys/s per session", config.rate );
+    }
+    sprintf( line, "Load: %u sessions on %u threads, %s, %.1f s.", config.sessions,
+             config.threads > 0? config.threads : 1, rate, r.seconds );
+    cout << line << endl;
+    if( config.executor > 0 ) {
+        sprintf( line, "Executor: %u workers, %llu shards stolen.", config.executor, (unsigned long long) r.steals );
+        cout << line << endl;
+    }
+    sprintf( line, "Throughput: %.0f events/s average, %.0f events/s sustained (lowest second).",
+             r.seconds > 0.0? double( r.events ) / r.seconds : 0.0, r.sustained );
+    cout << line << endl;
+    sprintf( line, "Latency: p50 %.2f us, p99 %.2f us, p99.9 %.2f us, max %.2f us.",
+             double( r.latency.percentile( 50.0 ) ) / 1000.0, double( r.latency.percentile( 99.0 ) ) / 1000.0,
+             double( r.latency.percentile( 99.9 ) ) / 1000.0, double( r.latency.getMax() ) / 1000.0 );
+    cout << line << endl;
+    sprintf( line, "Memory: resident %ld kB -> %ld kB (%+ld kB).", r.rssBefore, r.rssAfter, r.rssAfter - r.rssBefore );
+    cout << line << endl;
+}
+
+
+/**
+ * @brief LoadGenerator::run generates load in a headless application and
+ * prints the report.
+ * @param config configuration of load.
+ * @param build options of components built.
+ * @return exit code.
+ */
+int LoadGenerator::run( const Config& config, const BuildConfig& build ) {
+    Headless headless;
+    headless.launch( build );
+    LoadGenerator generator( config );
+    Report r = generator.generate();
+    headless.shutdown();
+    generator.print( r );
+    return 0;
+}
+
+
+/**
+ * @brief LoadGenerator::residentKb returns the resident memory of the
+ * process read from /proc/self/statm.
+ * @return resident memory in kB, 0 if not available.
+ */
+long LoadGenerator::residentKb() {
+    long rss = 0;
+#ifdef __linux__
+    ifstream statm( "/proc/self/statm" );
+    long size = 0;
+    if( statm >> size >> rss ) {
+        rss = rss * ( sysconf( _SC_PAGESIZE ) / 1024 );
+    }
+#endif
+    return rss;
+}
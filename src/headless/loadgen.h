@@ -0,0 +1,145 @@
+#ifndef LOADGEN_H
+#define LOADGEN_H
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include "executor.h"
+using namespace std;
+struct BuildConfig;
+
+
+/**
+ * @brief LatencyHistogram records latencies in nsec in log-linear buckets
+ * with 16 sub-buckets per power of two (relative error below 6.25%), such
+ * that recording does not allocate and histograms can be merged.
+ */
+class LatencyHistogram {
+
+  public:
+    void record( uint64_t nsec );
+    void merge( const LatencyHistogram& h );
+
+    /**
+     * @brief percentile returns the latency below which 'p' percent of
+     * the recorded latencies are.
+     * @param p percentile in [0..100].
+     * @return latency in nsec.
+     */
+    uint64_t percentile( double p ) const;
+    uint64_t getMax() const { return max; }
+    uint64_t size() const { return count; }
+
+  private:
+    static const int SUB_BITS = 4;
+    static const int BUCKETS = ( 64 - SUB_BITS + 1 ) << SUB_BITS;
+
+    static int index( uint64_t v );
+    static uint64_t lowerBound( int i );
+
+    uint64_t buckets[ BUCKETS ] = {};
+    uint64_t count = 0;
+    uint64_t max = 0;
+};
+
+
+/**
+ * @brief LoadGenerator produces random key sequences weighted like real
+ * usage (mostly digits, operators, some C/CE, BS and Mode toggles) for a
+ * number of independent sessions distributed over worker threads. Each
+ * thread drives its sessions round-robin at a configurable rate per
+ * session or as fast as possible.
+ *
+ * At a configured rate, latency is measured from the time a key was due
+ * to the time it was processed, such that queueing delay of an overloaded
+ * thread is included. The report contains sustained throughput (lowest
+ * throughput of any second), latency percentiles and the growth of the
+ * resident memory during the run.
+ *
+ * With a SessionExecutor, the worker threads only submit keys and the
+ * sessions are processed by the executor's workers. Latency is then
+ * measured until the executor has processed a key.
+ */
+class LoadGenerator {
+
+  public:
+    struct Config {
+        unsigned sessions = 100;    // number of sessions
+        unsigned threads = 1;       // number of worker threads
+        double rate = 0.0;          // keys/s per session, 0 for unlimited
+        double seconds = 10.0;      // duration of run
+        unsigned seed = 1;          // seed of random key sequences
+        unsigned executor = 0;      // executor workers, 0 if sessions are driven by worker threads
+    };
+
+    struct Report {
+        uint64_t events;            // number of processed events
+        double seconds;             // duration of run
+        double sustained;           // lowest events/s of any second
+        LatencyHistogram latency;
+        long rssBefore;             // resident memory in kB
+        long rssAfter;
+        uint64_t steals;            // shards stolen by executor workers
+    };
+
+    LoadGenerator( const Config& config ) : config( config ), ready( 0 ), go( false ) {}
+
+    /**
+     * @brief generate load as configured. Requires a built application
+     * (e.g. by Headless::launch()), since sessions share its event factory.
+     * @return report of run.
+     */
+    Report generate();
+
+    /**
+     * @brief print report to cout.
+     * @param r report of run.
+     */
+    void print( const Report& r ) const;
+
+    /**
+     * @brief run generates load in a headless application and prints the
+     * report. Invoked from main() for option --loadgen.
+     * @param config configuration of load.
+     * @param build options of components built.
+     * @return exit code.
+     */
+    static int run( const Config& config, const BuildConfig& build );
+
+    /**
+     * @brief residentKb returns the resident memory of the process.
+     * @return resident memory in kB, 0 if not available.
+     */
+    static long residentKb();
+
+  private:
+    struct Worker {
+        unsigned id;
+        unsigned sessions;                  // number of sessions driven by worker
+        atomic<uint64_t> events;            // processed events, read while running
+        LatencyHistogram latency;
+    };
+
+    /**
+     * @brief Probe records the latency of keys processed by the executor
+     * in one histogram per executor worker.
+     */
+    class Probe : public SessionExecutor::ListenerIntf {
+      public:
+        Probe( unsigned workers ) : latency( workers ) {}
+        void processed( unsigned worker, unsigned session, uint64_t stamp );
+        vector<LatencyHistogram> latency;
+    };
+
+    void work( Worker& w );
+    uint64_t processed( const vector<Worker *>& workers ) const;
+
+    const Config config;
+    SessionExecutor *executor = nullptr;
+    atomic<int> ready;                      // workers that have created their sessions
+    atomic<bool> go;                        // start signal for workers
+    uint64_t startNs = 0;                   // steady_clock time of start in nsec
+};
+
+#endif // LOADGEN_H
@@ -0,0 +1,302 @@
+#include <stdexcept>
+#include <thread>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "numberfile.h"
+
+NumberFile::ReducerIntf::~ReducerIntf() {}
+
+static inline bool isSeparator( char c ) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+static const double POW10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#ifdef __SSE2__
+static const uint64_t POW10_INT[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+
+/**
+ * @brief swarDigits converts the leading 'n' <= 8 ASCII digits of the
+ * little-endian word v to their value in three multiplications (SIMD
+ * within a register). The digits are moved to the high bytes, such that
+ * the bytes below read as leading zeros.
+ */
+static inline uint64_t swarDigits( uint64_t v, unsigned n ) {
+    if( n == 0 ) {
+        return 0;
+    }
+    unsigned shift = 8 * ( 8 - n );
+    v = ( v << shift ) - ( 0x3030303030303030ULL << shift );
+    v = v * 10 + ( v >> 8 );
+    v = ( ( v & 0x000000FF000000FFULL ) * ( 100 + ( 1000000ULL << 32 ) ) +
+          ( ( v >> 16 ) & 0x000000FF000000FFULL ) * ( 1 + ( 10000ULL << 32 ) ) ) >> 32;
+    return v & 0xFFFFFFFF;
+}
+
+/**
+ * @brief parseFast parses numbers of up to 8 integer and 8 fraction
+ * digits without exponent, e.g. prices. The digits, the point and the
+ * separator are located in a 16-byte block by SSE2 compares, integer and
+ * fraction are converted by swarDigits(). m / 10^f is correctly rounded
+ * for m <= 2^53. Requires 32 readable bytes from p on.
+ * @param p start of number.
+ * @param d number parsed.
+ * @return end of number or nullptr if the number is not covered.
+ */
+static inline const char *parseFast( const char *p, double& d ) {
+    bool negative = *p == '-';
+    const char *q = p + ( *p == '-' || *p == '+'? 1 : 0 );
+    __m128i t = _mm_sub_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i *>( q ) ), _mm_set1_epi8( '0' ) );
+    unsigned digits = unsigned( _mm_movemask_epi8( _mm_cmpeq_epi8( _mm_min_epu8( t, _mm_set1_epi8( 9 ) ), t ) ) );
+    unsigned n1 = unsigned( __builtin_ctz( ~digits ) );
+    unsigned n2 = 0, len = n1;
+    if( n1 > 8 ) {
+        return nullptr;
+    }
+    if( q[ n1 ] == '.' ) {
+        n2 = unsigned( __builtin_ctz( ~( digits >> ( n1 + 1 ) ) ) );
+        len = n1 + 1 + n2;
+    }
+    if( n2 > 8 || n1 + n2 == 0 || len >= 16 || ! isSeparator( q[ len ] ) ) {
+        return nullptr;
+    }
+    uint64_t v1, v2;
+    memcpy( &v1, q, 8 );
+    memcpy( &v2, q + n1 + 1, 8 );
+    uint64_t m = swarDigits( v1, n1 ) * POW10_INT[ n2 ] + swarDigits( v2, n2 );
+    if( m > ( uint64_t( 1 ) << 53 ) ) {
+        return nullptr;
+    }
+    double v = double( m ) / POW10[ n2 ];
+    d = negative? -v : v;
+    return q + len;
+}
+#endif
+
+
+/**
+ * @brief NumberFile constructor maps the file read-only and divides it
+ * into chunks. A chunk ends at the first separator at or after a multiple
+ * of CHUNK.
+ * @param path of file.
+ * @throws runtime_error if the file cannot be read.
+ */
+NumberFile::NumberFile( const string& path ) : path( path ) {
+    int fd = open( path.c_str(), O_RDONLY );
+    struct stat st;
+    if( fd < 0 || fstat( fd, &st ) < 0 ) {
+        if( fd >= 0 ) {
+            ::close( fd );
+        }
+        throw runtime_error( "cannot read " + path + ": " + strerror( errno ) );
+    }
+    length = size_t( st.st_size );
+    if( length > 0 ) {
+        void *base = mmap( nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0 );
+        if( base == MAP_FAILED ) {
+            ::close( fd );
+            throw runtime_error( "cannot map " + path + ": " + strerror( errno ) );
+        }
+        madvise( base, length, MADV_SEQUENTIAL );
+        data = static_cast<const char *>( base );
+    }
+    ::close( fd );
+
+    bounds.push_back( 0 );
+    for( size_t b = CHUNK; b < length; b += CHUNK ) {
+        if( b <= bounds.back() ) {
+            continue;
+        }
+        while( b < length && ! isSeparator( data[ b - 1 ] ) ) {
+            b++;
+        }
+        if( b >= length ) {
+            break;
+        }
+        bounds.push_back( b );
+    }
+    bounds.push_back( length );
+}
+
+NumberFile::~NumberFile() {
+    if( data != nullptr ) {
+        munmap( const_cast<char *>( data ), length );
+    }
+}
+
+
+/**
+ * @brief NumberFile::forChunks starts threads - 1 threads and works with
+ * the calling thread until all chunks are reduced. After an exception, no
+ * further chunks are claimed.
+ * @param threads number of threads, 0 for one per core.
+ * @param r reduction.
+ * @throws the first exception thrown by the reduction.
+ */
+void NumberFile::forChunks( unsigned threads, ReducerIntf& r ) const {
+    if( threads == 0 ) {
+        threads = thread::hardware_concurrency();
+        threads = threads > 0? threads : 1;
+    }
+    Work w;
+    w.next = 0;
+    vector<thread> pool;
+    for( unsigned i=1; i < threads; i++ ) {
+        pool.push_back( thread( &NumberFile::work, this, ref( r ), ref( w ) ) );
+    }
+    work( r, w );
+    for( size_t i=0; i < pool.size(); i++ ) {
+        pool[i].join();
+    }
+    if( w.error ) {
+        rethrow_exception( w.error );
+    }
+}
+
+void NumberFile::work( ReducerIntf& r, Work& w ) const {
+    for( size_t c; ( c = w.next++ ) < chunks(); ) {
+        try {
+            r.reduce( c, data + bounds[c], data + bounds[ c + 1 ] );
+
+        } catch( ... ) {
+            lock_guard<mutex> lock( w.lock );
+            if( ! w.error ) {
+                w.error = current_exception();
+            }
+            w.next = chunks();
+        }
+    }
+}
+
+
+/**
+ * @brief NumberFile::parse parses up to 'max' numbers from p on.
+ * @param p position in a chunk, advanced beyond the numbers parsed.
+ * @param end of chunk.
+ * @param values numbers parsed.
+ * @param max capacity of values.
+ * @return number of values parsed, 0 at the end of the chunk.
+ * @throws invalid_argument if a number is malformed.
+ */
+size_t NumberFile::parse( const char *& p, const char *end, double *values, size_t max ) const {
+    size_t k = 0;
+    while( k < max ) {
+        while( p < end && isSeparator( *p ) ) {
+            p++;
+        }
+        if( p == end ) {
+            break;
+        }
+        p = number( p, end, values[ k++ ] );
+    }
+    return k;
+}
+
+/**
+ * @brief NumberFile::number parses the number at p by parseFast() if it
+ * applies and 32 bytes of the file are left, otherwise by parseNumber().
+ * @return end of number.
+ * @throws invalid_argument if the number is malformed.
+ */
+const char *NumberFile::number( const char *p, const char *end, double& d ) const {
+    const char *q = nullptr;
+#ifdef __SSE2__
+    if( p + 32 <= data + length ) {
+        q = parseFast( p, d );
+    }
+#endif
+    if( q == nullptr ) {
+        q = parseNumber( p, end, d );
+    }
+    if( q == nullptr ) {
+        throw invalid_argument( path + ": malformed number at byte " + to_string( p - data ) );
+    }
+    return q;
+}
+
+/**
+ * @brief NumberFile::parseNumber parses a number up to the next separator.
+ * Up to 19 significant digits are accumulated as integer m with decimal
+ * exponent e. If m <= 2^53 and |e| <= 22, m and 10^e are exact doubles
+ * and m * 10^e or m / 10^-e is correctly rounded by a single operation.
+ * Other numbers are converted by strtod().
+ * @param p start of number.
+ * @param end of chunk.
+ * @param d number parsed.
+ * @return end of number or nullptr if it is malformed.
+ */
+const char *NumberFile::parseNumber( const char *p, const char *end, double& d ) {
+    const char *start = p;
+    bool negative = *p == '-';
+    if( *p == '-' || *p == '+' ) {
+        p++;
+    }
+    uint64_t m = 0;
+    int digits = 0, e = 0;
+    bool any = false, exact = true;
+    for( ; p < end && unsigned( *p - '0' ) < 10; p++ ) {
+        any = true;
+        if( digits < 19 ) {
+            m = m * 10 + unsigned( *p - '0' );
+            digits += m > 0? 1 : 0;
+        } else {
+            exact = exact && *p == '0';
+            e++;
+        }
+    }
+    if( p < end && *p == '.' ) {
+        for( p++; p < end && unsigned( *p - '0' ) < 10; p++ ) {
+            any = true;
+            if( digits < 19 ) {
+                m = m * 10 + unsigned( *p - '0' );
+                digits += m > 0? 1 : 0;
+                e--;
+            } else {
+                exact = exact && *p == '0';
+            }
+        }
+    }
+    if( ! any ) {
+        return nullptr;
+    }
+    if( p < end && ( *p == 'e' || *p == 'E' ) ) {
+        p++;
+        bool eNegative = p < end && *p == '-';
+        if( p < end && ( *p == '-' || *p == '+' ) ) {
+            p++;
+        }
+        const char *digit = p;
+        int x = 0;
+        for( ; p < end && unsigned( *p - '0' ) < 10; p++ ) {
+            x = x < 100000? x * 10 + int( *p - '0' ) : x;
+        }
+        if( p == digit ) {
+            return nullptr;
+        }
+        e += eNegative? -x : x;
+    }
+    if( p < end && ! isSeparator( *p ) ) {
+        return nullptr;
+    }
+    if( m == 0 ) {
+        d = negative? -0.0 : 0.0;
+    } else if( exact && m <= ( uint64_t( 1 ) << 53 ) && e >= -22 && e <= 22 ) {
+        double v = e < 0? double( m ) / POW10[ -e ] : double( m ) * POW10[ e ];
+        d = negative? -v : v;
+    } else {
+        d = strtod( string( start, p ).c_str(), nullptr );
+    }
+    return p;
+}
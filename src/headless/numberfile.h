@@ -0,0 +1,93 @@
+#ifndef NUMBERFILE_H
+#define NUMBERFILE_H
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <exception>
+using namespace std;
+
+
+/**
+ * @brief The NumberFile class maps a text file of numbers read-only for
+ * bulk reductions in the headless engine (Linux only). Numbers are
+ * separated by blanks, tabs or line breaks, e.g. one per line, and are
+ * written as decimals with optional sign, fraction and exponent.
+ *
+ * The file is divided into chunks of CHUNK bytes, each ending at a
+ * separator, such that the chunks only depend on the file. forChunks()
+ * processes chunks on a number of threads; results kept per chunk and
+ * combined in chunk order are identical for any number of threads.
+ */
+class NumberFile {
+
+  public:
+    static const size_t CHUNK = 4 << 20;
+
+    /**
+     * @brief Abstract class that defines the interface of reductions of
+     * chunks, which are invoked concurrently for different chunks.
+     */
+    class ReducerIntf {
+      public:
+        virtual ~ReducerIntf();
+        virtual void reduce( size_t chunk, const char *begin, const char *end ) = 0;
+    };
+
+    /**
+     * @brief NumberFile constructor maps a file.
+     * @param path of file.
+     * @throws runtime_error if the file cannot be read.
+     */
+    NumberFile( const string& path );
+    ~NumberFile();
+
+    size_t size() const { return length; }
+    size_t chunks() const { return bounds.size() - 1; }
+
+    /**
+     * @brief forChunks reduces all chunks on 'threads' threads, which
+     * claim chunks in order.
+     * @param threads number of threads, 0 for one per core.
+     * @param r reduction.
+     * @throws the first exception thrown by the reduction.
+     */
+    void forChunks( unsigned threads, ReducerIntf& r ) const;
+
+    /**
+     * @brief parse parses up to 'max' numbers from p on and advances p
+     * beyond them.
+     * @param p position in a chunk, advanced.
+     * @param end of chunk.
+     * @param values numbers parsed.
+     * @param max capacity of values.
+     * @return number of values parsed, 0 at the end of the chunk.
+     * @throws invalid_argument if a number is malformed.
+     */
+    size_t parse( const char *& p, const char *end, double *values, size_t max ) const;
+
+  private:
+    NumberFile( const NumberFile& ) = delete;
+    NumberFile& operator=( const NumberFile& ) = delete;
+
+    /**
+     * @brief Work is the state shared by the threads of forChunks().
+     */
+    struct Work {
+        atomic<size_t> next;
+        mutex lock;
+        exception_ptr error;
+    };
+    void work( ReducerIntf& r, Work& w ) const;
+
+    const char *number( const char *p, const char *end, double& d ) const;
+    static const char *parseNumber( const char *p, const char *end, double& d );
+
+    string path;
+    const char *data = nullptr;
+    size_t length = 0;
+    vector<size_t> bounds;      // offsets of chunks, file size last
+};
+
+#endif // NUMBERFILE_H
@@ -0,0 +1,61 @@
+#include <atomic>
+#include "session.h"
+#include "builder.h"
+#include "eventfactory.h"
+#include "calculator.h"
+#include "displaycontroller.h"
+#include "inputprocessor.h"
+#ifdef __linux__
+#include "journal.h"
+#endif
+
+static atomic<uint32_t> sessionIds( 1 );       // 0 is the calculator of Builder
+
+
+/**
+ * @brief Session constructor creates and starts the session components.
+ * Components do not publish controller events. The calculator has the
+ * precision selected in the BuildConfig of the Builder and is attached to
+ * the journal of the Builder, if one is built.
+ * @param name of session.
+ * @param wheel timer wheel of countdowns.
+ * @param mirror optional backend rendered frames are passed to.
+ */
+Session::Session( const string name, TimerWheel& wheel, DisplayBackendIntf *mirror )
+    : name( name ), id( sessionIds++ ), builder( Builder::getInstance() ), countdowns( name, wheel ),
+      mirror( mirror )
+{
+    alu = new Calculator( name );
+    alu->setPrecision( Calculator::Precision( builder.getConfig().precision ) );
+#ifdef __linux__
+    if( builder.getJournal() != nullptr ) {
+        builder.getJournal()->attach( *alu, id );
+    }
+#endif
+    display = new DisplayController( name, builder, nullptr, this );
+    input = new InputProcessor( name, builder, *alu, countdowns, *display, nullptr );
+    display->start();
+    input->start();
+}
+
+Session::~Session() {
+#ifdef __linux__
+    if( builder.getJournal() != nullptr ) {
+        builder.getJournal()->detach( *alu );
+    }
+#endif
+    delete input;
+    delete display;
+    delete alu;
+}
+
+
+/**
+ * @brief publish passes an input event to the session in the same way
+ * as GuiFacade passes input events to the InputProcessor.
+ * @param key input event as GuiFacade::KeyEvt.
+ */
+void Session::publish( int key ) {
+    XEventFactory& ef = builder.getEventFactory();
+    input->notify( ef.getEvent( key ) );
+}
@@ -0,0 +1,78 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <iostream>
+#include <cstdint>
+#include "segmentframe.h"
+#include "countdown.h"
+class Builder;
+class Calculator;
+class DisplayController;
+class InputProcessor;
+using namespace std;
+
+
+/**
+ * @brief The Session class is an independent calculator session with its
+ * own InputProcessor, Calculator logic, DisplayController and countdowns,
+ * which are otherwise singletons created by Builder. A session is its own
+ * display backend and keeps the last rendered frame, which is also passed
+ * to an optional mirror backend (e.g. a client connection).
+ *
+ * Sessions share the XEventFactory and the journal of the Builder, which
+ * must have been built (e.g. by Headless::launch()) and must outlive the
+ * sessions. Each session has a unique id > 0, under which its calculator
+ * is journalled. Countdowns of a session run on the
+ * timer wheel passed to the session. Sessions on the same wheel must be
+ * used from the same thread, sessions on different wheels can be used
+ * from different threads.
+ */
+class Session : public DisplayBackendIntf {
+
+  public:
+    /**
+     * @brief Session constructor creates and starts the session components.
+     * @param name of session.
+     * @param wheel timer wheel of countdowns.
+     * @param mirror optional backend rendered frames are passed to.
+     */
+    Session( const string name, TimerWheel& wheel = TimerWheel::getInstance(),
+             DisplayBackendIntf *mirror = nullptr );
+    ~Session();
+
+    /**
+     * @brief publish passes an input event to the session in the same way
+     * as GuiFacade passes input events to the InputProcessor.
+     * @param key input event as GuiFacade::KeyEvt.
+     */
+    void publish( int key );
+
+    /**
+     * @brief render method inherited from DisplayBackendIntf keeps the
+     * frame rendered by the session and passes it to the mirror backend.
+     * getFrame() returns the last frame.
+     * @param f frame to render.
+     */
+    void render( const SegmentFrame& f ) { frame = f; if( mirror ) mirror->render( f ); }
+    const SegmentFrame& getFrame() const { return frame; }
+
+    const string& getName() const { return name; }
+    uint32_t getId() const { return id; }
+
+  private:
+    Session( const Session& ) = delete;
+    Session& operator=( const Session& ) = delete;
+
+    const string name;
+    const uint32_t id;
+    Builder& builder;
+    CountdownEngine countdowns;
+    Calculator *alu;
+    DisplayController *display;
+    InputProcessor *input;
+    DisplayBackendIntf *mirror;
+
+    SegmentFrame frame;         // last rendered frame
+};
+
+#endif // SESSION_H
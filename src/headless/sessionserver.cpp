@@ -0,0 +1,384 @@
+#include <thread>
+#include <set>
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include "sessionserver.h"
+#include "headless.h"
+#include "session.h"
+#include "timerwheel.h"
+#include "guifacade.h"
+
+#ifndef EPOLLEXCLUSIVE
+#define EPOLLEXCLUSIVE ( 1u << 28 )
+#endif
+
+
+/**
+ * @brief Connection of a client with its own session. Display frames
+ * rendered outside of requests (initial display, timers) are queued as
+ * lines for the client and the connection is marked dirty to be flushed
+ * by the event loop. Frames rendered while a request is processed are
+ * not, since the display is sent once at the end of the request.
+ */
+class Connection : public DisplayBackendIntf {
+
+  public:
+    Connection( int fd, const string name, TimerWheel& wheel, vector<Connection *>& dirty )
+        : fd( fd ), dirty( dirty ), session( name, wheel, this ) {}
+    ~Connection() { ::close( fd ); }
+
+    void render( const SegmentFrame& f ) {
+        if( ! inRequest ) {
+            queue( f );
+            if( ! isDirty ) {
+                isDirty = true;
+                dirty.push_back( this );
+            }
+        }
+    }
+
+    void queue( const SegmentFrame& f ) {
+        out.append( f.toString() );
+        out.push_back( '\n' );
+    }
+
+    const int fd;
+    vector<Connection *>& dirty;    // connections of the loop with output queued by timers
+    bool isDirty = false;
+    bool inRequest = false;     // true while keys of a request are processed
+    bool eof = false;           // client has shut down sending, close once output is sent
+    uint32_t events = 0;        // epoll events the connection is registered for
+    string out;                 // output not yet sent
+    size_t sent = 0;            // bytes of 'out' already sent
+    Session session;            // must be last, renders on construction
+};
+
+
+/**
+ * @brief EventLoop of one server thread with its own epoll instance and
+ * timer wheel. Sessions of connections accepted by a loop are driven by
+ * that loop only.
+ */
+class SessionServer::EventLoop {
+
+  public:
+    EventLoop( SessionServer& server, unsigned id ) : server( server ), id( id ) {
+        epfd = epoll_create1( EPOLL_CLOEXEC );
+        epoll_event ev = {};
+        ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+        ev.data.ptr = nullptr;      // listening socket
+        epoll_ctl( epfd, EPOLL_CTL_ADD, server.listenFd, &ev );
+    }
+
+    ~EventLoop() {
+        for( set<Connection *>::iterator it = connections.begin(); it != connections.end(); it++ ) {
+            delete *it;
+        }
+        ::close( epfd );
+    }
+
+    void run();
+
+  private:
+    static const size_t OUT_LIMIT = 1 << 20;    // stop reading above 1 MB pending output
+    static const int MAX_EVENTS = 256;
+
+    void accept();
+    bool receive( Connection *c );
+    bool flush( Connection *c );
+    void close( Connection *c );
+
+    SessionServer& server;
+    const unsigned id;
+    int epfd;
+    TimerWheel wheel;
+    set<Connection *> connections;
+    vector<Connection *> dirty;
+    unsigned accepted = 0;
+};
+
+
+/**
+ * @brief EventLoop::run waits for socket events and timers until the
+ * server is stopped. The wait is limited to 100 msec to notice stop().
+ */
+void SessionServer::EventLoop::run() {
+    epoll_event events[ MAX_EVENTS ];
+    while( server.running ) {
+        uint64_t next = wheel.nextExpiry();
+        uint64_t now = wheel.now();
+        int timeout = next == UINT64_MAX || next > now + 100? 100 : next > now? int( next - now ) : 0;
+
+        int n = epoll_wait( epfd, events, MAX_EVENTS, timeout );
+        for( int i=0; i < n; i++ ) {
+            Connection *c = static_cast<Connection *>( events[i].data.ptr );
+            if( c == nullptr ) {
+                accept();
+                continue;
+            }
+            bool ok = ( events[i].events & ( EPOLLERR | EPOLLHUP ) ) == 0;
+            if( ok && events[i].events & ( EPOLLIN | EPOLLRDHUP ) ) {
+                ok = receive( c );
+            }
+            if( ok ) {
+                ok = flush( c );
+            }
+            if( ! ok ) {
+                close( c );
+            }
+        }
+
+        // timers render into sessions, frames are queued at dirty connections
+        if( wheel.size() > 0 ) {
+            wheel.advance();
+        }
+        vector<Connection *> flushing;
+        flushing.swap( dirty );
+        for( vector<Connection *>::iterator it = flushing.begin(); it != flushing.end(); it++ ) {
+            ( *it )->isDirty = false;
+            if( ! flush( *it ) ) {
+                close( *it );
+            }
+        }
+    }
+}
+
+/**
+ * @brief EventLoop::accept accepts pending clients and creates a
+ * connection with a session for each client.
+ */
+void SessionServer::EventLoop::accept() {
+    for( int i=0; i < 64; i++ ) {
+        int fd = accept4( server.listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC );
+        if( fd < 0 ) {
+            return;
+        }
+        Connection *c = new Connection( fd, "Client-" + to_string( id ) + "." + to_string( accepted++ ), wheel, dirty );
+        connections.insert( c );
+        c->events = EPOLLIN | EPOLLRDHUP;
+        epoll_event ev = {};
+        ev.events = c->events;
+        ev.data.ptr = c;
+        epoll_ctl( epfd, EPOLL_CTL_ADD, fd, &ev );
+    }
+}
+
+/**
+ * @brief EventLoop::receive reads available input and passes keys to the
+ * session. A newline completes a request, which is answered with the
+ * display. At the end of input, e.g. after the client has shut down
+ * sending, reading stops and replies queued so far are still sent.
+ * @param c connection.
+ * @return false if the connection has failed.
+ */
+bool SessionServer::EventLoop::receive( Connection *c ) {
+    char buf[ 4096 ];
+    while( ! c->eof && c->out.size() - c->sent < OUT_LIMIT ) {
+        ssize_t n = read( c->fd, buf, sizeof( buf ) );
+        if( n == 0 ) {
+            c->eof = true;
+            break;
+        }
+        if( n < 0 ) {
+            if( errno == EINTR ) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        for( ssize_t i=0; i < n; i++ ) {
+            if( buf[i] == '\n' ) {
+                c->inRequest = false;
+                c->queue( c->session.getFrame() );
+            } else {
+                int key = SessionServer::keyOf( buf[i] );
+                if( key >= 0 ) {
+                    c->inRequest = true;
+                    c->session.publish( key );
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief EventLoop::flush sends pending output. If output remains, the
+ * connection waits for the socket to become writable. Reading is paused
+ * while pending output exceeds OUT_LIMIT and stops at the end of input.
+ * @param c connection.
+ * @return false if the connection has failed or all output has been sent
+ * after the end of input, i.e. the connection is to be closed.
+ */
+bool SessionServer::EventLoop::flush( Connection *c ) {
+    while( c->sent < c->out.size() ) {
+        ssize_t n = send( c->fd, c->out.data() + c->sent, c->out.size() - c->sent, MSG_NOSIGNAL );
+        if( n < 0 ) {
+            if( errno == EINTR ) {
+                continue;
+            }
+            if( errno != EAGAIN && errno != EWOULDBLOCK ) {
+                return false;
+            }
+            break;
+        }
+        c->sent += size_t( n );
+    }
+    if( c->sent == c->out.size() ) {
+        c->out.clear();
+        c->sent = 0;
+    }
+    if( c->eof && c->out.empty() ) {
+        return false;
+    }
+    uint32_t events = 0;
+    events |= ! c->eof && c->out.size() - c->sent < OUT_LIMIT? uint32_t( EPOLLIN | EPOLLRDHUP ) : 0;
+    events |= c->out.empty()? 0 : uint32_t( EPOLLOUT );
+    if( events != c->events ) {
+        c->events = events;
+        epoll_event ev = {};
+        ev.events = events;
+        ev.data.ptr = c;
+        epoll_ctl( epfd, EPOLL_CTL_MOD, c->fd, &ev );
+    }
+    return true;
+}
+
+void SessionServer::EventLoop::close( Connection *c ) {
+    if( c->isDirty ) {
+        dirty.erase( find( dirty.begin(), dirty.end(), c ) );
+    }
+    epoll_ctl( epfd, EPOLL_CTL_DEL, c->fd, nullptr );
+    connections.erase( c );
+    delete c;
+}
+
+
+SessionServer::~SessionServer() {
+    if( listenFd >= 0 ) {
+        ::close( listenFd );
+        unlink( path.c_str() );
+    }
+}
+
+
+/**
+ * @brief SessionServer::serve binds the socket and runs the event loops
+ * until stop() is invoked. Loop 0 runs in the calling thread.
+ * @return false if the socket could not be bound.
+ */
+bool SessionServer::serve() {
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if( path.size() >= sizeof( addr.sun_path ) ) {
+        cerr << "socket path too long: " << path << endl;
+        return false;
+    }
+    strcpy( addr.sun_path, path.c_str() );
+    unlink( path.c_str() );
+    listenFd = socket( AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0 );
+    if( listenFd < 0 || bind( listenFd, reinterpret_cast<sockaddr *>( &addr ), sizeof( addr ) ) < 0 ||
+        ::listen( listenFd, SOMAXCONN ) < 0 )
+    {
+        cerr << "cannot listen on " << path << ": " << strerror( errno ) << endl;
+        return false;
+    }
+    cout << "Serving sessions on " << path << " with " << threads << " threads." << endl;
+
+    running = true;
+    vector<EventLoop *> loops;
+    vector<thread> pool;
+    for( unsigned i=0; i < threads; i++ ) {
+        loops.push_back( new EventLoop( *this, i ) );
+    }
+    for( unsigned i=1; i < threads; i++ ) {
+        pool.push_back( thread( &EventLoop::run, loops[i] ) );
+    }
+    loops[0]->run();
+    for( vector<thread>::iterator it = pool.begin(); it != pool.end(); it++ ) {
+        it->join();
+    }
+    for( unsigned i=0; i < threads; i++ ) {
+        delete loops[i];
+    }
+    return true;
+}
+
+
+static SessionServer *signalled = nullptr;
+
+static void onSignal( int ) {
+    if( signalled != nullptr ) {
+        signalled->stop();
+    }
+}
+
+/**
+ * @brief SessionServer::run serves sessions in a headless application
+ * until SIGINT or SIGTERM is received.
+ * @param path of Unix domain socket.
+ * @param threads number of event loop threads.
+ * @param build options of components built.
+ * @return exit code.
+ */
+int SessionServer::run( const string& path, unsigned threads, const BuildConfig& build ) {
+    Headless headless;
+    headless.launch( build );
+    SessionServer server( path, threads );
+    signalled = &server;
+    signal( SIGINT, onSignal );
+    signal( SIGTERM, onSignal );
+    bool ok = server.serve();
+    signalled = nullptr;
+    headless.shutdown();
+    return ok? 0 : 1;
+}
+
+
+/**
+ * @brief SessionServer::keyOf maps a protocol character to a key event.
+ * @param c protocol character.
+ * @return GuiFacade::KeyEvt or -1 if c is not a key.
+ */
+int SessionServer::keyOf( char c ) {
+    if( c >= '0' && c <= '9' ) {
+        return GuiFacade::K0 + ( c - '0' );
+    }
+    switch( c ) {
+    case ',':
+    case '.': return GuiFacade::Comma;
+    case 'T': return GuiFacade::K000;
+    case '+': return GuiFacade::Plus;
+    case '-': return GuiFacade::Minus;
+    case '*': return GuiFacade::Mul;
+    case '/': return GuiFacade::Div;
+    case '%': return GuiFacade::Percent;
+    case 'V': return GuiFacade::VAT;
+    case '=': return GuiFacade::EQ;
+    case 'B': return GuiFacade::BS;
+    case 'C': return GuiFacade::C;
+    case 'E': return GuiFacade::CE;
+    case 'M': return GuiFacade::Mode;
+    case 'S': return GuiFacade::Start;
+    case 'P': return GuiFacade::Stop;
+    case '(': return GuiFacade::ParOpen;
+    case ')': return GuiFacade::ParClose;
+    case 'U': return GuiFacade::Undo;
+    case 'R': return GuiFacade::Redo;
+    case 'Q': return GuiFacade::Sqrt;
+    case 'W': return GuiFacade::Square;
+    case 'I': return GuiFacade::Recip;
+    case 'L': return GuiFacade::Ln;
+    case 'X': return GuiFacade::Exp;
+    case 'N': return GuiFacade::Sin;
+    case 'O': return GuiFacade::Cos;
+    case '^': return GuiFacade::Pow;
+    case 'K': return GuiFacade::Category;
+    }
+    return -1;
+}
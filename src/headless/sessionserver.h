@@ -0,0 +1,78 @@
+#ifndef SESSIONSERVER_H
+#define SESSIONSERVER_H
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+using namespace std;
+struct BuildConfig;
+
+
+/**
+ * @brief SessionServer serves calculator sessions to thin front-ends on
+ * the same machine over a Unix domain socket (Linux only). Each client
+ * connection gets its own Session.
+ *
+ * On connect, the server sends the initial display of the session.
+ * Line protocol: clients send key events as one character per key
+ * (digits, ',' or '.', 'T' for 000, '+', '-', '*', '/', '%', 'V' for VAT,
+ * '=', 'B' for backspace, 'C', 'E' for CE, 'M' for mode, 'S' for start,
+ * 'P' for stop, '(' and ')', 'U' for undo, 'R' for redo, 'Q' for square
+ * root, 'W' for square, 'I' for 1/x, 'L' for ln, 'X' for exp, 'N' for sin,
+ * 'O' for cos, '^' for power, 'K' for VAT category). Other characters are
+ * ignored. Requests are terminated by a newline and can be pipelined. For
+ * each request, the server answers with one line containing the display
+ * after the last key of the request. Display changes caused by timers
+ * (countdowns) are streamed to the client as additional lines.
+ *
+ * The server runs a number of event loop threads, each with its own
+ * epoll instance and timer wheel. The listening socket is shared by all
+ * loops (EPOLLEXCLUSIVE), a client stays on the loop that accepted it.
+ */
+class SessionServer {
+
+  public:
+    /**
+     * @brief SessionServer constructor.
+     * @param path of Unix domain socket.
+     * @param threads number of event loop threads.
+     */
+    SessionServer( const string path, unsigned threads = 1 )
+        : path( path ), threads( threads > 0? threads : 1 ), running( false ) {}
+    ~SessionServer();
+
+    /**
+     * @brief serve binds the socket and runs the event loops until stop()
+     * is invoked. Requires a built application (e.g. Headless::launch()).
+     * @return false if the socket could not be bound.
+     */
+    bool serve();
+    void stop() { running = false; }
+
+    /**
+     * @brief run serves sessions in a headless application until SIGINT
+     * or SIGTERM is received. Invoked from main() for option --server.
+     * @param path of Unix domain socket.
+     * @param threads number of event loop threads.
+     * @param build options of components built.
+     * @return exit code.
+     */
+    static int run( const string& path, unsigned threads, const BuildConfig& build );
+
+    /**
+     * @brief keyOf maps a protocol character to a key event.
+     * @param c protocol character.
+     * @return GuiFacade::KeyEvt or -1 if c is not a key.
+     */
+    static int keyOf( char c );
+
+  private:
+    class EventLoop;
+
+    const string path;
+    const unsigned threads;
+    int listenFd = -1;
+    atomic<bool> running;
+};
+
+#endif // SESSIONSERVER_H
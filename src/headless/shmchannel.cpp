@@ -0,0 +1,252 @@
+#include <stdexcept>
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "shmchannel.h"
+#include "headless.h"
+#include "builder.h"
+#include "guifacade.h"
+#include "timerwheel.h"
+
+
+/**
+ * @brief futex wait and wake on a 32-bit word in shared memory.
+ */
+static void futexWait( atomic<uint32_t>& word, uint32_t expected, int msec ) {
+    timespec ts = { msec / 1000, ( msec % 1000 ) * 1000000L };
+    syscall( SYS_futex, reinterpret_cast<uint32_t *>( &word ), FUTEX_WAIT, expected, &ts, nullptr, 0 );
+}
+
+static void futexWake( atomic<uint32_t>& word ) {
+    syscall( SYS_futex, reinterpret_cast<uint32_t *>( &word ), FUTEX_WAKE, 1, nullptr, nullptr, 0 );
+}
+
+
+/**
+ * @brief SpscRing::push appends an element (producer only). The consumer
+ * is woken up only if it has announced to sleep in wait().
+ * @param e element.
+ * @return false if the ring is full.
+ */
+template <typename T, uint32_t N>
+bool SpscRing<T, N>::push( const T& e ) {
+    uint32_t h = head.load( memory_order_relaxed );
+    if( h - tail.load( memory_order_acquire ) >= N ) {
+        return false;
+    }
+    elements[ h & ( N - 1 ) ] = e;
+    head.store( h + 1, memory_order_seq_cst );
+    if( sleeping.load( memory_order_seq_cst ) ) {
+        sleeping.store( 0, memory_order_relaxed );
+        futexWake( head );
+    }
+    return true;
+}
+
+/**
+ * @brief SpscRing::pop removes the oldest element (consumer only).
+ * @param e element removed.
+ * @return false if the ring is empty.
+ */
+template <typename T, uint32_t N>
+bool SpscRing<T, N>::pop( T& e ) {
+    uint32_t t = tail.load( memory_order_relaxed );
+    if( t == head.load( memory_order_acquire ) ) {
+        return false;
+    }
+    e = elements[ t & ( N - 1 ) ];
+    tail.store( t + 1, memory_order_release );
+    return true;
+}
+
+/**
+ * @brief SpscRing::wait blocks the consumer until the ring is not empty
+ * or 'msec' have passed. The consumer announces to sleep before checking
+ * the ring again, such that a concurrent push() either is seen or wakes
+ * the consumer.
+ * @param msec timeout in msec.
+ * @return true if the ring is not empty.
+ */
+template <typename T, uint32_t N>
+bool SpscRing<T, N>::wait( int msec ) {
+    uint32_t t = tail.load( memory_order_relaxed );
+    uint32_t h = head.load( memory_order_acquire );
+    if( h == t && msec > 0 ) {
+        sleeping.store( 1, memory_order_seq_cst );
+        h = head.load( memory_order_seq_cst );
+        if( h == t ) {
+            futexWait( head, h, msec );
+        }
+        sleeping.store( 0, memory_order_relaxed );
+    }
+    return head.load( memory_order_acquire ) != t;
+}
+
+
+/**
+ * @brief ShmChannel constructor creates or attaches a shared-memory
+ * region. A created region is zero-filled, which initializes both rings
+ * as empty.
+ * @param name of region, e.g. "/calculator".
+ * @param create create (calculator side) or attach (front-end side).
+ * @throws runtime_error if the region cannot be created or attached.
+ */
+ShmChannel::ShmChannel( const string name, bool create ) : name( name ), owner( create ) {
+    int fd = create? shm_open( name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600 )
+                   : shm_open( name.c_str(), O_RDWR, 0 );
+    if( fd < 0 ) {
+        throw runtime_error( "cannot open shared memory " + name + ": " + strerror( errno ) );
+    }
+    if( create && ftruncate( fd, sizeof( Region ) ) < 0 ) {
+        ::close( fd );
+        throw runtime_error( "cannot size shared memory " + name + ": " + strerror( errno ) );
+    }
+    void *p = mmap( nullptr, sizeof( Region ), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    ::close( fd );
+    if( p == MAP_FAILED ) {
+        throw runtime_error( "cannot map shared memory " + name + ": " + strerror( errno ) );
+    }
+    region = static_cast<Region *>( p );
+    if( create ) {
+        region->version = VERSION;
+        region->magic = MAGIC;
+    } else if( region->magic != MAGIC || region->version != VERSION ) {
+        munmap( region, sizeof( Region ) );
+        throw runtime_error( "no calculator channel or unsupported version: " + name );
+    }
+}
+
+ShmChannel::~ShmChannel() {
+    munmap( region, sizeof( Region ) );
+    if( owner ) {
+        shm_unlink( name.c_str() );
+    }
+}
+
+
+/**
+ * @brief Front-end side: ShmChannel::pushKey passes a key event to the
+ * calculator, popFrame and waitFrame receive display frames.
+ * @param key input event as GuiFacade::KeyEvt.
+ * @return false if the key ring is full.
+ */
+bool ShmChannel::pushKey( int key ) {
+    return region->keys.push( uint8_t( key ) );
+}
+
+bool ShmChannel::popFrame( SegmentFrame& f ) {
+    return region->frames.pop( f );
+}
+
+bool ShmChannel::waitFrame( int msec ) {
+    return region->frames.wait( msec );
+}
+
+uint32_t ShmChannel::getDroppedFrames() const {
+    return region->frames.getDropped();
+}
+
+
+/**
+ * @brief Calculator side: ShmChannel::popKey and waitKey receive key
+ * events. The region is writable by any front-end, so bytes which are
+ * no GuiFacade::KeyEvt are dropped here, before events are built.
+ * @param key input event removed.
+ * @return true if a key event was received or is pending.
+ */
+bool ShmChannel::popKey( uint8_t& key ) {
+    while( region->keys.pop( key ) ) {
+        if( key <= GuiFacade::Category ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ShmChannel::waitKey( int msec ) {
+    return region->keys.wait( msec );
+}
+
+/**
+ * @brief ShmChannel::pushFrame passes a display frame to the front-end.
+ * A frame is dropped and counted if the front-end does not keep up.
+ * @param f display frame.
+ */
+void ShmChannel::pushFrame( const SegmentFrame& f ) {
+    if( ! region->frames.push( f ) ) {
+        region->frames.drop();
+    }
+}
+
+
+/**
+ * @brief ShmDisplay is the display backend of the calculator side that
+ * mirrors frames rendered by GuiFacade into the frame ring.
+ */
+class ShmDisplay : public DisplayBackendIntf {
+
+  public:
+    ShmDisplay( ShmChannel& channel ) : channel( channel ) {}
+    void render( const SegmentFrame& f ) { channel.pushFrame( f ); }
+
+  private:
+    ShmChannel& channel;
+};
+
+
+static volatile sig_atomic_t stopped = 0;
+
+static void onSignal( int ) {
+    stopped = 1;
+}
+
+/**
+ * @brief ShmChannel::run serves the channel in a headless application
+ * until SIGINT or SIGTERM is received. Keys are processed as they arrive.
+ * When no key is pending, the loop advances timers and waits for keys
+ * until the next timer expires, at most 100 msec.
+ * @param name of region.
+ * @param build options of components built.
+ * @return exit code.
+ */
+int ShmChannel::run( const string& name, const BuildConfig& build ) {
+    try {
+        ShmChannel channel( name, true );
+        ShmDisplay display( channel );
+        Headless headless;
+        headless.launch( build );
+        GuiFacade *gui = headless.getBuilder().getGui();
+        gui->setMirror( &display );
+        display.render( gui->getFrame() );
+        cout << "Serving calculator on shared memory " << name << "." << endl;
+
+        signal( SIGINT, onSignal );
+        signal( SIGTERM, onSignal );
+        TimerWheel& wheel = headless.getWheel();
+        uint8_t key;
+        while( ! stopped ) {
+            while( channel.popKey( key ) ) {
+                headless.publish( key );
+            }
+            wheel.advance();
+            uint64_t next = wheel.nextExpiry();
+            uint64_t now = wheel.now();
+            int msec = next == UINT64_MAX || next > now + 100? 100 : next > now? int( next - now ) : 0;
+            channel.waitKey( msec );
+        }
+        gui->setMirror( nullptr );
+        headless.shutdown();
+
+    } catch( exception& e ) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,130 @@
+#ifndef SHMCHANNEL_H
+#define SHMCHANNEL_H
+
+#include <iostream>
+#include <atomic>
+#include <cstdint>
+#include "segmentframe.h"
+using namespace std;
+struct BuildConfig;
+
+
+/**
+ * @brief SpscRing is a lock-free single-producer/single-consumer ring of
+ * N slots (N a power of 2) that can be placed in shared memory. Producer
+ * and consumer each own one index on a separate cache line. A consumer
+ * that finds the ring empty can sleep in wait(), which uses a futex on
+ * the producer index. The producer only issues a wake-up system call when
+ * the consumer has announced that it sleeps, such that handing over an
+ * element costs no system call while the consumer is busy.
+ */
+template <typename T, uint32_t N>
+class SpscRing {
+    static_assert( ( N & ( N - 1 ) ) == 0, "N must be a power of 2" );
+
+  public:
+    /**
+     * @brief push appends an element (producer only).
+     * @param e element.
+     * @return false if the ring is full.
+     */
+    bool push( const T& e );
+
+    /**
+     * @brief pop removes the oldest element (consumer only).
+     * @param e element removed.
+     * @return false if the ring is empty.
+     */
+    bool pop( T& e );
+
+    /**
+     * @brief wait blocks the consumer until the ring is not empty or
+     * 'msec' have passed.
+     * @param msec timeout in msec.
+     * @return true if the ring is not empty.
+     */
+    bool wait( int msec );
+
+    bool empty() const { return head.load( memory_order_acquire ) == tail.load( memory_order_relaxed ); }
+    uint32_t getDropped() const { return dropped.load( memory_order_relaxed ); }
+    void drop() { dropped.fetch_add( 1, memory_order_relaxed ); }
+
+  private:
+    alignas( 64 ) atomic<uint32_t> head;        // next slot written by producer, futex word
+    alignas( 64 ) atomic<uint32_t> tail;        // next slot read by consumer
+    atomic<uint32_t> sleeping;                  // consumer sleeps in wait()
+    atomic<uint32_t> dropped;                   // elements dropped by producer when full
+    alignas( 64 ) T elements[ N ];
+};
+
+
+/**
+ * @brief ShmChannel couples a co-located front-end, such as a hardware
+ * keypad daemon, with the calculator core through a shared-memory region
+ * created by shm_open() (Linux only). The region holds two SpscRings:
+ * key events from the front-end to the calculator and display frames
+ * from the calculator to the front-end.
+ *
+ * On the calculator side, keys are published through GuiFacade like keypad
+ * events and frames are taken from GuiFacade as mirror of Ui::Display. The
+ * front-end uses pushKey() and popFrame(), waitFrame() when idle.
+ */
+class ShmChannel {
+
+  public:
+    static const uint32_t KEY_SLOTS = 4096;
+    static const uint32_t FRAME_SLOTS = 1024;
+
+    /**
+     * @brief ShmChannel constructor creates or attaches a shared-memory
+     * region.
+     * @param name of region, e.g. "/calculator".
+     * @param create create (calculator side) or attach (front-end side).
+     * @throws runtime_error if the region cannot be created or attached.
+     */
+    ShmChannel( const string name, bool create );
+    ~ShmChannel();
+
+    /**
+     * @brief Front-end side: push key events, pop and wait for frames.
+     */
+    bool pushKey( int key );
+    bool popFrame( SegmentFrame& f );
+    bool waitFrame( int msec );
+
+    /**
+     * @brief Calculator side: pop and wait for key events, push frames.
+     * A frame is dropped and counted if the front-end does not keep up.
+     */
+    bool popKey( uint8_t& key );
+    bool waitKey( int msec );
+    void pushFrame( const SegmentFrame& f );
+
+    uint32_t getDroppedFrames() const;
+
+    /**
+     * @brief run serves the channel in a headless application until SIGINT
+     * or SIGTERM is received. Invoked from main() for option --shm.
+     * @param name of region.
+     * @param build options of components built.
+     * @return exit code.
+     */
+    static int run( const string& name, const BuildConfig& build );
+
+  private:
+    struct Region {
+        uint32_t magic;
+        uint32_t version;
+        SpscRing<uint8_t, KEY_SLOTS> keys;              // front-end -> calculator
+        SpscRing<SegmentFrame, FRAME_SLOTS> frames;     // calculator -> front-end
+    };
+
+    static const uint32_t MAGIC = 0x53453243;       // "SE2C"
+    static const uint32_t VERSION = 1;
+
+    const string name;
+    const bool owner;       // region was created and is unlinked on destruction
+    Region *region = nullptr;
+};
+
+#endif // SHMCHANNEL_H
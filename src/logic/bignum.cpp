@@ -0,0 +1,676 @@
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "bignum.h"
+
+typedef vector<uint32_t> Mag;
+
+static const uint32_t POW10[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+};
+
+static int64_t pow10i( unsigned k ) {
+    int64_t p = 1;
+    while( k-- > 0 ) {
+        p *= 10;
+    }
+    return p;
+}
+
+static unsigned digitsOf( uint64_t v ) {
+    unsigned n = 1;
+    while( v >= 10 ) {
+        v /= 10;
+        n++;
+    }
+    return n;
+}
+
+
+/*
+ * Magnitudes are vectors of limbs in base BASE, least significant first.
+ * Results are trimmed, i.e. have no leading zero limbs; zero is empty.
+ */
+
+static void trim( Mag& m ) {
+    while( ! m.empty() && m.back() == 0 ) {
+        m.pop_back();
+    }
+}
+
+static int cmpMag( const Mag& a, const Mag& b ) {
+    if( a.size() != b.size() ) {
+        return a.size() < b.size()? -1 : 1;
+    }
+    for( size_t i = a.size(); i-- > 0; ) {
+        if( a[i] != b[i] ) {
+            return a[i] < b[i]? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+static Mag addMag( const uint32_t *a, size_t na, const uint32_t *b, size_t nb ) {
+    if( na < nb ) {
+        swap( a, b );
+        swap( na, nb );
+    }
+    Mag r( na + 1 );
+    uint32_t carry = 0;
+    for( size_t i=0; i < na; i++ ) {
+        uint32_t s = a[i] + ( i < nb? b[i] : 0 ) + carry;
+        carry = s >= BigInt::BASE;
+        r[i] = carry? s - BigInt::BASE : s;
+    }
+    r[ na ] = carry;
+    trim( r );
+    return r;
+}
+
+/**
+ * @brief subMag subtracts 'b' from 'a' in place, a >= b.
+ */
+static void subMag( Mag& a, const Mag& b ) {
+    uint32_t borrow = 0;
+    for( size_t i=0; i < a.size() && ( i < b.size() || borrow ); i++ ) {
+        uint32_t s = ( i < b.size()? b[i] : 0 ) + borrow;
+        borrow = a[i] < s;
+        a[i] = borrow? a[i] + BigInt::BASE - s : a[i] - s;
+    }
+    trim( a );
+}
+
+/**
+ * @brief addShifted adds x * BASE^off to 'r', which must be large enough
+ * to hold the sum.
+ */
+static void addShifted( Mag& r, const Mag& x, size_t off ) {
+    uint32_t carry = 0;
+    size_t i = 0;
+    for( ; i < x.size() || carry; i++ ) {
+        uint32_t s = r[ off + i ] + ( i < x.size()? x[i] : 0 ) + carry;
+        carry = s >= BigInt::BASE;
+        r[ off + i ] = carry? s - BigInt::BASE : s;
+    }
+}
+
+static Mag mulSmall( const Mag& a, uint32_t m ) {
+    Mag r( a.size() + 1 );
+    uint64_t carry = 0;
+    for( size_t i=0; i < a.size(); i++ ) {
+        uint64_t t = uint64_t( a[i] ) * m + carry;
+        r[i] = uint32_t( t % BigInt::BASE );
+        carry = t / BigInt::BASE;
+    }
+    r[ a.size() ] = uint32_t( carry );
+    trim( r );
+    return r;
+}
+
+static Mag divSmall( const Mag& a, uint32_t d, uint32_t& rem ) {
+    Mag q( a.size() );
+    uint64_t r = 0;
+    for( size_t i = a.size(); i-- > 0; ) {
+        uint64_t cur = r * BigInt::BASE + a[i];
+        q[i] = uint32_t( cur / d );
+        r = cur % d;
+    }
+    rem = uint32_t( r );
+    trim( q );
+    return q;
+}
+
+/**
+ * @brief mulSchool multiplies by rows, each row is carried at once such
+ * that 64-bit intermediates cannot overflow.
+ */
+static Mag mulSchool( const uint32_t *a, size_t na, const uint32_t *b, size_t nb ) {
+    Mag r( na + nb );
+    for( size_t i=0; i < na; i++ ) {
+        uint64_t ai = a[i], carry = 0;
+        if( ai == 0 ) {
+            continue;
+        }
+        for( size_t j=0; j < nb; j++ ) {
+            uint64_t t = r[ i + j ] + ai * b[j] + carry;
+            r[ i + j ] = uint32_t( t % BigInt::BASE );
+            carry = t / BigInt::BASE;
+        }
+        r[ i + nb ] = uint32_t( carry );
+    }
+    trim( r );
+    return r;
+}
+
+/**
+ * @brief mulMag multiplies by schoolbook multiplication below
+ * KARATSUBA_LIMBS, else by Karatsuba: with a = a1 B^m + a0 and b = b1 B^m
+ * + b0, a b = z2 B^2m + z1 B^m + z0 where z0 = a0 b0, z2 = a1 b1 and z1 =
+ * (a0 + a1)(b0 + b1) - z0 - z2, i.e. three instead of four products.
+ * Unbalanced operands are multiplied in slices of the shorter one.
+ */
+static Mag mulMag( const uint32_t *a, size_t na, const uint32_t *b, size_t nb ) {
+    while( na > 0 && a[ na - 1 ] == 0 ) {
+        na--;
+    }
+    while( nb > 0 && b[ nb - 1 ] == 0 ) {
+        nb--;
+    }
+    if( na == 0 || nb == 0 ) {
+        return Mag();
+    }
+    if( na < nb ) {
+        swap( a, b );
+        swap( na, nb );
+    }
+    if( nb < BigInt::KARATSUBA_LIMBS ) {
+        return mulSchool( a, na, b, nb );
+    }
+    Mag r( na + nb );
+    if( 2 * nb <= na ) {
+        for( size_t off=0; off < na; off += nb ) {
+            addShifted( r, mulMag( a + off, min( nb, na - off ), b, nb ), off );
+        }
+        trim( r );
+        return r;
+    }
+    size_t m = na / 2;                  // nb > m
+    Mag z0 = mulMag( a, m, b, m );
+    Mag z2 = mulMag( a + m, na - m, b + m, nb - m );
+    Mag sa = addMag( a, m, a + m, na - m );
+    Mag sb = addMag( b, m, b + m, nb - m );
+    Mag z1 = mulMag( sa.data(), sa.size(), sb.data(), sb.size() );
+    subMag( z1, z0 );
+    subMag( z1, z2 );
+    addShifted( r, z0, 0 );
+    addShifted( r, z1, m );
+    addShifted( r, z2, 2 * m );
+    trim( r );
+    return r;
+}
+
+/**
+ * @brief divMag divides magnitudes by Knuth's algorithm D (TAOCP 4.3.1).
+ * Operands are normalised such that the top limb of the divisor is at
+ * least BASE/2, then each quotient limb is estimated from the top two
+ * limbs of the remainder and corrected at most twice.
+ */
+static void divMag( const Mag& u, const Mag& v, Mag& q, Mag& r ) {
+    if( cmpMag( u, v ) < 0 ) {
+        q.clear();
+        r = u;
+        return;
+    }
+    uint32_t rem;
+    if( v.size() == 1 ) {
+        q = divSmall( u, v[0], rem );
+        r = rem > 0? Mag( 1, rem ) : Mag();
+        return;
+    }
+    const uint64_t B = BigInt::BASE;
+    size_t n = v.size(), m = u.size() - n;
+    uint32_t d = uint32_t( B / ( uint64_t( v.back() ) + 1 ) );
+    Mag un = mulSmall( u, d );
+    Mag vn = mulSmall( v, d );
+    un.resize( u.size() + 1, 0 );
+    q.assign( m + 1, 0 );
+    for( size_t j = m + 1; j-- > 0; ) {
+        uint64_t num = uint64_t( un[ j + n ] ) * B + un[ j + n - 1 ];
+        uint64_t qhat = num / vn[ n - 1 ], rhat = num % vn[ n - 1 ];
+        while( qhat >= B || qhat * vn[ n - 2 ] > rhat * B + un[ j + n - 2 ] ) {
+            qhat--;
+            rhat += vn[ n - 1 ];
+            if( rhat >= B ) {
+                break;
+            }
+        }
+        int64_t borrow = 0;
+        uint64_t carry = 0;
+        for( size_t i=0; i < n; i++ ) {
+            uint64_t p = qhat * vn[i] + carry;
+            carry = p / B;
+            int64_t t = int64_t( un[ i + j ] ) - int64_t( p % B ) - borrow;
+            borrow = t < 0;
+            un[ i + j ] = uint32_t( t < 0? t + int64_t( B ) : t );
+        }
+        int64_t t = int64_t( un[ j + n ] ) - int64_t( carry ) - borrow;
+        if( t < 0 ) {                   // qhat was one too large, add back
+            qhat--;
+            uint64_t c = 0;
+            for( size_t i=0; i < n; i++ ) {
+                uint64_t s = uint64_t( un[ i + j ] ) + vn[i] + c;
+                un[ i + j ] = uint32_t( s % B );
+                c = s / B;
+            }
+            t += int64_t( c );
+        }
+        un[ j + n ] = uint32_t( t );
+        q[j] = uint32_t( qhat );
+    }
+    trim( q );
+    un.resize( n );
+    trim( un );
+    r = divSmall( un, d, rem );
+}
+
+
+BigInt::BigInt( int64_t v ) {
+    if( v >= -SMALL_MAX && v <= SMALL_MAX ) {
+        small = v;
+    } else {
+        uint64_t m = v < 0? 0 - uint64_t( v ) : uint64_t( v );
+        for( ; m > 0; m /= BASE ) {
+            limbs.push_back( uint32_t( m % BASE ) );
+        }
+        negative = v < 0;
+    }
+}
+
+BigInt::Mag BigInt::magnitude( const BigInt& a ) {
+    if( ! a.limbs.empty() ) {
+        return a.limbs;
+    }
+    Mag m;
+    for( uint64_t v = uint64_t( a.small < 0? -a.small : a.small ); v > 0; v /= BASE ) {
+        m.push_back( uint32_t( v % BASE ) );
+    }
+    return m;
+}
+
+/**
+ * @brief BigInt::make returns a magnitude with sign, inline if it has at
+ * most two limbs.
+ */
+BigInt BigInt::make( Mag&& m, bool negative ) {
+    trim( m );
+    BigInt r;
+    if( m.size() <= 2 ) {
+        int64_t v = m.empty()? 0 : m.size() == 1? int64_t( m[0] ) : int64_t( m[1] ) * BASE + m[0];
+        r.small = negative? -v : v;
+    } else {
+        r.limbs = move( m );
+        r.negative = negative;
+    }
+    return r;
+}
+
+
+BigInt BigInt::parse( const string& s ) {
+    size_t i = s.length() > 0 && ( s[0] == '-' || s[0] == '+' )? 1 : 0;
+    if( i == s.length() || s.find_first_not_of( "0123456789", i ) != string::npos ) {
+        throw invalid_argument( "not an integer: " + s );
+    }
+    size_t first = s.find_first_not_of( '0', i );
+    if( first == string::npos ) {
+        return BigInt();
+    }
+    bool neg = s[0] == '-';
+    if( s.length() - first <= 18 ) {
+        int64_t v = strtoll( s.c_str() + first, nullptr, 10 );
+        return BigInt( neg? -v : v );
+    }
+    Mag m;
+    for( size_t end = s.length(); end > first; end = end >= first + 9? end - 9 : first ) {
+        size_t begin = end >= first + 9? end - 9 : first;
+        uint32_t limb = 0;
+        for( size_t k = begin; k < end; k++ ) {
+            limb = limb * 10 + uint32_t( s[k] - '0' );
+        }
+        m.push_back( limb );
+    }
+    return make( move( m ), neg );
+}
+
+BigInt BigInt::pow10( unsigned k ) {
+    return BigInt( 1 ).shift( int( k ) );
+}
+
+string BigInt::toString() const {
+    if( limbs.empty() ) {
+        return to_string( small );
+    }
+    string s = negative? "-" : "";
+    s += to_string( limbs.back() );
+    char buf[ 16 ];
+    for( size_t i = limbs.size() - 1; i-- > 0; ) {
+        sprintf( buf, "%09u", limbs[i] );
+        s += buf;
+    }
+    return s;
+}
+
+/**
+ * @brief BigInt::toDouble returns the nearest double, inf if out of range.
+ * Values of more than 18 digits are converted by strtod(), which
+ * rounds correctly; scaling rounded limbs by a power of ten would not.
+ */
+double BigInt::toDouble() const {
+    if( limbs.empty() ) {
+        return double( small );
+    }
+    return strtod( toString().c_str(), nullptr );
+}
+
+size_t BigInt::digits() const {
+    if( limbs.empty() ) {
+        return digitsOf( uint64_t( small < 0? -small : small ) );
+    }
+    return 9 * ( limbs.size() - 1 ) + digitsOf( limbs.back() );
+}
+
+size_t BigInt::trailingZeros() const {
+    if( isZero() ) {
+        return 0;
+    }
+    size_t n = 0;
+    if( limbs.empty() ) {
+        for( int64_t v = small; v % 10 == 0; v /= 10 ) {
+            n++;
+        }
+        return n;
+    }
+    size_t i = 0;
+    for( ; limbs[i] == 0; i++ ) {
+        n += 9;
+    }
+    for( uint32_t v = limbs[i]; v % 10 == 0; v /= 10 ) {
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief BigInt::shift scales by a power of ten in linear time: whole
+ * limbs are inserted or removed, the remaining digits are multiplied or
+ * divided by a single limb.
+ */
+BigInt BigInt::shift( int k ) const {
+    if( k == 0 || isZero() ) {
+        return *this;
+    }
+    if( k > 0 ) {
+        if( limbs.empty() && digits() + size_t( k ) <= 18 ) {
+            return BigInt( small * pow10i( unsigned( k ) ) );
+        }
+        Mag m = mulSmall( magnitude( *this ), POW10[ k % 9 ] );
+        m.insert( m.begin(), size_t( k / 9 ), 0 );
+        return make( move( m ), sign() < 0 );
+    }
+    size_t n = size_t( -int64_t( k ) );
+    if( n >= digits() ) {
+        return BigInt();
+    }
+    if( limbs.empty() ) {
+        return BigInt( small / pow10i( unsigned( n ) ) );
+    }
+    Mag m( limbs.begin() + long( n / 9 ), limbs.end() );
+    uint32_t rem;
+    return make( divSmall( m, POW10[ n % 9 ], rem ), negative );
+}
+
+int BigInt::compare( const BigInt& b ) const {
+    if( limbs.empty() && b.limbs.empty() ) {
+        return ( small > b.small ) - ( small < b.small );
+    }
+    int sa = sign(), sb = b.sign();
+    if( sa != sb ) {
+        return sa < sb? -1 : 1;
+    }
+    int c = cmpMag( magnitude( *this ), magnitude( b ) );
+    return sa < 0? -c : c;
+}
+
+BigInt BigInt::operator-() const {
+    BigInt r = *this;
+    if( limbs.empty() ) {
+        r.small = -small;
+    } else {
+        r.negative = ! negative;
+    }
+    return r;
+}
+
+
+BigInt BigInt::addSigned( const BigInt& a, const BigInt& b, bool negateB ) {
+    if( a.limbs.empty() && b.limbs.empty() ) {
+        return BigInt( negateB? a.small - b.small : a.small + b.small );    // |sum| < 2 * 10^18
+    }
+    int sa = a.sign(), sb = negateB? -b.sign() : b.sign();
+    if( sb == 0 ) {
+        return a;
+    }
+    if( sa == 0 ) {
+        return negateB? -b : b;
+    }
+    Mag ma = magnitude( a ), mb = magnitude( b );
+    if( sa == sb ) {
+        return make( addMag( ma.data(), ma.size(), mb.data(), mb.size() ), sa < 0 );
+    }
+    int c = cmpMag( ma, mb );
+    if( c == 0 ) {
+        return BigInt();
+    }
+    if( c > 0 ) {
+        subMag( ma, mb );
+        return make( move( ma ), sa < 0 );
+    }
+    subMag( mb, ma );
+    return make( move( mb ), sb < 0 );
+}
+
+BigInt operator+( const BigInt& a, const BigInt& b ) {
+    return BigInt::addSigned( a, b, false );
+}
+
+BigInt operator-( const BigInt& a, const BigInt& b ) {
+    return BigInt::addSigned( a, b, true );
+}
+
+BigInt operator*( const BigInt& a, const BigInt& b ) {
+    int64_t r;
+    if( a.limbs.empty() && b.limbs.empty() && ! __builtin_mul_overflow( a.small, b.small, &r ) ) {
+        return BigInt( r );
+    }
+    BigInt::Mag ma = BigInt::magnitude( a ), mb = BigInt::magnitude( b );
+    return BigInt::make( mulMag( ma.data(), ma.size(), mb.data(), mb.size() ), a.sign() * b.sign() < 0 );
+}
+
+void BigInt::divmod( const BigInt& a, const BigInt& b, BigInt& q, BigInt& r ) {
+    if( b.isZero() ) {
+        throw domain_error( "div/0" );
+    }
+    if( a.limbs.empty() && b.limbs.empty() ) {
+        int64_t x = a.small, y = b.small;
+        q = BigInt( x / y );
+        r = BigInt( x % y );
+        return;
+    }
+    Mag mq, mr;
+    divMag( magnitude( a ), magnitude( b ), mq, mr );
+    bool neg = a.sign() < 0;
+    q = make( move( mq ), neg != ( b.sign() < 0 ) );
+    r = make( move( mr ), neg );
+}
+
+
+BigDecimal::BigDecimal( const BigInt& unscaled, int scale ) : unscaled( unscaled ), scale( scale ) {
+    normalize();
+}
+
+/**
+ * @brief BigDecimal::normalize removes trailing fractional zeros and
+ * converts a negative scale into an integer.
+ */
+void BigDecimal::normalize() {
+    if( unscaled.isZero() ) {
+        scale = 0;
+    } else if( scale < 0 ) {
+        unscaled = unscaled.shift( -scale );
+        scale = 0;
+    } else if( scale > 0 ) {
+        int n = int( min( unscaled.trailingZeros(), size_t( scale ) ) );
+        if( n > 0 ) {
+            unscaled = unscaled.shift( -n );
+            scale -= n;
+        }
+    }
+}
+
+BigDecimal BigDecimal::parse( const string& s ) {
+    static const long MAX_EXPONENT = 1000000;
+    size_t e = s.find_first_of( "eE" );
+    string mantissa = s.substr( 0, e );
+    long exponent = 0;
+    if( e != string::npos ) {
+        char *end;
+        exponent = strtol( s.c_str() + e + 1, &end, 10 );
+        if( *end != '\0' || end == s.c_str() + e + 1 || labs( exponent ) > MAX_EXPONENT ) {
+            throw invalid_argument( "not a decimal: " + s );
+        }
+    }
+    size_t dot = mantissa.find( '.' );
+    int fraction = 0;
+    if( dot != string::npos ) {
+        fraction = int( mantissa.length() - dot - 1 );
+        mantissa.erase( dot, 1 );
+    }
+    if( mantissa.empty() || mantissa == "-" || mantissa == "+" ) {
+        throw invalid_argument( "not a decimal: " + s );
+    }
+    return BigDecimal( BigInt::parse( mantissa ), fraction - int( exponent ) );
+}
+
+/**
+ * @brief BigDecimal::fromDouble converts the shortest decimal that reads
+ * back as 'd', e.g. 0.1 rather than 0.1000000000000000055511151231257827.
+ * @throws invalid_argument if 'd' is not finite.
+ */
+BigDecimal BigDecimal::fromDouble( double d ) {
+    if( ! std::isfinite( d ) ) {
+        throw invalid_argument( "not a finite number" );
+    }
+    char buf[ 32 ];
+    for( int precision = 15; precision <= 17; precision++ ) {
+        sprintf( buf, "%.*g", precision, d );
+        if( strtod( buf, nullptr ) == d ) {
+            break;
+        }
+    }
+    return parse( buf );
+}
+
+string BigDecimal::toString() const {
+    string digits = unscaled.toString();
+    bool neg = digits[0] == '-';
+    if( neg ) {
+        digits.erase( 0, 1 );
+    }
+    if( scale > 0 ) {
+        if( digits.length() <= size_t( scale ) ) {
+            digits.insert( 0, size_t( scale ) - digits.length() + 1, '0' );
+        }
+        digits.insert( digits.length() - size_t( scale ), 1, '.' );
+    }
+    return neg? "-" + digits : digits;
+}
+
+double BigDecimal::toDouble() const {
+    const int64_t EXACT = int64_t( 1 ) << 53;
+    int64_t v = unscaled.toInt64();
+    if( unscaled.isSmall() && v >= -EXACT && v <= EXACT && scale >= 0 && scale <= 22 ) {
+        return double( v ) / pow( 10.0, scale );                // exact operands, one rounding
+    }
+    return strtod( toString().c_str(), nullptr );
+}
+
+/**
+ * @brief stripZeros removes trailing fractional zeros and a trailing dot.
+ */
+static string stripZeros( string s ) {
+    if( s.find( '.' ) != string::npos ) {
+        s.erase( s.find_last_not_of( '0' ) + 1 );
+        if( s.back() == '.' ) {
+            s.pop_back();
+        }
+    }
+    return s;
+}
+
+string BigDecimal::format( size_t width ) const {
+    if( isZero() ) {
+        return "0";
+    }
+    string digits = unscaled.toString();
+    bool neg = digits[0] == '-';
+    if( neg ) {
+        digits.erase( 0, 1 );
+    }
+    string sign = neg? "-" : "";
+    long intDigits = long( digits.length() ) - scale;
+    if( intDigits > 0 && size_t( intDigits ) + sign.length() <= width ) {
+        size_t fraction = min( size_t( scale ), width - sign.length() - size_t( intDigits ) );
+        return stripZeros( sign + digits.substr( 0, size_t( intDigits ) ) + "." + digits.substr( size_t( intDigits ), fraction ) );
+    }
+    if( intDigits <= 0 && sign.length() + 2 + size_t( -intDigits ) <= width ) {
+        size_t zeros = size_t( -intDigits );
+        size_t fraction = width - sign.length() - 1 - zeros;
+        return stripZeros( sign + "0." + string( zeros, '0' ) + digits.substr( 0, fraction ) );
+    }
+    string exponent = "E" + to_string( intDigits - 1 );
+    size_t mantissa = width > sign.length() + exponent.length() + 1? width - sign.length() - exponent.length() : 1;
+    return stripZeros( sign + digits.substr( 0, 1 ) + "." + digits.substr( 1, mantissa - 1 ) ) + exponent;
+}
+
+
+/**
+ * @brief align returns the unscaled values of 'a' and 'b' at their common
+ * scale.
+ */
+static void align( const BigDecimal& a, const BigDecimal& b, BigInt& ua, BigInt& ub, int& scale ) {
+    scale = max( a.getScale(), b.getScale() );
+    ua = a.getUnscaled().shift( scale - a.getScale() );
+    ub = b.getUnscaled().shift( scale - b.getScale() );
+}
+
+BigDecimal operator+( const BigDecimal& a, const BigDecimal& b ) {
+    BigInt ua, ub;
+    int scale;
+    align( a, b, ua, ub, scale );
+    return BigDecimal( ua + ub, scale );
+}
+
+BigDecimal operator-( const BigDecimal& a, const BigDecimal& b ) {
+    BigInt ua, ub;
+    int scale;
+    align( a, b, ua, ub, scale );
+    return BigDecimal( ua - ub, scale );
+}
+
+BigDecimal operator*( const BigDecimal& a, const BigDecimal& b ) {
+    return BigDecimal( a.unscaled * b.unscaled, a.scale + b.scale );
+}
+
+/**
+ * @brief BigDecimal::divide scales the dividend such that the integer
+ * quotient has 'scale' fractional digits and rounds by the remainder.
+ */
+BigDecimal BigDecimal::divide( const BigDecimal& a, const BigDecimal& b, int scale ) {
+    if( b.isZero() ) {
+        throw domain_error( "div/0" );
+    }
+    int k = scale + b.scale - a.scale;
+    BigInt ua = k > 0? a.unscaled.shift( k ) : a.unscaled;
+    BigInt ub = k < 0? b.unscaled.shift( -k ) : b.unscaled;
+    BigInt q, r;
+    BigInt::divmod( ua, ub, q, r );
+    if( ! r.isZero() ) {
+        BigInt twice = r + r;
+        if( ( twice.sign() < 0? -twice : twice ).compare( ub.sign() < 0? -ub : ub ) >= 0 ) {
+            q = q + BigInt( a.sign() * b.sign() );
+        }
+    }
+    return BigDecimal( q, scale );
+}
@@ -0,0 +1,164 @@
+#ifndef BIGNUM_H
+#define BIGNUM_H
+
+#include <iostream>
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+
+/**
+ * @brief The BigInt class implements arbitrary-precision integers.
+ *
+ * Values of at most 18 decimal digits are held inline as int64_t without
+ * allocation. Larger values hold their magnitude in limbs of 9 decimal
+ * digits (base 10^9), least significant first, such that conversion from
+ * and to decimal text and scaling by powers of ten are linear. Products
+ * are computed by schoolbook multiplication below KARATSUBA_LIMBS limbs
+ * and by Karatsuba multiplication above. Division is Knuth's algorithm D.
+ */
+class BigInt {
+
+  public:
+    static const uint32_t BASE = 1000000000;        // limb base, 9 digits
+    static const size_t KARATSUBA_LIMBS = 32;       // Karatsuba threshold
+
+    BigInt( int64_t v = 0 );
+
+    /**
+     * @brief parse decimal digits with optional sign.
+     * @param s text, e.g. "-12345678901234567890".
+     * @return value.
+     * @throws invalid_argument if 's' is no integer.
+     */
+    static BigInt parse( const string& s );
+
+    /**
+     * @brief pow10 returns 10^k.
+     */
+    static BigInt pow10( unsigned k );
+
+    string toString() const;
+    double toDouble() const;
+
+    bool isSmall() const { return limbs.empty(); }
+    int64_t toInt64() const { return small; }       // if isSmall()
+    int sign() const { return limbs.empty()? ( small > 0 ) - ( small < 0 ) : negative? -1 : 1; }
+    bool isZero() const { return limbs.empty() && small == 0; }
+
+    /**
+     * @brief digits returns the number of decimal digits of the magnitude,
+     * 1 for zero.
+     */
+    size_t digits() const;
+
+    /**
+     * @brief trailingZeros returns the number of trailing decimal zeros,
+     * 0 for zero.
+     */
+    size_t trailingZeros() const;
+
+    /**
+     * @brief shift multiplies by 10^k for k > 0 and divides by 10^-k
+     * truncating towards zero for k < 0.
+     * @param k decimal digits.
+     * @return shifted value.
+     */
+    BigInt shift( int k ) const;
+
+    int compare( const BigInt& b ) const;
+    BigInt operator-() const;
+
+    friend BigInt operator+( const BigInt& a, const BigInt& b );
+    friend BigInt operator-( const BigInt& a, const BigInt& b );
+    friend BigInt operator*( const BigInt& a, const BigInt& b );
+    friend bool operator==( const BigInt& a, const BigInt& b ) { return a.compare( b ) == 0; }
+    friend bool operator<( const BigInt& a, const BigInt& b ) { return a.compare( b ) < 0; }
+
+    /**
+     * @brief divmod divides truncating towards zero, the remainder has the
+     * sign of the dividend.
+     * @param a dividend.
+     * @param b divisor.
+     * @param q quotient.
+     * @param r remainder.
+     * @throws domain_error if 'b' is zero.
+     */
+    static void divmod( const BigInt& a, const BigInt& b, BigInt& q, BigInt& r );
+
+  private:
+    typedef vector<uint32_t> Mag;
+
+    static const int64_t SMALL_MAX = 999999999999999999LL;     // 10^18 - 1
+
+    static Mag magnitude( const BigInt& a );
+    static BigInt make( Mag&& m, bool negative );
+    static BigInt addSigned( const BigInt& a, const BigInt& b, bool negateB );
+
+    int64_t small = 0;          // value, if limbs is empty
+    bool negative = false;      // sign, if limbs is not empty
+    Mag limbs;                  // magnitude > SMALL_MAX in base BASE
+};
+
+
+/**
+ * @brief The BigDecimal class implements arbitrary-precision decimals as
+ * unscaled BigInt and number of fractional digits (scale): value =
+ * unscaled * 10^-scale. Sums, differences and products are exact,
+ * quotients are rounded half away from zero to DIV_SCALE fractional
+ * digits. Trailing fractional zeros are removed.
+ */
+class BigDecimal {
+
+  public:
+    static const int DIV_SCALE = 30;
+
+    BigDecimal() {}
+    BigDecimal( const BigInt& unscaled, int scale = 0 );
+
+    /**
+     * @brief parse a decimal with optional sign, fraction and exponent,
+     * e.g. "-12.5" or "1.5e+20".
+     * @param s text.
+     * @return value.
+     * @throws invalid_argument if 's' is no decimal.
+     */
+    static BigDecimal parse( const string& s );
+    static BigDecimal fromDouble( double d );
+
+    string toString() const;
+    double toDouble() const;
+
+    /**
+     * @brief format returns the value for a display of 'width' digits:
+     * plain with truncated fraction if the integer part fits, otherwise
+     * in scientific view with mantissa and exponent, e.g. "1.234567E52".
+     * Marks '.' do not count as digits.
+     * @param width number of digits including '-' and 'E'.
+     * @return display text.
+     */
+    string format( size_t width ) const;
+
+    int sign() const { return unscaled.sign(); }
+    bool isZero() const { return unscaled.isZero(); }
+    const BigInt& getUnscaled() const { return unscaled; }
+    int getScale() const { return scale; }
+
+    friend BigDecimal operator+( const BigDecimal& a, const BigDecimal& b );
+    friend BigDecimal operator-( const BigDecimal& a, const BigDecimal& b );
+    friend BigDecimal operator*( const BigDecimal& a, const BigDecimal& b );
+
+    /**
+     * @brief divide returns a / b rounded to 'scale' fractional digits.
+     * @throws domain_error if 'b' is zero.
+     */
+    static BigDecimal divide( const BigDecimal& a, const BigDecimal& b, int scale = DIV_SCALE );
+
+  private:
+    void normalize();
+
+    BigInt unscaled;
+    int scale = 0;
+};
+
+#endif // BIGNUM_H
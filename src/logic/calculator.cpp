@@ -1,3 +1,8 @@
+#include <limits>
+#include <cmath>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "calculator.h"
 #include "guifacade.h"
 void logDestructor( string msg );
@@ -20,6 +25,28 @@ Calculator& Calculator::getInstance( const string name ) {
 Calculator *Calculator::_this = nullptr;
 
 
+Calculator::ListenerIntf::~ListenerIntf() {}
+
+
+const char *Calculator::DEFAULT_VAT = "19";
+const Calculator::VatRate *Calculator::defaultRates = nullptr;
+size_t Calculator::defaultCount = 0;
+size_t Calculator::defaultSelected = 0;
+
+/**
+ * @brief Calculator constructor selects the default VAT rates, or
+ * DEFAULT_VAT if none are set.
+ * @param name of calculator instance.
+ */
+Calculator::Calculator( const string name ) : name( name ) {
+    static const VatRate standard = VatRate::parse( DEFAULT_VAT );
+    if( defaultRates != nullptr ) {
+        setVatRates( defaultRates, defaultCount, defaultSelected );
+    } else {
+        setVatRates( &standard, 1 );
+    }
+}
+
 Calculator::~Calculator() {
     logDestructor( name );
 }
@@ -32,11 +59,122 @@ Calculator::~Calculator() {
  * @param d operand (double).
  */
 void Calculator::push( double d ) {
-    operandSt.push_back( d );
+    if( precision == Big ) {
+        bigSt.push( BigDecimal::fromDouble( d ) );
+    } else if( precision == Fraction ) {
+        ratSt.push( Rational::fromDouble( d ) );
+    } else {
+        operandSt.push( d );
+    }
 }
 
 double Calculator::top() {
-    return operandSt.size() > 0? operandSt.back() : 0.0;
+    if( precision == Big ) {
+        return bigSt.empty()? 0.0 : bigSt.top().toDouble();
+    }
+    if( precision == Fraction ) {
+        return ratSt.empty()? 0.0 : ratSt.top().toDouble();
+    }
+    return operandSt.empty()? 0.0 : operandSt.top();
+}
+
+/**
+ * @brief Calculator::push operand given as decimal text, which keeps all
+ * its digits in Big and Fraction precision. Calculator::topText() returns the top
+ * element of the operand stack formatted for a display of 'width' digits.
+ * @param s operand, e.g. "12.5".
+ * @throws invalid_argument if 's' is no number.
+ */
+void Calculator::push( const string& s ) {
+    if( precision == Big ) {
+        bigSt.push( BigDecimal::parse( s ) );
+    } else if( precision == Fraction ) {
+        ratSt.push( Rational::parse( s ) );
+    } else {
+        push( stod( s ) );
+    }
+}
+
+string Calculator::topText( size_t width ) {
+    if( precision == Big ) {
+        return bigSt.empty()? "0" : bigSt.top().format( width );
+    }
+    if( precision == Fraction ) {
+        return ratSt.empty()? "0" : ratSt.top().format( width );
+    }
+    return BigDecimal::fromDouble( top() ).format( width );
+}
+
+
+/**
+ * @brief Calculator::VatRate::parse returns the rate for a decimal
+ * percentage with factors 1 + percent / 100, which are exact in Big and
+ * Fraction precision.
+ * @param percent e.g. "19" or "5.5".
+ * @throws invalid_argument if 'percent' is no number >= 0.
+ */
+Calculator::VatRate Calculator::VatRate::parse( const string& percent ) {
+    BigDecimal p = BigDecimal::parse( percent );
+    if( p.sign() < 0 ) {
+        throw invalid_argument( "invalid VAT rate: " + percent );
+    }
+    VatRate r;
+    r.percent = p.toDouble();
+    r.factor = 1.0 + r.percent / 100.0;
+    r.bigFactor = BigDecimal( BigInt( 1 ) ) + p * BigDecimal( BigInt( 1 ), 2 );
+    r.ratFactor = Rational( 1 ) + Rational::parse( percent ) * Rational::parse( "0.01" );
+    return r;
+}
+
+/**
+ * @brief Calculator::setVatRates sets the selectable VAT rates and
+ * selects one. Calculator::setDefaultVatRates() sets the rates of
+ * calculators created later.
+ * @param rates array of rates, which must outlive the calculator.
+ * @param n number of rates.
+ * @param selected index of selected rate.
+ * @throws out_of_range if 'selected' >= 'n'.
+ */
+void Calculator::setVatRates( const VatRate *rates, size_t n, size_t selected ) {
+    if( selected >= n ) {
+        throw out_of_range( "no VAT rate " + to_string( selected ) );
+    }
+    vatRates = rates;
+    vatCount = n;
+    vat = &rates[ selected ];
+}
+
+void Calculator::setDefaultVatRates( const VatRate *rates, size_t n, size_t selected ) {
+    if( selected >= n ) {
+        throw out_of_range( "no VAT rate " + to_string( selected ) );
+    }
+    defaultRates = rates;
+    defaultCount = n;
+    defaultSelected = selected;
+}
+
+/**
+ * @brief Calculator::selectVat selects rate 'i' in O(1).
+ * @return selected rate.
+ * @throws out_of_range if there is no rate 'i'.
+ */
+const Calculator::VatRate& Calculator::selectVat( size_t i ) {
+    if( i >= vatCount ) {
+        throw out_of_range( "no VAT rate " + to_string( i ) );
+    }
+    vat = &vatRates[ i ];
+    return *vat;
+}
+
+
+/**
+ * @brief Calculator::setPrecision selects the precision of operands and
+ * clears both stacks.
+ * @param p precision.
+ */
+void Calculator::setPrecision( Precision p ) {
+    precision = p;
+    clearAll();
 }
 
 
@@ -46,18 +184,19 @@ double Calculator::top() {
  * stack.
  * Pushing operators triggers calculations and reduction of the
  * operand stack. Results are at the top of the operand stack.
+ * Postfix operators are not pushed.
  * @param op.
  */
 void Calculator::pushOp( int op ) {
-    calc();     // trigger calculation
-    if( op != GuiFacade::EQ ) {
-        opSt.push_back( op );
+    calc( op );     // trigger calculation
+    if( ! isPostfix( op ) ) {
+        opSt.push( op );
     }
 }
 
 void Calculator::setOp( int op ) {
-    if( op != GuiFacade::EQ && opSt.size() > 0 ) {
-        opSt.pop_back();
+    if( ! isPostfix( op ) ) {
+        opSt.pop();
     }
     //opSt.push_back( op );
     pushOp( op );
@@ -69,9 +208,7 @@ void Calculator::setOp( int op ) {
  */
 double Calculator::pop() {
     double d = top();
-    if( operandSt.size() > 0 ) {
-        operandSt.pop_back();
-    }
+    operandSt.pop();
     return d;
 }
 
@@ -80,7 +217,7 @@ double Calculator::pop() {
  * @return top level element of operator stack.
  */
 int Calculator::topOp() {
-    return opSt.size() > 0? opSt.back() : GuiFacade::EQ;
+    return opSt.empty()? GuiFacade::EQ : opSt.top();
 }
 
 /**
@@ -89,25 +226,151 @@ int Calculator::topOp() {
  */
 int Calculator::popOp() {
     int op = topOp();
-    if( opSt.size() > 0 ) {
-        opSt.pop_back();
-    }
+    opSt.pop();
     return op;
 }
 
 
+/**
+ * @brief power returns x^y by the kernel of MathKernels.
+ * @throws domain_error if the result is not a finite number.
+ */
+static double power( double x, double y ) {
+    double r = MathKernels::apply( MathKernels::Pow, x, y );
+    if( ! std::isfinite( r ) ) {
+        throw domain_error( "pow: out of range" );
+    }
+    return r;
+}
+
+/**
+ * @brief Calculator::function returns the value of a function key for
+ * 'x' computed by the kernels of MathKernels.
+ * @param fn function as GuiFacade::KeyEvt, Sqrt to Cos.
+ * @param x argument.
+ * @return result.
+ * @throws invalid_argument for 1/0, domain_error if the result is not
+ * a finite number.
+ */
+double Calculator::function( int fn, double x ) {
+    if( fn == GuiFacade::Recip && x == 0 ) {
+        throw invalid_argument( "div/0" );
+    }
+    double r = MathKernels::apply( MathKernels::Fn( fn - GuiFacade::Sqrt ), x );
+    if( ! std::isfinite( r ) ) {
+        throw domain_error( "function: out of range" );
+    }
+    if( listener != nullptr ) {
+        listener->reduced( x, fn, 0.0, r );
+    }
+    return r;
+}
+
+/**
+ * @brief Calculator::popExact pop top level operand from the operand stack
+ * of Big or Fraction precision.
+ * @return top level element of operand stack
+ */
+template<typename T>
+T Calculator::popExact( PStack<T>& st ) {
+    T d = st.empty()? T() : st.top();
+    st.pop();
+    return d;
+}
+
+/**
+ * @brief Calculator::isPostfix returns true for operators that complete
+ * the pending calculation and are not pushed: EQ, Percent and VAT.
+ */
+bool Calculator::isPostfix( int op ) {
+    return op == GuiFacade::EQ || op == GuiFacade::Percent || op == GuiFacade::VAT;
+}
+
+/**
+ * @brief vatFactor returns the factor of a VAT rate in the precision of
+ * the operand type.
+ */
+static const BigDecimal& vatFactor( const Calculator::VatRate& r, const BigDecimal& ) { return r.bigFactor; }
+static const Rational& vatFactor( const Calculator::VatRate& r, const Rational& ) { return r.ratFactor; }
+
+/**
+ * @brief Calculator::calcExact performs a calculation of supported
+ * operators in Big or Fraction precision, see Calculator::calc().
+ * Division fails only by an exact zero, percentages are exact.
+ * @param next operator that triggered the calculation.
+ * @param st operand stack.
+ */
+template<typename T>
+void Calculator::calcExact( int next, PStack<T>& st ) {
+    static const T hundredth = T::parse( "0.01" );
+    int op = opSt.size() >= 1 && st.size() >= 2? popOp() : GuiFacade::EQ;
+    if( op==GuiFacade::Plus || op==GuiFacade::Minus ||
+        op==GuiFacade::Mul || op==GuiFacade::Div || op==GuiFacade::Pow )
+    {
+        T d2 = popExact( st );
+        T d1 = popExact( st );
+        if( next == GuiFacade::Percent ) {
+            d2 = op == GuiFacade::Plus || op == GuiFacade::Minus? d1 * d2 * hundredth : d2 * hundredth;
+        }
+        T r = d1;
+        switch( op ) {
+        case GuiFacade::Plus:   r = d1 + d2; break;
+        case GuiFacade::Minus:  r = d1 - d2; break;
+        case GuiFacade::Mul:    r = d1 * d2; break;
+        case GuiFacade::Div:
+            if( d2.isZero() ) {
+                throw invalid_argument( "div/0" );
+            }
+            r = T::divide( d1, d2 );
+            break;
+        case GuiFacade::Pow:
+            r = T::fromDouble( power( d1.toDouble(), d2.toDouble() ) );
+            break;
+        }
+        st.push( r );
+        if( listener != nullptr ) {
+            listener->reduced( d1.toDouble(), op, d2.toDouble(), r.toDouble() );
+        }
+    } else if( next == GuiFacade::Percent && opSt.empty() && ! st.empty() ) {
+        T d = popExact( st );
+        st.push( d * hundredth );
+        if( listener != nullptr ) {
+            listener->reduced( d.toDouble(), GuiFacade::Percent, 0.0, st.top().toDouble() );
+        }
+    }
+    if( next == GuiFacade::VAT && ! st.empty() ) {
+        T d = popExact( st );
+        st.push( d * vatFactor( *vat, d ) );
+        if( listener != nullptr ) {
+            listener->reduced( d.toDouble(), GuiFacade::VAT, vat->percent, st.top().toDouble() );
+        }
+    }
+}
+
 /**
  * @brief Calculator::calc perform calculation of supported operators.
+ * The reduction is passed to the listener. Percent as 'next' operator
+ * turns the second operand into a percentage before the reduction, VAT
+ * applies the selected rate to its result.
+ * @param next operator that triggered the calculation.
  */
-void Calculator::calc() {
+void Calculator::calc( int next ) {
     showStacks( "===> CALCULATE:\t{ " );
-    if( opSt.size() >= 1 && operandSt.size() >= 2 ) {
+    if( precision == Big ) {
+        calcExact( next, bigSt );
+    } else if( precision == Fraction ) {
+        calcExact( next, ratSt );
+    } else if( opSt.size() >= 1 && operandSt.size() >= 2 ) {
         int op = popOp();
         if( op==GuiFacade::EQ || op==GuiFacade::Plus || op==GuiFacade::Minus ||
-            op==GuiFacade::Mul || op==GuiFacade::Div )
+            op==GuiFacade::Mul || op==GuiFacade::Div || op==GuiFacade::Pow )
         {
             double d2 = pop();
             double d1 = pop();
+            double o1 = d1;
+            if( next == GuiFacade::Percent ) {
+                d2 = op == GuiFacade::Plus || op == GuiFacade::Minus? d1 * d2 / 100.0 : d2 / 100.0;
+            }
             switch( op ) {
             case GuiFacade::EQ:     break;
             case GuiFacade::Plus:   d1 = d1 + d2; break;
@@ -119,13 +382,117 @@ void Calculator::calc() {
                 } else {
                     d1 = d1 / d2;
                 } break;
+            case GuiFacade::Pow:    d1 = power( d1, d2 ); break;
             }
             push( d1 );
+            if( listener != nullptr ) {
+                listener->reduced( o1, op, d2, d1 );
+            }
+        }
+    } else if( next == GuiFacade::Percent && opSt.empty() && ! operandSt.empty() ) {
+        double d = pop();
+        push( d / 100.0 );
+        if( listener != nullptr ) {
+            listener->reduced( d, GuiFacade::Percent, 0.0, d / 100.0 );
+        }
+    }
+    if( precision == Double && next == GuiFacade::VAT && ! operandSt.empty() ) {
+        double d = pop();
+        push( d * vat->factor );
+        if( listener != nullptr ) {
+            listener->reduced( d, GuiFacade::VAT, vat->percent, d * vat->factor );
         }
     }
     showStacks( " };\tRESULT: { ", " }\n" );
 }
 
+#ifdef __SSE2__
+/**
+ * @brief select returns 'v' in the lanes whose operator 'o' equals 'op',
+ * else 'r'. Each operator is duplicated into both halves of its lane.
+ */
+static inline __m128d select( __m128i o, int op, __m128d v, __m128d r ) {
+    __m128d m = _mm_castsi128_pd( _mm_cmpeq_epi32( o, _mm_set1_epi32( op ) ) );
+    return _mm_or_pd( _mm_and_pd( m, v ), _mm_andnot_pd( m, r ) );
+}
+#endif
+
+/**
+ * @brief Calculator::evaluate performs 'n' reductions column-wise. The
+ * loop is branch-free: all operations are computed and the result is
+ * selected by operator, two reductions at a time with SSE2, such that
+ * mixed operators cost no mispredicted branches. Functions and Pow are
+ * gathered per function and evaluated by the vector kernels of
+ * MathKernels in a second pass.
+ * @param op operators as GuiFacade::KeyEvt.
+ * @param operand1, operand2 operands.
+ * @param result results.
+ * @param n number of reductions.
+ */
+void Calculator::evaluate( const int32_t *op, const double *operand1, const double *operand2,
+                           double *result, size_t n ) {
+    const double nan = numeric_limits<double>::quiet_NaN();
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128d one = _mm_set1_pd( 1.0 ), hundred = _mm_set1_pd( 100.0 );
+    for( ; i + 2 <= n; i += 2 ) {
+        __m128d a = _mm_loadu_pd( operand1 + i );
+        __m128d b = _mm_loadu_pd( operand2 + i );
+        __m128i o = _mm_loadl_epi64( reinterpret_cast<const __m128i *>( op + i ) );
+        o = _mm_unpacklo_epi32( o, o );
+        __m128d r = _mm_set1_pd( nan );
+        r = select( o, GuiFacade::Plus, _mm_add_pd( a, b ), r );
+        r = select( o, GuiFacade::Minus, _mm_sub_pd( a, b ), r );
+        r = select( o, GuiFacade::Mul, _mm_mul_pd( a, b ), r );
+        r = select( o, GuiFacade::Div, _mm_div_pd( a, b ), r );
+        r = select( o, GuiFacade::Percent, _mm_div_pd( a, hundred ), r );
+        r = select( o, GuiFacade::VAT, _mm_mul_pd( a, _mm_add_pd( one, _mm_div_pd( b, hundred ) ) ), r );
+        r = select( o, GuiFacade::EQ, a, r );
+        _mm_storeu_pd( result + i, r );
+    }
+#endif
+    for( ; i < n; i++ ) {
+        double a = operand1[i], b = operand2[i];
+        int32_t o = op[i];
+        double r = o == GuiFacade::Plus? a + b : nan;
+        r = o == GuiFacade::Minus? a - b : r;
+        r = o == GuiFacade::Mul? a * b : r;
+        r = o == GuiFacade::Div? a / b : r;
+        r = o == GuiFacade::Percent? a / 100.0 : r;
+        r = o == GuiFacade::VAT? a * ( 1.0 + b / 100.0 ) : r;
+        result[i] = o == GuiFacade::EQ? a : r;
+    }
+
+    static_assert( GuiFacade::Pow - GuiFacade::Sqrt == MathKernels::Pow, "functions must match MathKernels::Fn" );
+    size_t count[ MathKernels::FUNCTIONS ] = {};
+    for( i=0; i < n; i++ ) {
+        if( op[i] >= GuiFacade::Sqrt && op[i] <= GuiFacade::Pow ) {
+            count[ op[i] - GuiFacade::Sqrt ]++;
+        }
+    }
+    for( int fn=0; fn < MathKernels::FUNCTIONS; fn++ ) {
+        if( count[ fn ] == 0 ) {
+            continue;
+        }
+        vector<size_t> index;
+        vector<double> x, y, r( count[ fn ] );
+        index.reserve( count[ fn ] );
+        x.reserve( count[ fn ] );
+        y.reserve( count[ fn ] );
+        for( i=0; i < n; i++ ) {
+            if( op[i] == GuiFacade::Sqrt + fn ) {
+                index.push_back( i );
+                x.push_back( operand1[i] );
+                y.push_back( operand2[i] );
+            }
+        }
+        MathKernels::apply( MathKernels::Fn( fn ), x.data(), y.data(), r.data(), r.size() );
+        for( size_t k=0; k < index.size(); k++ ) {
+            result[ index[k] ] = r[k];
+        }
+    }
+}
+
 
 /**
  * @brief Calculator::clearAll clears operator and operand stacks.
@@ -133,6 +500,8 @@ void Calculator::calc() {
 void Calculator::clearAll() {
     operandSt.clear();
     opSt.clear();
+    bigSt.clear();
+    ratSt.clear();
     showStacks( "===> CLEARED:\t{ ", " }\n" );
 }
 
@@ -141,13 +510,34 @@ void Calculator::clearAll() {
  * and operator stacks.
  */
 void Calculator::clearTop() {
-    if( operandSt.size() > 0 ) {
-        operandSt.pop_back();
-        operandSt.push_back( 0.0 );
+    if( ! operandSt.empty() ) {
+        operandSt.pop();
+        operandSt.push( 0.0 );
+    }
+    if( ! bigSt.empty() ) {
+        bigSt.pop();
+        bigSt.push( BigDecimal() );
+    }
+    if( ! ratSt.empty() ) {
+        ratSt.pop();
+        ratSt.push( Rational() );
     }
     showStacks( "===> CLEAR_CE:\t{ ", "\n" );
 }
 
+/**
+ * @brief Calculator::restore returns operand and operator stacks to a
+ * checkpoint in O(1).
+ * @param s checkpoint.
+ */
+void Calculator::restore( const State& s ) {
+    operandSt = s.operands;
+    opSt = s.ops;
+    bigSt = s.bigOperands;
+    ratSt = s.ratOperands;
+    showStacks( "===> RESTORED:\t{ ", " }\n" );
+}
+
 
 /**
  * @brief Calculator::showStacks lists operand and operator stacks
@@ -156,13 +546,15 @@ void Calculator::clearTop() {
 void Calculator::showStacks( string , string ) { //prefix, string postfix ) {
   /*
     cout << prefix << "OP[ ";
-    for( vector<int>::iterator itOp = opSt.begin(); itOp != opSt.end(); itOp++ ) {
+    vector<int> ops = opSt.elements();
+    for( vector<int>::iterator itOp = ops.begin(); itOp != ops.end(); itOp++ ) {
         int op = *itOp;
         const static string OP_[] = { "+", "-", "*", "/", "%", "VAT", "=", };
         cout << "" << OP_[ op - GuiFacade::Plus ] << ", ";
     }
     cout << "], n[ ";
-    for( vector<double>::iterator itN = operandSt.begin(); itN != operandSt.end(); itN++ ) {
+    vector<double> operands = operandSt.elements();
+    for( vector<double>::iterator itN = operands.begin(); itN != operands.end(); itN++ ) {
         double d = *itN;
         cout << "" << d << ", ";
     }
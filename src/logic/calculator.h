@@ -3,6 +3,11 @@
 
 #include <iostream>
 #include <vector>
+#include <cstdint>
+#include "pstack.h"
+#include "bignum.h"
+#include "rational.h"
+#include "mathkernels.h"
 
 using namespace std;
 
@@ -12,20 +17,128 @@ using namespace std;
  * two stacks, one for operands and results and one for operators.
  * Numbers of type double are used for operands. Operators are of type
  * GuiFacade::KeyEvt: { Plus=12, Minus=13, Mul=14, Div=15, Percent=16,
- * VAT=17, EQ=18 };
+ * VAT=17, EQ=18, Pow=36 };
+ *
+ * Functions { Sqrt=29, Square=30, Recip=31, Ln=32, Exp=33, Sin=34, Cos=35 }
+ * and Pow are computed by the kernels of MathKernels in double precision,
+ * also in Big and Fraction precision.
  *
  * Calculations are triggered by pushing operators to the operator stack.
  * For a calculation, operand(s) are popped from the operand stack and
  * the result is pushed back onto the operand stack.
  *
+ * Each reduction can be passed to a listener, e.g. a journal.
+ *
+ * Percent, VAT and EQ are postfix operators: they complete the pending
+ * calculation and are not pushed. Percent turns the second operand into
+ * a percentage of the first for + and -, e.g. 200 + 10 % = 220, and into
+ * b / 100 for * and /, without pending operator it divides by 100. VAT
+ * adds the selected VAT rate to the result. Rates are VatRate entries
+ * with precomputed factors, e.g. the categories of one region of a VAT
+ * table, such that selecting and applying a rate is O(1) and parses
+ * nothing. Without a table, the rate is DEFAULT_VAT percent.
+ *
+ * In Big precision, operands are arbitrary-precision decimals (BigDecimal)
+ * held on a separate operand stack: sums, differences and products are
+ * exact, quotients have BigDecimal::DIV_SCALE fractional digits. Listeners
+ * receive the nearest doubles. In Fraction precision, operands are exact
+ * fractions (Rational), such that e.g. 1 / 3 * 3 is exactly 1.
+ *
+ * Both stacks are persistent stacks (PStack). checkpoint() returns the
+ * current state in O(1) without copying elements, restore() returns to a
+ * checkpoint, e.g. for undo and redo.
+ *
  * TODO: The current implementation does not consider operator precedense
- * and brackets '(' and ')'. Percent and value-added-tax (VAT) calculation
- * are also not supported and have no effect.
+ * and brackets '(' and ')'.
  */
 class Calculator {
     friend class Builder;
+    friend class Session;
+    friend class StateSnapshot;
 
   public:
+    /**
+     * @brief Abstract class that defines the interface of listeners that
+     * are notified of each reduction performed by calc().
+     */
+    class ListenerIntf {
+      public:
+        virtual ~ListenerIntf();
+        virtual void reduced( double operand1, int op, double operand2, double result ) = 0;
+    };
+
+    void setListener( ListenerIntf *listener ) { this->listener = listener; }
+
+    /**
+     * @brief Precision of operands, Double by default.
+     */
+    enum Precision { Double, Big, Fraction };
+
+    /**
+     * @brief setPrecision selects the precision of operands and clears
+     * both stacks.
+     * @param p precision.
+     */
+    void setPrecision( Precision p );
+    Precision getPrecision() const { return precision; }
+
+    /**
+     * @brief VatRate is a VAT rate in percent with the factor 1 + rate/100
+     * precomputed for each precision.
+     */
+    struct VatRate {
+        double percent = 0.0;
+        double factor = 1.0;
+        BigDecimal bigFactor;
+        Rational ratFactor;
+
+        /**
+         * @brief parse returns the rate for a decimal percentage, e.g. "19".
+         * @throws invalid_argument if 'percent' is no number >= 0.
+         */
+        static VatRate parse( const string& percent );
+    };
+
+    static const char *DEFAULT_VAT;
+
+    /**
+     * @brief setVatRates sets the rates selectable by selectVat() and
+     * selects rate 'selected'. The rates must outlive the calculator.
+     * setDefaultVatRates() sets the rates of calculators created later.
+     * @param rates array of rates, e.g. the categories of a region.
+     * @param n number of rates.
+     * @param selected index of selected rate.
+     * @throws out_of_range if 'selected' >= 'n'.
+     */
+    void setVatRates( const VatRate *rates, size_t n, size_t selected = 0 );
+    static void setDefaultVatRates( const VatRate *rates, size_t n, size_t selected = 0 );
+
+    /**
+     * @brief selectVat selects rate 'i' in O(1).
+     * @return selected rate.
+     * @throws out_of_range if there is no rate 'i'.
+     */
+    const VatRate& selectVat( size_t i );
+
+    /**
+     * @brief State is a checkpoint of operand and operator stacks sharing
+     * their nodes with the calculator.
+     */
+    struct State {
+        PStack<double> operands;
+        PStack<int> ops;
+        PStack<BigDecimal> bigOperands;
+        PStack<Rational> ratOperands;
+    };
+
+    /**
+     * @brief checkpoint returns the current state in O(1), restore()
+     * returns to a checkpoint.
+     * @param s checkpoint.
+     */
+    State checkpoint() const { return State{ operandSt, opSt, bigSt, ratSt }; }
+    void restore( const State& s );
+
     /**
      * @brief push operand onto stack. top() returns the top element of
      * the operand stack without changing the the operand stack.
@@ -34,6 +147,17 @@ class Calculator {
     void push( double d );
     double top();
 
+    /**
+     * @brief push operand given as decimal text, which keeps all its
+     * digits in Big and Fraction precision. topText() returns the top element of the
+     * operand stack formatted for a display of 'width' digits (see
+     * BigDecimal::format()).
+     * @param s operand, e.g. "12.5".
+     * @throws invalid_argument if 's' is no number.
+     */
+    void push( const string& s );
+    string topText( size_t width );
+
     /**
      * @brief pushOp pushes operator onto operator stack.
      * SetOp replaces the current top element of operator stack.
@@ -44,18 +168,45 @@ class Calculator {
     void pushOp( int op );
     void setOp( int op );
 
+    /**
+     * @brief function returns the value of a function key for 'x'. The
+     * reduction is passed to the listener with operand2 = 0.
+     * @param fn function as GuiFacade::KeyEvt, Sqrt to Cos.
+     * @param x argument.
+     * @return result.
+     * @throws invalid_argument for 1/0, domain_error if the result is not
+     * a finite number.
+     */
+    double function( int fn, double x );
+
     /**
      * @brief clear methods clear operand and operator stacks.
      */
     void clearAll();
     void clearTop();
 
+    /**
+     * @brief evaluate is the batch evaluator that performs 'n' reductions
+     * column-wise with the same arithmetic as calc(), e.g. to replay
+     * journalled reductions: result[i] = operand1[i] op[i] operand2[i].
+     * Division by zero yields inf, unsupported operators yield NaN.
+     * Percent yields operand1 / 100, VAT operand1 with operand2 percent
+     * added as calc() records them.
+     * Functions take operand1, see function().
+     * @param op operators as GuiFacade::KeyEvt.
+     * @param operand1, operand2 operands.
+     * @param result results.
+     * @param n number of reductions.
+     */
+    static void evaluate( const int32_t *op, const double *operand1, const double *operand2,
+                          double *result, size_t n );
+
   private:
     /**
      * @brief Private constructor invoked by Calculator::getInstance() only.
      * @param name of calculator singleton instance.
      */
-    Calculator( const string name ) : name( name ) {}
+    Calculator( const string name );
     ~Calculator();
 
     /**
@@ -71,21 +222,35 @@ class Calculator {
      * @brief Private methods used by Calculator internally.
      */
     double pop();
+    template<typename T> static T popExact( PStack<T>& st );
     int topOp();
     int popOp();
 
-    void calc();
+    static bool isPostfix( int op );
+    void calc( int next );
+    template<typename T> void calcExact( int next, PStack<T>& st );
 
     void showStacks( string prefix, string postfix = "" );
 
 
-    vector<double> operandSt = {};  // vector used for operand stack
-    vector<int> opSt = { };         // vector used for operator stack
+    PStack<double> operandSt;       // persistent operand stack
+    PStack<int> opSt;               // persistent operator stack
+    PStack<BigDecimal> bigSt;       // persistent operand stack, Big precision
+    PStack<Rational> ratSt;         // persistent operand stack, Fraction precision
+    Precision precision = Double;
+    const VatRate *vatRates;        // selectable VAT rates
+    size_t vatCount;
+    const VatRate *vat;             // selected VAT rate
 
     const string name;
+    ListenerIntf *listener = nullptr;
 
     static Calculator *_this;   // private static pointer declaration
                                 // for singleton instance
+
+    static const VatRate *defaultRates;
+    static size_t defaultCount;
+    static size_t defaultSelected;
 };
 
 #endif // CALCULATOR_H
@@ -0,0 +1,163 @@
+#include <cstdio>
+#include "countdown.h"
+void logDestructor( string msg );
+
+
+Countdown::ListenerIntf::~ListenerIntf() {}
+
+
+/**
+ * @brief Countdown::start countdown for a duration of 'msec'.
+ * @param msec duration in msec.
+ */
+void Countdown::start( uint64_t msec ) {
+    deadline = wheel.now() + msec;
+    running = true;
+    arm();
+}
+
+/**
+ * @brief Countdown::stop pauses the countdown keeping the remaining time.
+ */
+void Countdown::stop() {
+    if( running ) {
+        rest = remaining();
+        running = false;
+        wheel.cancel( *this );
+    }
+}
+
+/**
+ * @brief Countdown::resume continues a paused countdown.
+ */
+void Countdown::resume() {
+    if( ! running && rest > 0 ) {
+        start( rest );
+    }
+}
+
+/**
+ * @brief Countdown::reset cancels the countdown.
+ */
+void Countdown::reset() {
+    running = false;
+    rest = 0;
+    wheel.cancel( *this );
+}
+
+
+/**
+ * @brief Countdown::preset sets a paused countdown with 'msec' remaining.
+ * @param msec remaining time in msec.
+ */
+void Countdown::preset( uint64_t msec ) {
+    reset();
+    rest = msec;
+}
+
+
+/**
+ * @brief Countdown::remaining time computed from the absolute deadline.
+ * @return remaining msec.
+ */
+uint64_t Countdown::remaining() const {
+    if( ! running ) {
+        return rest;
+    }
+    uint64_t t = wheel.now();
+    return deadline > t? deadline - t : 0;
+}
+
+
+/**
+ * @brief Countdown::expired is invoked by the timer wheel when the
+ * displayed time changes.
+ */
+void Countdown::expired() {
+    arm();
+}
+
+/**
+ * @brief Countdown::arm schedules the wake-up for the tick at which the
+ * displayed seconds drop by one, which is deadline - (s-1) * 1000 for
+ * s displayed seconds. The listener is notified of the current value.
+ */
+void Countdown::arm() {
+    long s = seconds();
+    if( s > 0 ) {
+        wheel.scheduleAt( *this, deadline - uint64_t( s - 1 ) * 1000 );
+    } else {
+        running = false;
+        rest = 0;
+    }
+    if( listener != nullptr ) {
+        listener->countdownChanged( *this );
+    }
+}
+
+
+/**
+ * @brief Countdown::format converts seconds to "HH:MM:SS".
+ * @param seconds number of seconds.
+ * @return time string.
+ */
+string Countdown::format( long seconds ) {
+    seconds = seconds < 0? 0 : seconds > MAX_SECONDS? MAX_SECONDS : seconds;
+    char str[ 16 ];
+    sprintf( str, "%02ld:%02ld:%02ld", seconds / 3600, ( seconds / 60 ) % 60, seconds % 60 );
+    return str;
+}
+
+/**
+ * @brief Countdown::parse converts "HH:MM:SS" to seconds. Minutes and
+ * seconds fields may exceed 59 as entered digit by digit.
+ * @param hhmmss time string.
+ * @return number of seconds limited to MAX_SECONDS.
+ */
+long Countdown::parse( const string& hhmmss ) {
+    static const int pos[] = { 0, 1, 3, 4, 6, 7 };
+    static const long weight[] = { 36000, 3600, 600, 60, 10, 1 };
+    long seconds = 0;
+    for( int i=0; i < 6 && unsigned( pos[i] ) < hhmmss.length(); i++ ) {
+        char c = hhmmss.at( unsigned( pos[i] ) );
+        if( c >= '0' && c <= '9' ) {
+            seconds += ( c - '0' ) * weight[i];
+        }
+    }
+    return seconds > MAX_SECONDS? MAX_SECONDS : seconds;
+}
+
+
+CountdownEngine::~CountdownEngine() {
+    for( map<string, Countdown *>::iterator it = countdowns.begin(); it != countdowns.end(); it++ ) {
+        delete it->second;
+    }
+    logDestructor( name );
+}
+
+/**
+ * @brief CountdownEngine::get returns the countdown with 'name', which is
+ * created on first access.
+ * @param name of countdown.
+ * @param listener notified on changes of the displayed time.
+ * @return reference to countdown.
+ */
+Countdown& CountdownEngine::get( const string& name, Countdown::ListenerIntf *listener ) {
+    map<string, Countdown *>::iterator it = countdowns.find( name );
+    if( it == countdowns.end() ) {
+        it = countdowns.insert( make_pair( name, new Countdown( name, wheel, listener ) ) ).first;
+    }
+    return *it->second;
+}
+
+/**
+ * @brief CountdownEngine::remove deletes countdown with 'name'.
+ * @param name of countdown.
+ */
+void CountdownEngine::remove( const string& name ) {
+    map<string, Countdown *>::iterator it = countdowns.find( name );
+    if( it != countdowns.end() ) {
+        delete it->second;
+        countdowns.erase( it );
+    }
+}
@@ -0,0 +1,138 @@
+#ifndef COUNTDOWN_H
+#define COUNTDOWN_H
+
+#include <iostream>
+#include <map>
+#include "timerwheel.h"
+using namespace std;
+
+
+/**
+ * @brief The Countdown class implements a drift-free countdown. The
+ * remaining time is always computed from an absolute deadline on the
+ * monotonic clock of the timer wheel rather than by accumulating ticks.
+ *
+ * The displayed time is the remaining time rounded up to full seconds.
+ * A countdown only wakes up when that value changes, i.e. once per second
+ * at the tick where the next visible digit changes, and notifies its
+ * listener. Countdowns are created and owned by CountdownEngine.
+ */
+class Countdown : private TimerWheel::Entry {
+    friend class CountdownEngine;
+
+  public:
+    /**
+     * @brief Abstract class that defines the interface of listeners that
+     * are notified when the displayed time of a countdown has changed.
+     */
+    class ListenerIntf {
+      public:
+        virtual ~ListenerIntf();
+        virtual void countdownChanged( Countdown& c ) = 0;
+    };
+
+    /**
+     * @brief start countdown for a duration of 'msec'. stop() pauses the
+     * countdown keeping the remaining time, resume() continues a paused
+     * countdown, reset() cancels it. preset() sets a paused countdown to
+     * 'msec', e.g. when restored from a snapshot.
+     * @param msec duration in msec.
+     */
+    void start( uint64_t msec );
+    void stop();
+    void resume();
+    void reset();
+    void preset( uint64_t msec );
+
+    bool isRunning() const { return running; }
+
+    /**
+     * @brief remaining time in msec and as displayed seconds (rounded up).
+     * @return remaining msec or seconds.
+     */
+    uint64_t remaining() const;
+    long seconds() const { return long( ( remaining() + 999 ) / 1000 ); }
+
+    const string& getName() const { return name; }
+
+    /**
+     * @brief format and parse convert seconds to and from "HH:MM:SS".
+     * Seconds are limited to 99:59:59.
+     * @param seconds number of seconds.
+     * @param hhmmss time string.
+     */
+    static string format( long seconds );
+    static long parse( const string& hhmmss );
+
+    static const long MAX_SECONDS = 99 * 3600 + 59 * 60 + 59;
+
+  private:
+    /**
+     * @brief Private constructor invoked by CountdownEngine only.
+     * @param name of countdown.
+     * @param wheel timer wheel providing clock and wake-ups.
+     * @param listener notified on changes of the displayed time.
+     */
+    Countdown( const string name, TimerWheel& wheel, ListenerIntf *listener )
+        : name( name ), wheel( wheel ), listener( listener ) {}
+    ~Countdown() {}
+
+    /**
+     * @brief expired is invoked by the timer wheel when the displayed
+     * time changes.
+     */
+    void expired();
+
+    /**
+     * @brief arm schedules the wake-up for the next change of the
+     * displayed time and notifies the listener.
+     */
+    void arm();
+
+    const string name;
+    TimerWheel& wheel;
+    ListenerIntf *listener;
+
+    bool running = false;
+    uint64_t deadline = 0;      // absolute tick when countdown reaches zero
+    uint64_t rest = 0;          // remaining msec while stopped
+};
+
+
+/**
+ * @brief The CountdownEngine class manages several named concurrent
+ * countdowns sharing one timer wheel. Countdowns are created on first
+ * access by name.
+ */
+class CountdownEngine {
+
+  public:
+    /**
+     * @brief CountdownEngine constructor.
+     * @param name of engine.
+     * @param wheel timer wheel used by all countdowns of the engine.
+     */
+    CountdownEngine( const string name, TimerWheel& wheel = TimerWheel::getInstance() )
+        : name( name ), wheel( wheel ) {}
+    ~CountdownEngine();
+
+    /**
+     * @brief get returns the countdown with 'name', which is created on
+     * first access. remove() deletes a countdown.
+     * @param name of countdown.
+     * @param listener notified on changes of the displayed time.
+     * @return reference to countdown.
+     */
+    Countdown& get( const string& name, Countdown::ListenerIntf *listener = nullptr );
+    void remove( const string& name );
+
+    size_t size() const { return countdowns.size(); }
+    TimerWheel& getWheel() { return wheel; }
+
+  private:
+    const string name;
+    TimerWheel& wheel;
+    map<string, Countdown *> countdowns;
+};
+
+#endif // COUNTDOWN_H
@@ -0,0 +1,183 @@
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#if defined( __x86_64__ )
+#include <immintrin.h>
+#define MATHKERNELS_X86
+#endif
+#include "mathkernels.h"
+
+/*
+ * Kernels must not be contracted to fused multiply-add, which AVX-512
+ * implies, such that all instruction sets yield identical results.
+ */
+#pragma GCC optimize( "fp-contract=off" )
+
+static const double SINCOS_MAX = 1048576.0; // limit of Cody-Waite reduction
+
+
+namespace scalar {
+typedef double V;
+typedef int64_t I;
+static const size_t LANES = 1;
+static inline V splat( double d ) { return d; }
+static inline I asInt( V v ) { I i; memcpy( &i, &v, 8 ); return i; }
+static inline V asDouble( I i ) { V v; memcpy( &v, &i, 8 ); return v; }
+static inline V vsqrt( V v ) { return __builtin_sqrt( v ); }
+static inline V load( const double *p ) { return *p; }
+static inline void store( double *p, V v ) { *p = v; }
+#include "mathkernels_impl.h"
+}
+
+#ifdef MATHKERNELS_X86
+#pragma GCC push_options
+#pragma GCC target( "avx2" )
+namespace avx2 {
+typedef double V __attribute__(( vector_size( 32 ) ));
+typedef int64_t I __attribute__(( vector_size( 32 ) ));
+static const size_t LANES = 4;
+static inline V splat( double d ) { return V{ d, d, d, d }; }
+static inline I asInt( V v ) { return I( v ); }
+static inline V asDouble( I i ) { return V( i ); }
+static inline V vsqrt( V v ) { return V( _mm256_sqrt_pd( __m256d( v ) ) ); }
+static inline V load( const double *p ) { return V( _mm256_loadu_pd( p ) ); }
+static inline void store( double *p, V v ) { _mm256_storeu_pd( p, __m256d( v ) ); }
+#include "mathkernels_impl.h"
+}
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target( "avx512f" )
+namespace avx512 {
+typedef double V __attribute__(( vector_size( 64 ) ));
+typedef int64_t I __attribute__(( vector_size( 64 ) ));
+static const size_t LANES = 8;
+static inline V splat( double d ) { return V{ d, d, d, d, d, d, d, d }; }
+static inline I asInt( V v ) { return I( v ); }
+static inline V asDouble( I i ) { return V( i ); }
+static inline V vsqrt( V v ) { return V( _mm512_maskz_sqrt_pd( __mmask8( -1 ), __m512d( v ) ) ); }
+static inline V load( const double *p ) { return V( _mm512_loadu_pd( p ) ); }
+static inline void store( double *p, V v ) { _mm512_storeu_pd( p, __m512d( v ) ); }
+#include "mathkernels_impl.h"
+}
+#pragma GCC pop_options
+#endif
+
+
+/**
+ * @brief MathKernels::supports returns true if the CPU supports 'isa'.
+ */
+bool MathKernels::supports( Isa isa ) {
+#ifdef MATHKERNELS_X86
+    __builtin_cpu_init();
+    switch( isa ) {
+    case AVX512:    return __builtin_cpu_supports( "avx512f" );
+    case AVX2:      return __builtin_cpu_supports( "avx2" );
+    default:        return true;
+    }
+#else
+    return isa == Scalar;
+#endif
+}
+
+MathKernels::Isa MathKernels::isa = supports( AVX512 )? AVX512 : supports( AVX2 )? AVX2 : Scalar;
+
+MathKernels::Isa MathKernels::getIsa() {
+    return isa;
+}
+
+bool MathKernels::setIsa( Isa isa ) {
+    if( ! supports( isa ) ) {
+        return false;
+    }
+    MathKernels::isa = isa;
+    return true;
+}
+
+const char *MathKernels::isaName( Isa isa ) {
+    static const char *names[] = { "scalar", "AVX2", "AVX-512" };
+    return names[ isa ];
+}
+
+
+/**
+ * @brief MathKernels::apply evaluates whole vectors with the kernels of
+ * the selected instruction set and the remainder with the scalar kernels.
+ * Arguments the kernels do not cover are fixed up afterwards.
+ * @param fn function.
+ * @param x, y arguments, 'y' is used by Pow only.
+ * @param r results, must not overlap the arguments.
+ * @param n number of arguments.
+ */
+void MathKernels::apply( Fn fn, const double *x, const double *y, double *r, size_t n ) {
+    size_t i = 0;
+#ifdef MATHKERNELS_X86
+    if( isa == AVX512 ) {
+        i = avx512::kernel( fn, x, y, r, n );
+    } else if( isa == AVX2 ) {
+        i = avx2::kernel( fn, x, y, r, n );
+    }
+#endif
+    scalar::kernel( fn, x + i, y + i, r + i, n - i );
+    fixup( fn, x, y, r, n );
+}
+
+double MathKernels::apply( Fn fn, double x, double y ) {
+    double r;
+    apply( fn, &x, &y, &r, 1 );
+    return r;
+}
+
+/**
+ * @brief MathKernels::fixup replaces results of sin and cos for arguments
+ * beyond the Cody-Waite reduction by those of the C library, and results
+ * of pow for special arguments.
+ */
+void MathKernels::fixup( Fn fn, const double *x, const double *y, double *r, size_t n ) {
+    if( fn == Sin || fn == Cos ) {
+        for( size_t i=0; i < n; i++ ) {
+            if( ! ( fabs( x[i] ) <= SINCOS_MAX ) ) {
+                r[i] = fn == Sin? sin( x[i] ) : cos( x[i] );
+            }
+        }
+    } else if( fn == Pow ) {
+        for( size_t i=0; i < n; i++ ) {
+            if( ! ( x[i] > 0 && x[i] < HUGE_VAL && y[i] - y[i] == 0 ) || x[i] == 1 || y[i] == 0 ) {
+                r[i] = powSpecial( x[i], y[i], r[i] );
+            }
+        }
+    }
+}
+
+/**
+ * @brief MathKernels::powSpecial returns x^y for arguments not covered by
+ * the kernel as specified for pow() by C99: x^0 = 1^y = 1, negative x
+ * require integral y and the result is negative for odd y.
+ * @param r result of the kernel.
+ */
+double MathKernels::powSpecial( double x, double y, double r ) {
+    if( y == 0 || x == 1 ) {
+        return 1.0;
+    }
+    if( x != x || y != y ) {
+        return NAN;
+    }
+    if( std::isinf( y ) ) {
+        double ax = fabs( x );
+        return ax == 1? 1.0 : ( ax > 1 ) == ( y > 0 )? HUGE_VAL : 0.0;
+    }
+    bool integral = y == floor( y );
+    bool odd = integral && fmod( y, 2.0 ) != 0;
+    if( x == 0 || std::isinf( x ) ) {
+        double v = ( x == 0 ) == ( y < 0 )? HUGE_VAL : 0.0;
+        return odd && signbit( x )? -v : v;
+    }
+    if( x > 0 ) {
+        return r;
+    }
+    if( ! integral ) {
+        return NAN;
+    }
+    double v = scalar::powKernel( -x, y );
+    return odd? -v : v;
+}
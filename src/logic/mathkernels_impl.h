@@ -0,0 +1,243 @@
+/*
+ * Kernels of MathKernels, included once per instruction set by
+ * mathkernels.cpp into a namespace that defines:
+ *
+ *   V          double or vector of doubles
+ *   I          int64_t or vector of int64_t of the same width
+ *   LANES      number of doubles in V
+ *   splat()    V with all lanes set to a double
+ *   asInt()    bits of V as I, asDouble() the reverse
+ *   vsqrt()    IEEE square root
+ *   load()     unaligned load of V, store() the reverse
+ *
+ * Kernels are written with GCC vector extensions, such that the same text
+ * compiles to scalar and vector code. Comparisons yield masks, a ternary
+ * selects by mask. Selects compute both alternatives, i.e. kernels are
+ * branch-free.
+ *
+ * No include guard: this file is included once per instruction set.
+ */
+
+static const double MAGIC = 6755399441055744.0;              // adding rounds to integer
+static const int64_t MAGIC_BITS = 0x4338000000000000;
+static const double SPLIT = 134217729.0;            // 2^27 + 1, Dekker split
+
+static const double INV_LN2 = 1.44269504088896338700e+00;
+static const double LN2_HI = 6.93147180369123816490e-01;     // 32 bits of ln(2)
+static const double LN2_LO = 1.90821492927058770002e-10;
+static const int64_t SQRTH_BITS = 0x3fe6a09e667f3bcd;        // sqrt(2)/2
+
+static const double TWO_OVER_PI = 6.36619772367581382433e-01;
+static const double PIO2_1 = 1.57079632673412561417e+00;     // 33 bits of pi/2
+static const double PIO2_2 = 6.07710050630396597660e-11;     // next 33 bits
+static const double PIO2_2T = 2.02226624879595063154e-21;    // pi/2 - PIO2_1 - PIO2_2
+
+
+/**
+ * @brief twoProd returns a * b as unevaluated sum p + e by Dekker's
+ * algorithm.
+ */
+static inline void twoProd( V a, V b, V& p, V& e ) {
+    p = a * b;
+    V ca = a * SPLIT, ah = ca - ( ca - a ), al = a - ah;
+    V cb = b * SPLIT, bh = cb - ( cb - b ), bl = b - bh;
+    e = ( ( ah * bh - p ) + ah * bl + al * bh ) + al * bl;
+}
+
+/**
+ * @brief pow2 returns 2^k for integral k in [-1022, 1023].
+ */
+static inline V pow2( V k ) {
+    return asDouble( ( asInt( k + MAGIC ) - MAGIC_BITS + 1023 ) << 52 );
+}
+
+/**
+ * @brief expDD returns e^( h+l ), |l| <= ulp( h ). h+l = k * ln(2) + r
+ * with |r| <= ln(2)/2, where r is rounded to double and its rounding
+ * error c is carried separately. e^r is the Taylor series to degree 13,
+ * whose remainder is below 2^-57, summed as 1 + r + r^2 * q( r ) with
+ * the rounding error of 1 + r kept. 2^k is applied in two steps, such
+ * that results in the subnormal range are rounded once.
+ */
+static inline V expDD( V h, V l ) {
+    h = h > splat( 710.0 )? splat( 710.0 ) : h;
+    h = h < splat( -746.0 )? splat( -746.0 ) : h;
+    V k = ( h * INV_LN2 + MAGIC ) - MAGIC;
+    V rh = h - k * LN2_HI;                  // exact
+    V rl = l - k * LN2_LO;
+    V r = rh + rl;
+    V c = ( rh - r ) + rl;
+    V q = splat( 1.0 / 6227020800.0 );
+    q = q * r + 1.0 / 479001600.0;
+    q = q * r + 1.0 / 39916800.0;
+    q = q * r + 1.0 / 3628800.0;
+    q = q * r + 1.0 / 362880.0;
+    q = q * r + 1.0 / 40320.0;
+    q = q * r + 1.0 / 5040.0;
+    q = q * r + 1.0 / 720.0;
+    q = q * r + 1.0 / 120.0;
+    q = q * r + 1.0 / 24.0;
+    q = q * r + 1.0 / 6.0;
+    q = q * r + 0.5;
+    V s = 1.0 + r;
+    V p = s + ( ( ( 1.0 - s ) + r ) + ( ( r * r ) * q + ( c + c * r ) ) );
+    V k1 = ( k * 0.5 + MAGIC ) - MAGIC;
+    return ( p * pow2( k1 ) ) * pow2( k - k1 );
+}
+
+/**
+ * @brief logDD returns ln( x ) as hi + lo for finite x > 0, garbage for
+ * other x. x = 2^k * (1+f) with 1+f in [sqrt(2)/2, sqrt(2)) and ln( 1+f )
+ * = 2s * ( 1 + z/3 + z^2/5 + ... ), s = f / (2+f), z = s^2 <= 0.0295. The
+ * series is truncated after z^12/25, its remainder is below 2^-70. s, z,
+ * z/3 and the products are carried in double-double, such that ln( x )
+ * is accurate to about 2^-65 as required by pow().
+ */
+static inline V logDD( V x, V& lo ) {
+    V tiny = x < splat( 2.2250738585072014e-308 )? splat( 1.0 ) : splat( 0.0 );
+    V xs = tiny > splat( 0.0 )? x * 18014398509481984.0 : x;   // scale subnormals
+    I xi = asInt( xs );
+    I e = ( xi - SQRTH_BITS ) >> 52;
+    V m = asDouble( xi - ( e << 52 ) );
+    V k = ( asDouble( e + MAGIC_BITS ) - MAGIC ) - tiny * 54.0;
+
+    V f = m - 1.0;                          // exact
+    V d = f + 2.0;                          // exact
+    V sh = f / d;
+    V ph, pl;
+    twoProd( sh, f, ph, pl );
+    V sl = ( ( ( f - ( sh + sh ) ) - ph ) - pl ) / d;
+
+    V zh, zl;
+    twoProd( sh, sh, zh, zl );
+    zl = zl + 2.0 * sh * sl;
+    V th = zh / 3.0;
+    twoProd( th, splat( 3.0 ), ph, pl );
+    V tl = ( ( ( zh - ph ) - pl ) + zl ) / 3.0;
+    V R = zh * zh * ( 1.0 / 5 + zh * ( 1.0 / 7 + zh * ( 1.0 / 9 + zh * ( 1.0 / 11 +
+          zh * ( 1.0 / 13 + zh * ( 1.0 / 15 + zh * ( 1.0 / 17 + zh * ( 1.0 / 19 +
+          zh * ( 1.0 / 21 + zh * ( 1.0 / 23 + zh * ( 1.0 / 25 ) ) ) ) ) ) ) ) ) ) );
+    V qh = 1.0 + th;
+    V ql = ( ( ( 1.0 - qh ) + th ) + tl ) + R;
+    twoProd( sh, qh, ph, pl );
+    ph = ph + ph;                           // exact
+    pl = 2.0 * ( pl + ( sh * ql + sl * qh ) );
+
+    V a = k * LN2_HI;                       // exact
+    V s = a + ph;
+    V bb = s - a;
+    V t = ( ( a - ( s - bb ) ) + ( ph - bb ) ) + ( pl + k * LN2_LO );
+    V hi = s + t;
+    lo = t - ( hi - s );
+    return hi;
+}
+
+/**
+ * @brief sinCos returns sin( x ), or cos( x ) if 'cosine', for |x| <=
+ * 2^20. x = k * pi/2 + r with r in double-double by Cody-Waite reduction,
+ * where k * PIO2_1 and k * PIO2_2 are exact. The kernels of sin and cos on
+ * [-pi/4, pi/4] are those of fdlibm, the quadrant k mod 4 selects and
+ * negates them.
+ */
+static inline V sinCos( V x, bool cosine ) {
+    V k = ( x * TWO_OVER_PI + MAGIC ) - MAGIC;
+    V t = x - k * PIO2_1;
+    V w = k * PIO2_2;
+    V h = t - w;
+    V bb = h - t;
+    V l = ( ( t - ( h - bb ) ) - ( w + bb ) ) - k * PIO2_2T;
+    V rh = h + l;
+    V rl = l - ( rh - h );
+
+    V z = rh * rh;
+    V v = z * rh;
+    V sr = 8.33333333332248946124e-03 + z * ( -1.98412698298579493134e-04 +
+           z * ( 2.75573137070700676789e-06 + z * ( -2.50507602534068634195e-08 +
+           z * 1.58969099521155010221e-10 ) ) );
+    V sn = rh - ( ( z * ( 0.5 * rl - v * sr ) - rl ) - v * -1.66666666666666324348e-01 );
+
+    V zz = z * z;
+    V cr = z * ( 4.16666666666666019037e-02 + z * ( -1.38888888888741095749e-03 +
+           z * 2.48015872894767294178e-05 ) ) + zz * zz * ( -2.75573143513906633035e-07 +
+           z * ( 2.08757232129817482790e-09 + z * -1.13596475577881948265e-11 ) );
+    V hz = 0.5 * z;
+    V cw = 1.0 - hz;
+    V cs = cw + ( ( ( 1.0 - cw ) - hz ) + ( z * cr - rh * rl ) );
+
+    I q = asInt( k + MAGIC ) + ( cosine? 1 : 0 );
+    V r = ( q & 1 ) == 1? cs : sn;
+    return ( q & 2 ) == 2? -r : r;
+}
+
+static inline V logKernel( V x ) {
+    V lo;
+    V r = logDD( x, lo );
+    r = x == splat( HUGE_VAL )? x : r;
+    r = x == splat( 0.0 )? splat( -HUGE_VAL ) : r;
+    r = x < splat( 0.0 )? splat( NAN ) : r;
+    return x != x? x : r;
+}
+
+/**
+ * @brief powKernel returns x^y = e^( y * ln( x ) ) for finite x > 0 and
+ * finite y. Other arguments are handled by MathKernels::powSpecial().
+ */
+static inline V powKernel( V x, V y ) {
+    V lo, ph, pl;
+    V hi = logDD( x, lo );
+    twoProd( y, hi, ph, pl );
+    pl = pl + y * lo;
+    pl = ph > splat( 709.0 ) || ph < splat( -745.0 )? splat( 0.0 ) : pl;
+    return expDD( ph, pl );
+}
+
+/**
+ * @brief kernel evaluates r[i] = fn( x[i], y[i] ) in steps of LANES.
+ * @return number of evaluated arguments, a multiple of LANES.
+ */
+static size_t kernel( int fn, const double *x, const double *y, double *r, size_t n ) {
+    size_t i = 0;
+    switch( fn ) {
+    case MathKernels::Sqrt:
+        for( ; i + LANES <= n; i += LANES ) {
+            store( r + i, vsqrt( load( x + i ) ) );
+        }
+        break;
+    case MathKernels::Square:
+        for( ; i + LANES <= n; i += LANES ) {
+            store( r + i, load( x + i ) * load( x + i ) );
+        }
+        break;
+    case MathKernels::Recip:
+        for( ; i + LANES <= n; i += LANES ) {
+            store( r + i, 1.0 / load( x + i ) );
+        }
+        break;
+    case MathKernels::Ln:
+        for( ; i + LANES <= n; i += LANES ) {
+            store( r + i, logKernel( load( x + i ) ) );
+        }
+        break;
+    case MathKernels::Exp:
+        for( ; i + LANES <= n; i += LANES ) {
+            store( r + i, expDD( load( x + i ), splat( 0.0 ) ) );
+        }
+        break;
+    case MathKernels::Sin:
+        for( ; i + LANES <= n; i += LANES ) {
+            store( r + i, sinCos( load( x + i ), false ) );
+        }
+        break;
+    case MathKernels::Cos:
+        for( ; i + LANES <= n; i += LANES ) {
+            store( r + i, sinCos( load( x + i ), true ) );
+        }
+        break;
+    case MathKernels::Pow:
+        for( ; i + LANES <= n; i += LANES ) {
+            store( r + i, powKernel( load( x + i ), load( y + i ) ) );
+        }
+        break;
+    }
+    return i;
+}
@@ -0,0 +1,123 @@
+#ifndef PSTACK_H
+#define PSTACK_H
+
+#include <vector>
+#include <cstddef>
+using namespace std;
+
+
+/**
+ * @brief The PStack class template implements a persistent stack whose
+ * versions share structure. Elements are held in immutable nodes linked
+ * from top to bottom and reference-counted. push() and pop() create a new
+ * version without changing the nodes of others. Copying a stack is O(1)
+ * and only shares its top node, such that every state of a stack can be
+ * kept as cheap snapshot, e.g. for undo.
+ *
+ * Reference counts are not atomic: the versions of a stack must be used
+ * by one thread at a time, like the Calculator they belong to.
+ */
+template<typename T>
+class PStack {
+
+    struct Node {
+        Node( const T& value, const Node *next )
+            : value( value ), next( next ), size( next != nullptr? next->size + 1 : 1 ) {}
+        const T value;
+        const Node *next;
+        const size_t size;
+        mutable size_t refs = 1;
+    };
+
+  public:
+    PStack() {}
+    PStack( const PStack& s ) : head( s.head ) { retain( head ); }
+    PStack( PStack&& s ) : head( s.head ) { s.head = nullptr; }
+    ~PStack() { release( head ); }
+
+    PStack& operator=( const PStack& s ) {
+        retain( s.head );
+        release( head );
+        head = s.head;
+        return *this;
+    }
+
+    PStack& operator=( PStack&& s ) {
+        if( this != &s ) {
+            release( head );
+            head = s.head;
+            s.head = nullptr;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief push an element. The new top node takes over the reference
+     * to the previous top node.
+     * @param value element.
+     */
+    void push( const T& value ) { head = new Node( value, head ); }
+
+    /**
+     * @brief pop the top element, if any. Its node is deleted when no other
+     * version shares it.
+     */
+    void pop() {
+        if( head != nullptr ) {
+            const Node *n = head;
+            head = n->next;
+            retain( head );
+            release( n );
+        }
+    }
+
+    /**
+     * @brief top returns the top element. The stack must not be empty.
+     */
+    const T& top() const { return head->value; }
+
+    void clear() { release( head ); head = nullptr; }
+    bool empty() const { return head == nullptr; }
+    size_t size() const { return head != nullptr? head->size : 0; }
+
+    /**
+     * @brief same returns true if both stacks are the same version, which
+     * is an O(1) test for unchanged state.
+     */
+    bool same( const PStack& s ) const { return head == s.head; }
+
+    /**
+     * @brief elements returns the elements from bottom to top.
+     */
+    vector<T> elements() const {
+        vector<T> v( size() );
+        size_t i = v.size();
+        for( const Node *n = head; n != nullptr; n = n->next ) {
+            v[ --i ] = n->value;
+        }
+        return v;
+    }
+
+  private:
+    static void retain( const Node *n ) {
+        if( n != nullptr ) {
+            n->refs++;
+        }
+    }
+
+    /**
+     * @brief release drops a reference and deletes nodes no longer shared,
+     * iteratively so that long stacks do not exhaust the call stack.
+     */
+    static void release( const Node *n ) {
+        while( n != nullptr && --n->refs == 0 ) {
+            const Node *next = n->next;
+            delete n;
+            n = next;
+        }
+    }
+
+    const Node *head = nullptr;
+};
+
+#endif // PSTACK_H
@@ -0,0 +1,292 @@
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include "rational.h"
+
+
+/**
+ * @brief absolute returns the magnitude of a BigInt.
+ */
+static BigInt absolute( const BigInt& a ) {
+    return a.sign() < 0? -a : a;
+}
+
+/**
+ * @brief gcdBig returns the greatest common divisor of magnitudes by
+ * Euclid's algorithm. Stein's binary GCD does not pay off for limbs of
+ * decimal digits, where halving is a division.
+ */
+static BigInt gcdBig( BigInt a, BigInt b ) {
+    BigInt q, r;
+    while( ! b.isZero() ) {
+        BigInt::divmod( a, b, q, r );
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+/**
+ * @brief checked returns false if an int64_t result overflowed or is
+ * INT64_MIN, whose negation overflows.
+ */
+static inline bool checked( bool overflow, int64_t r ) {
+    return ! overflow && r != INT64_MIN;
+}
+
+
+/**
+ * @brief Rational::gcd returns the greatest common divisor by Stein's
+ * binary GCD: common factors of two are shifted out once, then the
+ * smaller odd value is subtracted from the larger until they are equal.
+ */
+uint64_t Rational::gcd( uint64_t a, uint64_t b ) {
+    if( a == 0 || b == 0 ) {
+        return a | b;
+    }
+    int shift = __builtin_ctzll( a | b );
+    a >>= __builtin_ctzll( a );
+    do {
+        b >>= __builtin_ctzll( b );
+        if( a > b ) {
+            swap( a, b );
+        }
+        b -= a;
+    } while( b != 0 );
+    return a << shift;
+}
+
+/**
+ * @brief Rational::make returns the reduced fraction n / d, d != 0,
+ * inline if it fits.
+ */
+Rational Rational::make( BigInt n, BigInt d ) {
+    if( d.sign() < 0 ) {
+        n = -n;
+        d = -d;
+    }
+    BigInt g = gcdBig( absolute( n ), d );
+    if( ! ( g == BigInt( 1 ) ) ) {
+        BigInt q, rem;
+        BigInt::divmod( n, g, q, rem );
+        n = q;
+        BigInt::divmod( d, g, q, rem );
+        d = q;
+    }
+    if( n.isSmall() && d.isSmall() ) {      // |n|, d < 10^18
+        return fraction( n.toInt64(), d.toInt64() );
+    }
+    Rational r;
+    r.big = make_shared<const Big>( Big{ n, d } );
+    return r;
+}
+
+/**
+ * @brief Rational::fromParts returns the reduced fraction n / d.
+ * @throws domain_error if 'd' is zero.
+ */
+Rational Rational::fromParts( const BigInt& n, const BigInt& d ) {
+    if( d.isZero() ) {
+        throw domain_error( "div/0" );
+    }
+    return make( n, d );
+}
+
+/**
+ * @brief Rational::parts returns numerator and denominator > 0.
+ */
+void Rational::parts( BigInt& n, BigInt& d ) const {
+    if( big ) {
+        n = big->num;
+        d = big->den;
+    } else {
+        n = BigInt( num );
+        d = BigInt( den );
+    }
+}
+
+Rational Rational::fromDecimal( const BigDecimal& d ) {
+    int scale = d.getScale();
+    if( d.getUnscaled().isSmall() && scale <= 18 ) {
+        int64_t p = 1;
+        for( int i=0; i < scale; i++ ) {
+            p *= 10;
+        }
+        return fraction( d.getUnscaled().toInt64(), p );
+    }
+    return make( d.getUnscaled(), BigInt::pow10( unsigned( scale ) ) );
+}
+
+Rational Rational::parse( const string& s ) {
+    return fromDecimal( BigDecimal::parse( s ) );
+}
+
+/**
+ * @brief Rational::fromDouble converts the shortest decimal that reads
+ * back as 'd', e.g. 1/10 for 0.1.
+ * @throws invalid_argument if 'd' is not finite.
+ */
+Rational Rational::fromDouble( double d ) {
+    return fromDecimal( BigDecimal::fromDouble( d ) );
+}
+
+
+Rational Rational::reduced() const {
+    if( big ) {
+        return *this;
+    }
+    uint64_t g = gcd( uint64_t( num < 0? -num : num ), uint64_t( den ) );
+    return g > 1? fraction( num / int64_t( g ), den / int64_t( g ) ) : *this;
+}
+
+string Rational::toString() const {
+    Rational r = reduced();
+    BigInt n, d;
+    r.parts( n, d );
+    return d == BigInt( 1 )? n.toString() : n.toString() + "/" + d.toString();
+}
+
+/**
+ * @brief Rational::toDouble divides the nearest doubles of numerator and
+ * denominator, which are scaled down first if both are large.
+ */
+double Rational::toDouble() const {
+    if( ! big ) {
+        return double( num ) / double( den );
+    }
+    BigInt n = big->num, d = big->den;
+    long k = long( min( n.digits(), d.digits() ) ) - 18;
+    if( k > 0 ) {
+        n = n.shift( int( -k ) );
+        d = d.shift( int( -k ) );
+    }
+    return n.toDouble() / d.toDouble();
+}
+
+/**
+ * @brief Rational::format returns integers directly, other fractions as
+ * quotient with at least BigDecimal::DIV_SCALE significant digits.
+ */
+string Rational::format( size_t width ) const {
+    Rational r = reduced();
+    if( ! r.big && r.den == 1 ) {
+        string s = to_string( r.num );
+        if( s.length() <= width ) {
+            return s;
+        }
+    }
+    BigInt n, d;
+    r.parts( n, d );
+    int scale = BigDecimal::DIV_SCALE + int( max( d.digits(), n.digits() ) - n.digits() );
+    return BigDecimal::divide( BigDecimal( n ), BigDecimal( d ), scale ).format( width );
+}
+
+
+/**
+ * @brief Rational::addSmall adds fractions of equal denominators without
+ * multiplication, others over the common denominator a.den * b.den / g.
+ * @param g common divisor of the denominators, 1 if not known.
+ * @return false on overflow.
+ */
+bool Rational::addSmall( const Rational& a, const Rational& b, int64_t g, Rational& r ) {
+    int64_t n, x, y, d;
+    if( a.den == b.den ) {
+        bool o = __builtin_add_overflow( a.num, b.num, &n );
+        r = fraction( n, a.den );
+        return checked( o, n );
+    }
+    bool o = __builtin_mul_overflow( a.num, b.den / g, &x ) | __builtin_mul_overflow( b.num, a.den / g, &y ) |
+             __builtin_mul_overflow( a.den, b.den / g, &d );
+    o = __builtin_add_overflow( x, y, &n ) | o;
+    r = fraction( n, d );
+    return checked( o, n );
+}
+
+/**
+ * @brief Rational::mulSmall multiplies numerators and denominators.
+ * @return false on overflow.
+ */
+bool Rational::mulSmall( const Rational& a, const Rational& b, Rational& r ) {
+    int64_t n, d;
+    bool o = __builtin_mul_overflow( a.num, b.num, &n ) | __builtin_mul_overflow( a.den, b.den, &d );
+    r = fraction( n, d );
+    return checked( o, n );
+}
+
+Rational Rational::addBig( const Rational& a, const Rational& b ) {
+    BigInt an, ad, bn, bd;
+    a.parts( an, ad );
+    b.parts( bn, bd );
+    return make( an * bd + bn * ad, ad * bd );
+}
+
+Rational Rational::mulBig( const Rational& a, const Rational& b ) {
+    BigInt an, ad, bn, bd;
+    a.parts( an, ad );
+    b.parts( bn, bd );
+    return make( an * bn, ad * bd );
+}
+
+/**
+ * @brief Rational::add tries 64-bit arithmetic first. On overflow, it
+ * retries with reduced operands over their least common denominator and
+ * promotes to BigInt only if the result still overflows.
+ */
+Rational Rational::add( const Rational& a, const Rational& b ) {
+    Rational r;
+    if( ! a.big && ! b.big ) {
+        if( addSmall( a, b, 1, r ) ) {
+            return r;
+        }
+        Rational x = a.reduced(), y = b.reduced();
+        if( addSmall( x, y, int64_t( gcd( uint64_t( x.den ), uint64_t( y.den ) ) ), r ) ) {
+            return r;
+        }
+    }
+    return addBig( a, b );
+}
+
+/**
+ * @brief Rational::mul tries 64-bit arithmetic first. On overflow, it
+ * retries with operands reduced crosswise, i.e. each numerator with the
+ * other denominator, and promotes to BigInt only if the result still
+ * overflows.
+ */
+Rational Rational::mul( const Rational& a, const Rational& b ) {
+    Rational r;
+    if( ! a.big && ! b.big ) {
+        if( mulSmall( a, b, r ) ) {
+            return r;
+        }
+        Rational x = a.reduced(), y = b.reduced();
+        int64_t g1 = int64_t( gcd( uint64_t( x.num < 0? -x.num : x.num ), uint64_t( y.den ) ) );
+        int64_t g2 = int64_t( gcd( uint64_t( y.num < 0? -y.num : y.num ), uint64_t( x.den ) ) );
+        if( mulSmall( fraction( x.num / g1, x.den / g2 ), fraction( y.num / g2, y.den / g1 ), r ) ) {
+            return r;
+        }
+    }
+    return mulBig( a, b );
+}
+
+Rational Rational::operator-() const {
+    if( ! big ) {
+        return fraction( -num, den );
+    }
+    Rational r;
+    r.big = make_shared<const Big>( Big{ -big->num, big->den } );
+    return r;
+}
+
+Rational Rational::reciprocal() const {
+    if( ! big ) {
+        return num < 0? fraction( -den, -num ) : fraction( den, num );
+    }
+    return make( big->den, big->num );
+}
+
+Rational Rational::divide( const Rational& a, const Rational& b ) {
+    if( b.isZero() ) {
+        throw domain_error( "div/0" );
+    }
+    return a * b.reciprocal();
+}
@@ -0,0 +1,146 @@
+#ifndef RATIONAL_H
+#define RATIONAL_H
+
+#include <iostream>
+#include <memory>
+#include <cstdint>
+#include <climits>
+#include "bignum.h"
+using namespace std;
+
+
+/**
+ * @brief The Rational class implements exact fractions numerator /
+ * denominator with a positive denominator.
+ *
+ * Fractions whose numerator and denominator fit into int64_t are held
+ * inline. Operations on them use overflow-checked 64-bit arithmetic and
+ * are promoted to BigInt only if a result overflows. Fractions are
+ * normalised lazily: results are not reduced by their greatest common
+ * divisor until an operation would overflow, or until they are
+ * formatted. Integers (denominator 1) thus cost one checked add or
+ * multiply per operation and no GCD at all. The GCD of 64-bit values is
+ * Stein's binary GCD, which uses shifts and subtractions only. Promoted
+ * fractions are always kept reduced and are demoted once they fit again.
+ */
+class Rational {
+
+  public:
+    Rational( int64_t n = 0 ) : num( n ) {}
+
+    /**
+     * @brief parse a decimal with optional sign, fraction and exponent,
+     * e.g. "-12.5", which is exact as fraction 125/10.
+     * @param s text.
+     * @return value.
+     * @throws invalid_argument if 's' is no decimal.
+     */
+    static Rational parse( const string& s );
+    static Rational fromDouble( double d );
+
+    /**
+     * @brief fromParts returns the reduced fraction n / d, parts() returns
+     * numerator and denominator, which are not necessarily reduced. Used
+     * to save fractions exactly, e.g. in snapshots.
+     * @throws domain_error (fromParts) if 'd' is zero.
+     */
+    static Rational fromParts( const BigInt& n, const BigInt& d );
+    void parts( BigInt& n, BigInt& d ) const;
+
+    /**
+     * @brief toString returns the reduced fraction, e.g. "-1/3" or "5".
+     */
+    string toString() const;
+    double toDouble() const;
+
+    /**
+     * @brief format returns the value for a display of 'width' digits as
+     * decimal, see BigDecimal::format().
+     */
+    string format( size_t width ) const;
+
+    int sign() const { return big? big->num.sign() : ( num > 0 ) - ( num < 0 ); }
+    bool isZero() const { return sign() == 0; }
+    bool isSmall() const { return ! big; }
+
+    /**
+     * @brief reduced returns the fraction divided by the GCD of numerator
+     * and denominator.
+     */
+    Rational reduced() const;
+
+    /**
+     * @brief Arithmetic operators are inline for the fast path of inline
+     * fractions with equal denominators, e.g. integers, and of products
+     * without overflow. Other cases are handled by add() and mul().
+     */
+    friend Rational operator+( const Rational& a, const Rational& b ) {
+        int64_t n;
+        if( ! a.big && ! b.big && a.den == b.den && ! __builtin_add_overflow( a.num, b.num, &n ) && n != INT64_MIN ) {
+            return fraction( n, a.den );
+        }
+        return add( a, b );
+    }
+
+    friend Rational operator-( const Rational& a, const Rational& b ) {
+        int64_t n;
+        if( ! a.big && ! b.big && a.den == b.den && ! __builtin_sub_overflow( a.num, b.num, &n ) && n != INT64_MIN ) {
+            return fraction( n, a.den );
+        }
+        return add( a, -b );
+    }
+
+    friend Rational operator*( const Rational& a, const Rational& b ) {
+        int64_t n, d;
+        if( ! a.big && ! b.big && ! __builtin_mul_overflow( a.num, b.num, &n ) && n != INT64_MIN &&
+            ! __builtin_mul_overflow( a.den, b.den, &d ) ) {
+            return fraction( n, d );
+        }
+        return mul( a, b );
+    }
+
+    Rational operator-() const;
+
+    /**
+     * @brief divide returns a / b.
+     * @throws domain_error if 'b' is zero.
+     */
+    static Rational divide( const Rational& a, const Rational& b );
+
+    /**
+     * @brief gcd returns the greatest common divisor by Stein's binary
+     * GCD, gcd( a, 0 ) = a.
+     */
+    static uint64_t gcd( uint64_t a, uint64_t b );
+
+  private:
+    struct Big {
+        BigInt num;
+        BigInt den;
+    };
+
+    /**
+     * @brief fraction returns n / d without reducing, d > 0.
+     */
+    static Rational fraction( int64_t n, int64_t d ) {
+        Rational r( n );
+        r.den = d;
+        return r;
+    }
+
+    static Rational add( const Rational& a, const Rational& b );
+    static Rational mul( const Rational& a, const Rational& b );
+    static Rational make( BigInt n, BigInt d );
+    static Rational fromDecimal( const BigDecimal& d );
+    static bool addSmall( const Rational& a, const Rational& b, int64_t g, Rational& r );
+    static bool mulSmall( const Rational& a, const Rational& b, Rational& r );
+    static Rational addBig( const Rational& a, const Rational& b );
+    static Rational mulBig( const Rational& a, const Rational& b );
+    Rational reciprocal() const;
+
+    int64_t num = 0;            // numerator, if big is null
+    int64_t den = 1;            // denominator > 0, if big is null
+    shared_ptr<const Big> big;  // promoted fraction, reduced and immutable
+};
+
+#endif // RATIONAL_H
@@ -0,0 +1,177 @@
+#include <cmath>
+#include <cstring>
+#include "statistics.h"
+
+static const size_t BLOCK = 256;    // values reduced by one two-pass
+
+
+/**
+ * @brief Statistics::add accumulates a block of values. Blocks of up to
+ * BLOCK values are reduced by a two-pass (sum, then squared deviations
+ * from the block mean) in four independent lanes, which compilers
+ * vectorise, and merged into the accumulator. For a single value this is
+ * Welford's update.
+ * @param x values.
+ * @param len number of values.
+ */
+void Statistics::add( const double *x, size_t len ) {
+    if( len > 0 && bins.empty() ) {
+        bins.assign( 2 * SIGN_BINS + 1, 0 );
+        lo = hi = x[0];
+    }
+    for( size_t b = 0; b < len; b += BLOCK ) {
+        const double *v = x + b;
+        size_t k = len - b < BLOCK? len - b : BLOCK;
+        double sum[4] = { 0, 0, 0, 0 }, min[4], max[4];
+        for( size_t j=0; j < 4; j++ ) {
+            min[j] = max[j] = v[0];
+        }
+        size_t i = 0;
+        for( ; i + 4 <= k; i += 4 ) {
+            for( size_t j=0; j < 4; j++ ) {
+                sum[j] += v[i+j];
+                min[j] = v[i+j] < min[j]? v[i+j] : min[j];
+                max[j] = v[i+j] > max[j]? v[i+j] : max[j];
+            }
+        }
+        for( ; i < k; i++ ) {
+            sum[0] += v[i];
+            min[0] = v[i] < min[0]? v[i] : min[0];
+            max[0] = v[i] > max[0]? v[i] : max[0];
+        }
+        double bs = ( sum[0] + sum[1] ) + ( sum[2] + sum[3] );
+        double mb = bs / double( k );
+
+        double sq[4] = { 0, 0, 0, 0 }, dev[4] = { 0, 0, 0, 0 };
+        for( i = 0; i + 4 <= k; i += 4 ) {
+            for( size_t j=0; j < 4; j++ ) {
+                double d = v[i+j] - mb;
+                sq[j] += d * d;
+                dev[j] += d;
+            }
+        }
+        for( ; i < k; i++ ) {
+            double d = v[i] - mb;
+            sq[0] += d * d;
+            dev[0] += d;
+        }
+        double e = ( dev[0] + dev[1] ) + ( dev[2] + dev[3] );
+        double m2b = ( ( sq[0] + sq[1] ) + ( sq[2] + sq[3] ) ) - e * e / double( k );
+
+        for( i = 0; i < k; i++ ) {
+            bins[ bin( v[i] ) ]++;
+        }
+        for( size_t j=0; j < 4; j++ ) {
+            lo = min[j] < lo? min[j] : lo;
+            hi = max[j] > hi? max[j] : hi;
+        }
+        double t = s + bs;      // Neumaier summation of block sums
+        c += fabs( s ) >= fabs( bs )? ( s - t ) + bs : ( bs - t ) + s;
+        s = t;
+        merge( k, mb, m2b );
+    }
+}
+
+/**
+ * @brief Statistics::merge accumulates the values accumulated by 'o'.
+ * @param o statistics of other values.
+ */
+void Statistics::merge( const Statistics& o ) {
+    if( o.n == 0 ) {
+        return;
+    }
+    if( n == 0 ) {
+        *this = o;
+        return;
+    }
+    for( size_t i=0; i < bins.size(); i++ ) {
+        bins[i] += o.bins[i];
+    }
+    lo = o.lo < lo? o.lo : lo;
+    hi = o.hi > hi? o.hi : hi;
+    double t = s + o.s;
+    c += fabs( s ) >= fabs( o.s )? ( s - t ) + o.s : ( o.s - t ) + s;
+    c += o.c;
+    s = t;
+    merge( o.n, o.m, o.m2 );
+}
+
+/**
+ * @brief Statistics::merge merges count, mean and squared deviations of
+ * other values (Chan et al.).
+ */
+void Statistics::merge( uint64_t nb, double meanb, double m2b ) {
+    uint64_t total = n + nb;
+    double delta = meanb - m;
+    double f = double( nb ) / double( total );
+    m += delta * f;
+    m2 += m2b + delta * delta * double( n ) * f;
+    n = total;
+}
+
+void Statistics::clear() {
+    *this = Statistics();
+}
+
+
+double Statistics::variance() const {
+    return n > 1? m2 / double( n - 1 ) : 0.0;
+}
+
+double Statistics::stddev() const {
+    return sqrt( variance() );
+}
+
+/**
+ * @brief Statistics::quantile returns the value of the bin that holds
+ * the value of rank q * ( n - 1 ), clamped to [min, max].
+ * @param q in [0, 1].
+ */
+double Statistics::quantile( double q ) const {
+    if( n == 0 ) {
+        return 0.0;
+    }
+    if( q <= 0 ) {
+        return lo;
+    }
+    if( q >= 1 ) {
+        return hi;
+    }
+    uint64_t rank = uint64_t( q * double( n - 1 ) );
+    uint64_t seen = 0;
+    size_t i = 0;
+    while( i + 1 < bins.size() && ( seen += bins[i] ) <= rank ) {
+        i++;
+    }
+    double v = value( i );
+    return v < lo? lo : v > hi? hi : v;
+}
+
+
+/**
+ * @brief Statistics::bin returns the histogram bin of a value, which is
+ * given by the exponent and the leading SUB_BITS bits of the mantissa.
+ */
+size_t Statistics::bin( double x ) {
+    uint64_t bits;
+    memcpy( &bits, &x, 8 );
+    int e = int( ( bits >> 52 ) & 0x7ff ) - 1023;
+    if( e < MIN_EXP ) {
+        return ZERO;
+    }
+    int b = e >= MAX_EXP? SIGN_BINS - 1 :
+            ( e - MIN_EXP ) * SUB + int( ( bits >> ( 52 - SUB_BITS ) ) & ( SUB - 1 ) );
+    return x < 0? size_t( ZERO - 1 - b ) : size_t( ZERO + 1 + b );
+}
+
+/**
+ * @brief Statistics::value returns the midpoint of a bin.
+ */
+double Statistics::value( size_t i ) {
+    if( i == size_t( ZERO ) ) {
+        return 0.0;
+    }
+    int b = i > size_t( ZERO )? int( i ) - ZERO - 1 : ZERO - 1 - int( i );
+    double v = ldexp( 1.0 + ( ( b % SUB ) + 0.5 ) / SUB, b / SUB + MIN_EXP );
+    return i > size_t( ZERO )? v : -v;
+}
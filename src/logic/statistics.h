@@ -0,0 +1,89 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+
+/**
+ * @brief The Statistics class accumulates count, sum, mean, variance,
+ * minimum, maximum and approximate quantiles of a stream of values in
+ * constant memory.
+ *
+ * Mean and variance are updated by Welford's method, blocks of values by
+ * a two-pass over the block that is merged by the formula of Chan et al.,
+ * such that accumulators of parts of a stream can be merged, e.g. those
+ * of chunks of a file reduced in parallel. The sum is compensated
+ * (Neumaier). Merging in a fixed order yields identical results for any
+ * number of threads.
+ *
+ * Quantiles are estimated from a log-linear histogram: each power of two
+ * in [2^MIN_EXP, 2^MAX_EXP) is divided into 2^SUB_BITS bins of equal
+ * width, for both signs. Estimates are within 0.8% of the true quantile
+ * value (relative to it), magnitudes below 2^MIN_EXP count as 0, beyond
+ * 2^MAX_EXP as the largest bin; estimates are clamped to [min, max]. The
+ * histogram (80 KB) is allocated on the first value.
+ */
+class Statistics {
+
+  public:
+    static const int SUB_BITS = 6;
+    static const int MIN_EXP = -32;     // 2.3e-10
+    static const int MAX_EXP = 48;      // 2.8e14
+
+    /**
+     * @brief add accumulates a value or a block of 'len' values.
+     */
+    void add( double x ) { add( &x, 1 ); }
+    void add( const double *x, size_t len );
+
+    /**
+     * @brief merge accumulates the values accumulated by 'o'.
+     */
+    void merge( const Statistics& o );
+
+    void clear();
+
+    uint64_t count() const { return n; }
+    double sum() const { return s + c; }
+    double mean() const { return n > 0? m : 0.0; }
+    double min() const { return lo; }
+    double max() const { return hi; }
+
+    /**
+     * @brief variance returns the sample variance (n - 1), stddev its
+     * square root. 0 for fewer than 2 values.
+     */
+    double variance() const;
+    double stddev() const;
+
+    /**
+     * @brief quantile returns an estimate of the q-quantile, e.g. the
+     * median for q = 0.5. 0 and 1 return min() and max().
+     * @param q in [0, 1].
+     * @return estimate, 0 if no value was accumulated.
+     */
+    double quantile( double q ) const;
+
+  private:
+    static const int SUB = 1 << SUB_BITS;
+    static const int SIGN_BINS = ( MAX_EXP - MIN_EXP ) * SUB;
+    static const int ZERO = SIGN_BINS;          // bin of 0, negatives below
+
+    static size_t bin( double x );
+    static double value( size_t i );
+    void merge( uint64_t nb, double meanb, double m2b );
+
+    uint64_t n = 0;
+    double m = 0.0;         // mean
+    double m2 = 0.0;        // sum of squared deviations from the mean
+    double s = 0.0;         // sum and its compensation
+    double c = 0.0;
+    double lo = 0.0;
+    double hi = 0.0;
+    vector<uint64_t> bins;  // histogram, 2 * SIGN_BINS + 1 bins
+};
+
+#endif // STATISTICS_H
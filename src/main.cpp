@@ -1,18 +1,258 @@
 #include "mainwindow.h"
+#include "startupprofile.h"
+#include "builder.h"
+#include "guifacade.h"
+#include "keylog.h"
+#include "keyreplayer.h"
+#include "loadgen.h"
+#include "calculator.h"
+#include "buildconfig.h"
+#ifdef __linux__
+#include "sessionserver.h"
+#include "shmchannel.h"
+#include "journal.h"
+#include "historystore.h"
+#include "historyarchive.h"
+#include "vattable.h"
+#include "filesummary.h"
+#include "bulkreduction.h"
+#endif
 #include <QApplication>
+#include <cstring>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
 
 
 /**
  * @brief Main entry point.
+ * Option --fast-start skips the probe cycle and defers non-essential
+ * work (stylesheet, loggers) until the calculator accepts input.
+ * Option --precision <double|big|rational> selects the precision of
+ * calculations, big for arbitrary-precision decimals, rational for exact
+ * fractions.
+ * Option --vat-table <file> loads the VAT rates of product categories in
+ * regions, --vat-region <name> and --vat-category <name> select the rates
+ * of a region and the initial category (Linux only).
+ * Option --record <file> records key events to a key log file.
+ * Option --stats <file> writes controller statistics to a stats file
+ * every second.
+ * Options --replay <file> and --replay-fast <file> replay a key log
+ * headless (without GUI) at original timing or as fast as possible.
+ * Option --loadgen runs the load generator headless with options
+ * --sessions <n>, --threads <n>, --rate <keys/s per session> and
+ * --duration <sec>. With --executor <n>, sessions are processed by a
+ * work-stealing executor with n workers (0 for one per core).
+ * Option --server <socket> serves calculator sessions headless on a
+ * Unix domain socket using --threads <n> event loops (Linux only).
+ * Option --shm <name> serves the calculator headless to a front-end
+ * attached to shared memory region <name> (Linux only).
+ * Option --snapshot <file> saves the calculator state to a snapshot file
+ * on each change and restores it at startup, flushed to disk on each
+ * change or batched every --snapshot-sync <msec> (Linux only). It is
+ * rejected with --replay and --loadgen.
+ * Option --journal <file> appends every calculation of the calculator
+ * and of headless sessions to a journal file, --journal-dump <file>
+ * prints a journal file (Linux only).
+ * Option --history <store> with --history-build <journal> builds a
+ * columnar history store from a journal, with --query <expr> it queries
+ * the store using its indexes or as full scan with --query-full (Linux
+ * only).
+ * Option --archive <file> with --archive-build <journal> compresses a
+ * journal into an archive, with --archive-replay it replays the archive
+ * or the time range of --query <expr> through the batch evaluator (Linux
+ * only).
+ * Option --summary <file> prints the statistics of a file of numbers
+ * reduced by --threads <n> threads (Linux only).
+ * Option --reduce <file> prints the sum, product or mean (--reduce-op
+ * sum|product|mean) of a file of numbers reduced by --threads <n> threads
+ * (Linux only).
  * @param argc argument number.
  * @param argv argument vector.
  * @return  exit code.
  */
 int main( int argc, char *argv[] ) {
+    StartupProfile& profile = StartupProfile::getInstance();
+    const char *recordPath = nullptr;
+    const char *statsPath = nullptr;
+    const char *replayPath = nullptr;
+    bool replayFast = false;
+    bool loadgen = false;
+    const char *serverPath = nullptr;
+    const char *shmName = nullptr;
+    const char *precision = nullptr;
+    const char *vatPath = nullptr;
+    const char *vatRegion = nullptr;
+    const char *vatCategory = nullptr;
+    const char *journalDump = nullptr;
+    const char *historyPath = nullptr;
+    const char *historyBuild = nullptr;
+    const char *query = nullptr;
+    bool queryFull = false;
+    const char *archivePath = nullptr;
+    const char *archiveBuild = nullptr;
+    bool archiveReplay = false;
+    const char *summaryPath = nullptr;
+    const char *reducePath = nullptr;
+    const char *reduceOp = "sum";
+    LoadGenerator::Config load;
+    BuildConfig build;
+    for( int i=1; i < argc; i++ ) {
+        if( strcmp( argv[i], "--fast-start" ) == 0 ) {
+            profile.setFastStart( true );
+        } else if( strcmp( argv[i], "--record" ) == 0 && i + 1 < argc ) {
+            recordPath = argv[ ++i ];
+        } else if( strcmp( argv[i], "--stats" ) == 0 && i + 1 < argc ) {
+            statsPath = argv[ ++i ];
+        } else if( strcmp( argv[i], "--replay" ) == 0 && i + 1 < argc ) {
+            replayPath = argv[ ++i ];
+        } else if( strcmp( argv[i], "--replay-fast" ) == 0 && i + 1 < argc ) {
+            replayPath = argv[ ++i ];
+            replayFast = true;
+        } else if( strcmp( argv[i], "--server" ) == 0 && i + 1 < argc ) {
+            serverPath = argv[ ++i ];
+        } else if( strcmp( argv[i], "--shm" ) == 0 && i + 1 < argc ) {
+            shmName = argv[ ++i ];
+        } else if( strcmp( argv[i], "--snapshot" ) == 0 && i + 1 < argc ) {
+            build.snapshot = argv[ ++i ];
+        } else if( strcmp( argv[i], "--snapshot-sync" ) == 0 && i + 1 < argc ) {
+            build.snapshotSync = atoi( argv[ ++i ] );
+        } else if( strcmp( argv[i], "--precision" ) == 0 && i + 1 < argc ) {
+            precision = argv[ ++i ];
+        } else if( strcmp( argv[i], "--vat-table" ) == 0 && i + 1 < argc ) {
+            vatPath = argv[ ++i ];
+        } else if( strcmp( argv[i], "--vat-region" ) == 0 && i + 1 < argc ) {
+            vatRegion = argv[ ++i ];
+        } else if( strcmp( argv[i], "--vat-category" ) == 0 && i + 1 < argc ) {
+            vatCategory = argv[ ++i ];
+        } else if( strcmp( argv[i], "--journal" ) == 0 && i + 1 < argc ) {
+            build.journal = argv[ ++i ];
+        } else if( strcmp( argv[i], "--journal-dump" ) == 0 && i + 1 < argc ) {
+            journalDump = argv[ ++i ];
+        } else if( strcmp( argv[i], "--history" ) == 0 && i + 1 < argc ) {
+            historyPath = argv[ ++i ];
+        } else if( strcmp( argv[i], "--history-build" ) == 0 && i + 1 < argc ) {
+            historyBuild = argv[ ++i ];
+        } else if( strcmp( argv[i], "--query" ) == 0 && i + 1 < argc ) {
+            query = argv[ ++i ];
+        } else if( strcmp( argv[i], "--query-full" ) == 0 ) {
+            queryFull = true;
+        } else if( strcmp( argv[i], "--archive" ) == 0 && i + 1 < argc ) {
+            archivePath = argv[ ++i ];
+        } else if( strcmp( argv[i], "--archive-build" ) == 0 && i + 1 < argc ) {
+            archiveBuild = argv[ ++i ];
+        } else if( strcmp( argv[i], "--archive-replay" ) == 0 ) {
+            archiveReplay = true;
+        } else if( strcmp( argv[i], "--summary" ) == 0 && i + 1 < argc ) {
+            summaryPath = argv[ ++i ];
+        } else if( strcmp( argv[i], "--reduce" ) == 0 && i + 1 < argc ) {
+            reducePath = argv[ ++i ];
+        } else if( strcmp( argv[i], "--reduce-op" ) == 0 && i + 1 < argc ) {
+            reduceOp = argv[ ++i ];
+        } else if( strcmp( argv[i], "--loadgen" ) == 0 ) {
+            loadgen = true;
+        } else if( strcmp( argv[i], "--sessions" ) == 0 && i + 1 < argc ) {
+            load.sessions = unsigned( atoi( argv[ ++i ] ) );
+        } else if( strcmp( argv[i], "--threads" ) == 0 && i + 1 < argc ) {
+            load.threads = unsigned( atoi( argv[ ++i ] ) );
+        } else if( strcmp( argv[i], "--rate" ) == 0 && i + 1 < argc ) {
+            load.rate = atof( argv[ ++i ] );
+        } else if( strcmp( argv[i], "--duration" ) == 0 && i + 1 < argc ) {
+            load.seconds = atof( argv[ ++i ] );
+        } else if( strcmp( argv[i], "--executor" ) == 0 && i + 1 < argc ) {
+            int n = atoi( argv[ ++i ] );
+            unsigned cores = thread::hardware_concurrency();
+            load.executor = n > 0? unsigned( n ) : cores > 0? cores : 1;
+        }
+    }
+    if( precision != nullptr ) {
+        if( strcmp( precision, "big" ) == 0 ) {
+            build.precision = Calculator::Big;
+        } else if( strcmp( precision, "rational" ) == 0 ) {
+            build.precision = Calculator::Fraction;
+        } else if( strcmp( precision, "double" ) != 0 ) {
+            cerr << "unknown precision: " << precision << endl;
+            return 1;
+        }
+    }
+    if( ! build.snapshot.empty() && ( replayPath != nullptr || loadgen ) ) {
+        // A replay or load must neither start from nor overwrite the saved state.
+        cerr << "--snapshot cannot be combined with --replay or --loadgen" << endl;
+        return 1;
+    }
+#ifdef __linux__
+    if( vatPath != nullptr ) {
+        try {
+            VatTable *vat = new VatTable( vatPath );
+            size_t region = vatRegion != nullptr? vat->region( vatRegion ) : 0;
+            size_t category = vatCategory != nullptr? vat->category( vatCategory ) : 0;
+            Calculator::setDefaultVatRates( vat->rates( region ), vat->categories(), category );
+
+        } catch( exception& e ) {
+            cerr << e.what() << endl;
+            return 1;
+        }
+    }
+#endif
+    if( replayPath != nullptr ) {
+        return KeyReplayer::run( replayPath, replayFast, build );
+    }
+    if( loadgen ) {
+        return LoadGenerator::run( load, build );
+    }
+#ifdef __linux__
+    if( serverPath != nullptr ) {
+        return SessionServer::run( serverPath, load.threads, build );
+    }
+    if( shmName != nullptr ) {
+        return ShmChannel::run( shmName, build );
+    }
+    if( journalDump != nullptr ) {
+        return Journal::dump( journalDump );
+    }
+    if( historyPath != nullptr ) {
+        return HistoryStore::run( historyPath, historyBuild, query, ! queryFull );
+    }
+    if( archivePath != nullptr ) {
+        return HistoryArchive::run( archivePath, archiveBuild, archiveReplay, query );
+    }
+    if( summaryPath != nullptr ) {
+        return FileSummary::run( summaryPath, load.threads );
+    }
+    if( reducePath != nullptr ) {
+        BulkReduction::Op op = BulkReduction::Sum;
+        if( strcmp( reduceOp, "product" ) == 0 ) {
+            op = BulkReduction::Product;
+        } else if( strcmp( reduceOp, "mean" ) == 0 ) {
+            op = BulkReduction::Mean;
+        } else if( strcmp( reduceOp, "sum" ) != 0 ) {
+            cerr << "unknown reduction: " << reduceOp << endl;
+            return 1;
+        }
+        return BulkReduction::run( reducePath, op, load.threads );
+    }
+#endif
     QApplication a( argc, argv );
+    profile.mark( "Qt init" );
     MainWindow w;
     w.show();
-    w.launch();
+    w.launch( build );
+
+    if( statsPath != nullptr ) {
+        Builder::getInstance().buildStats( statsPath );
+    }
+    KeyRecorder *recorder = nullptr;
+    if( recordPath != nullptr ) {
+        try {
+            recorder = new KeyRecorder( "Key Recorder", recordPath );
+            Builder::getInstance().getGui()->subscribe( *recorder );
+
+        } catch( exception& e ) {
+            cerr << e.what() << endl;
+            return 1;
+        }
+    }
     int rc = a.exec();
+    delete recorder;
     return rc;
 }
@@ -1,4 +1,5 @@
 #include "display.h"
+#include "segmentframe.h"
 
 using namespace Ui;
 void logDestructor( std::string msg );
@@ -89,6 +90,14 @@ void Display::setErr() const {
     }
 }
 
+void Display::setCell( int i, uint8_t cell ) const {
+    static const char glyphs[] = "0123456789-Ero  ";
+    setQLCDNumber( i, QChar( glyphs[ cell & SegmentFrame::GLYPH ] ) );
+    setDot( i, cell & SegmentFrame::DOT );
+    setComma( i, cell & SegmentFrame::COMMA );
+    setColon( i, cell & SegmentFrame::COLON );
+}
+
 inline void Display::setQLCDNumber( int i, const QString &lcdvalue ) const {
     QLCDNumber *p = i >= 0 && i < this->size? digarray[i].lcddigit : nullptr;
     if( p ) {
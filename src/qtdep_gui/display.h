@@ -2,6 +2,7 @@
 #define DISPLAY_H
 
 #include <iostream>
+#include <cstdint>
 #include <QLCDNumber>
 #include <QLabel>
 
@@ -11,6 +12,7 @@ namespace Ui {
 class GuiFacade;
 class MainWindow;
 class Builder;
+class Headless;
 
 
 /**
@@ -24,6 +26,7 @@ class Ui::Display {
     friend class ::GuiFacade;
     friend class ::MainWindow;
     friend class ::Builder;
+    friend class ::Headless;
 
   private:
     struct Digit {
@@ -61,6 +64,14 @@ class Ui::Display {
     void clearAll() const;
     void setErr() const;
 
+    /**
+     * @brief setCell sets glyph, dot, comma and colon of digit 'i' from
+     * a SegmentFrame cell.
+     * @param i digit index.
+     * @param cell packed cell of a SegmentFrame.
+     */
+    void setCell( int i, uint8_t cell ) const;
+
     Digit *digarray;
     const int size;
 
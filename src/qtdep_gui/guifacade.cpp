@@ -30,8 +30,8 @@ GuiFacade::~GuiFacade() {
 
 
 /**
- * @brief GuiFacade::publish events. Only friend Ui::MainWindow is
- * permitted to publish events through GuiFacade.
+ * @brief GuiFacade::publish events. Only friends Ui::MainWindow and
+ * Headless are permitted to publish events through GuiFacade.
  * @param e XEvent created by EventFactory.
  */
 void GuiFacade::publish( XEvent& e ) {
@@ -48,10 +48,26 @@ void GuiFacade::publish( XEvent& e ) {
  * @param colon
  */
 void GuiFacade::setAll( int n, bool dot, bool comma, bool colon ) {
-    for( int i = 0; i < d.size; i++ ) {
-        d.setDigit( i, n );
-        d.setDot( i, dot );
-        d.setComma( i, comma );
-        d.setColon( i, colon );
+    SegmentFrame f;
+    f.setAll( n, dot, comma, colon );
+    render( f );
+}
+
+/**
+ * @brief GuiFacade::render updates the digits that differ from the last
+ * rendered frame. All digits are updated for the first frame. The
+ * frame is passed to the mirror backend, if set.
+ * @param f frame to render.
+ */
+void GuiFacade::render( const SegmentFrame& f ) {
+    for( int i = 0; i < d.size && i < SegmentFrame::CELLS; i++ ) {
+        if( ! rendered || f.cell[i] != frame.cell[i] ) {
+            d.setCell( i, f.cell[i] );
+        }
+    }
+    frame = f;
+    rendered = true;
+    if( mirror != nullptr ) {
+        mirror->render( f );
     }
 }
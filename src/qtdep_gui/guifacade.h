@@ -3,6 +3,7 @@
 
 #include "display.h"
 #include "pubsub.h"
+#include "segmentframe.h"
 #include "xevent.h"
 using namespace std;
 
@@ -19,10 +20,15 @@ using namespace std;
  * GUI-Events are issued as enum GuiFacade::KeyEvt types using a
  * publish/subscribe mechanism to which event recipients can subscribe.
  *
+ * GuiFacade is the display backend of the Qt display. Frames are diffed
+ * against the last rendered frame such that only changed digits are
+ * updated in the Qt-widgets.
+ *
  */
-class GuiFacade : public PublisherIntf {
+class GuiFacade : public PublisherIntf, public DisplayBackendIntf {
   friend class Builder;
   friend class MainWindow;
+  friend class Headless;
 
   public:
   /**
@@ -31,16 +37,34 @@ class GuiFacade : public PublisherIntf {
    * Each digit has a dot '.' and a comma ',' at the lower right that
    * can be turned on/off. Furthermore, there are colons ':' between
    * digits for clock mode.
+   * Access methods modify the last rendered frame and render it.
    */
-    void setDigit( int i, int n )   { d.setDigit( i, n ); }
-    void setDot( int i, bool on )   { d.setDot( i, on ); }
-    void setComma( int i, bool on ) { d.setComma( i, on ); }
-    void setColon( int i, bool on ) { d.setColon( i, on ); }
-    void setMinus( int i )          { d.setMinus( i ); }
+    void setDigit( int i, int n )   { SegmentFrame f = frame; f.setDigit( i, n ); render( f ); }
+    void setDot( int i, bool on )   { SegmentFrame f = frame; f.setDot( i, on ); render( f ); }
+    void setComma( int i, bool on ) { SegmentFrame f = frame; f.setComma( i, on ); render( f ); }
+    void setColon( int i, bool on ) { SegmentFrame f = frame; f.setColon( i, on ); render( f ); }
+    void setMinus( int i )          { SegmentFrame f = frame; f.setMinus( i ); render( f ); }
     void setAll( int n, bool dot, bool comma, bool colon );
-    void clearDigit( int i )        { d.clearDigit( i ); }
-    void clearAll()                 { d.clearAll(); }
-    void setErr()                   { d.setErr(); }
+    void clearDigit( int i )        { SegmentFrame f = frame; f.clearDigit( i ); render( f ); }
+    void clearAll()                 { render( SegmentFrame() ); }
+    void setErr()                   { render( SegmentFrame::error() ); }
+
+    /**
+     * @brief render method inherited from DisplayBackendIntf updates the
+     * digits that differ from the last rendered frame. getFrame() returns
+     * the last rendered frame.
+     * @param f frame to render.
+     */
+    void render( const SegmentFrame& f );
+    const SegmentFrame& getFrame() const { return frame; }
+
+    /**
+     * @brief setMirror sets an optional backend to which all rendered
+     * frames are passed in addition to the Qt-widgets, e.g. a front-end
+     * attached via shared memory.
+     * @param mirror backend or nullptr.
+     */
+    void setMirror( DisplayBackendIntf *mirror ) { this->mirror = mirror; }
 
     /**
      * @brief The KeyEvt enum describes input event types issued by the GUI.
@@ -49,12 +73,14 @@ class GuiFacade : public PublisherIntf {
     enum KeyEvt {
         K0=0, K1=1, K2=2, K3=3, K4=4, K5=5, K6=6, K7=7, K8=8, K9=9, Comma=10, K000=11,
         Plus=12, Minus=13, Mul=14, Div=15, Percent=16, VAT=17, EQ=18,
-        BS, C, CE, Mode, Start, Stop, ParOpen, ParClose
+        BS, C, CE, Mode, Start, Stop, ParOpen, ParClose, Undo, Redo,
+        Sqrt, Square, Recip, Ln, Exp, Sin, Cos, Pow, Category
     };
-    const string *keyEvtStr = new string[27] {
+    const string *keyEvtStr = new string[38] {
         "K0", "K1", "K2", "K3", "K4", "K5", "K6", "K7", "K8", "K9", "Comma", "K000",
         "Plus", "Minus", "Mul", "Div", "Percent", "VAT", "EQ",
-        "BS", "C", "CE", "Mode", "Start", "Stop", "ParOpen", "ParClose"
+        "BS", "C", "CE", "Mode", "Start", "Stop", "ParOpen", "ParClose", "Undo", "Redo",
+        "Sqrt", "Square", "Recip", "Ln", "Exp", "Sin", "Cos", "Pow", "Category"
     };
 
     /**
@@ -95,8 +121,8 @@ class GuiFacade : public PublisherIntf {
     static GuiFacade& getInstance( const string name, Builder& builder, const Ui::Display& uiDisplay, PublisherIntf& publisherImpl );
 
     /**
-     * @brief Method to publish events. Only friend Ui::MainWindow is
-     * permitted to publish events through GuiFacade.
+     * @brief Method to publish events. Only friends Ui::MainWindow and
+     * Headless are permitted to publish events through GuiFacade.
      * @param e XEvent created by EventFactory.
      */
     void publish( XEvent& e );
@@ -106,6 +132,10 @@ class GuiFacade : public PublisherIntf {
     const Ui::Display &d;
     PublisherIntf &pub;
 
+    SegmentFrame frame;         // last rendered frame
+    bool rendered = false;      // false until first frame has been rendered
+    DisplayBackendIntf *mirror = nullptr;   // optional backend frames are mirrored to
+
     static GuiFacade *_this;    // private static pointer declaration
                                 // for singleton instance
 };
@@ -5,10 +5,13 @@
 #include "guifacade.h"
 #include "builder.h"
 #include "maincontroller.h"
+#include "timerwheeldriver.h"
+#include "startupprofile.h"
 
 
 /**
- * Public constructor.
+ * Public constructor. In fast-start mode, loading the stylesheet is
+ * deferred until the calculator accepts input.
  * @brief MainWindow::MainWindow
  * @param parent QWidget of main Window.
  */
@@ -19,11 +22,35 @@ MainWindow::MainWindow( QWidget *parent ) :
     setWindowTitle( tr( "SE-2 Calculator" ) );
     QMainWindow::setFixedSize( 362, 510 );
 
+    // Timers of the application are driven from the Qt event loop.
+    new TimerWheelDriver( TimerWheel::getInstance(), this );
+    StartupProfile::getInstance().mark( "UI setup" );
+
+    if( ! StartupProfile::getInstance().isFastStart() ) {
+        loadStyleSheet();
+    }
+}
+
+/**
+ * @brief MainWindow::loadStyleSheet loads and applies :/style.qss.
+ */
+void MainWindow::loadStyleSheet() {
     QFile file( ":/style.qss" );
     if( file.open( QFile::ReadOnly ) ) {
        QString styleSheet = QLatin1String( file.readAll() );
        this->setStyleSheet( styleSheet );
     }
+    StartupProfile::getInstance().mark( "stylesheet" );
+}
+
+/**
+ * @brief MainWindow::deferredStart performs work deferred in fast-start
+ * mode after the first frame has been shown and input is accepted.
+ */
+void MainWindow::deferredStart() {
+    loadStyleSheet();
+    builder->buildLoggers();
+    StartupProfile::getInstance().mark( "loggers" );
 }
 
 /**
@@ -38,8 +65,9 @@ MainWindow::~MainWindow() {
 /**
  * Entry point into allocation code.
  * @brief MainWindow::launch.
+ * @param config options of components built.
  */
-void MainWindow::launch() {
+void MainWindow::launch( const BuildConfig& config ) {
     /*
      * 1. Collect display digits from ui widgets and pass to
      * Ui::Display instance.
@@ -66,12 +94,21 @@ void MainWindow::launch() {
     /*
      * 3. Invoke Builder::build() to build and configure app components.
      */
-    if( builder->build() ) {
+    bool fastStart = StartupProfile::getInstance().isFastStart();
+    if( builder->build( config, fastStart ) ) {
+        StartupProfile::getInstance().mark( "Builder::build" );
         ControllerIntf *controller = builder->getMainController();
         /*
          * 4. Start application controller.
          */
         controller->start();
+
+        /*
+         * 5. In fast-start mode, run deferred work after the first frame.
+         */
+        if( fastStart ) {
+            QTimer::singleShot( 0, this, [this]() { deferredStart(); } );
+        }
     }
 }
 
@@ -162,10 +199,22 @@ void MainWindow::keyPressEvent( QKeyEvent *event ) {
     case Qt::Key_Plus:  fireKeyEvent( GuiFacade::KeyEvt::Plus ); break;
     case Qt::Key_M:     fireKeyEvent( GuiFacade::KeyEvt::Mode ); break;
     case Qt::Key_V:     fireKeyEvent( GuiFacade::KeyEvt::VAT ); break;
+    case Qt::Key_Z:     fireKeyEvent( GuiFacade::KeyEvt::Undo ); break;
+    case Qt::Key_Y:     fireKeyEvent( GuiFacade::KeyEvt::Redo ); break;
+    case Qt::Key_Q:     fireKeyEvent( GuiFacade::KeyEvt::Sqrt ); break;
+    case Qt::Key_W:     fireKeyEvent( GuiFacade::KeyEvt::Square ); break;
+    case Qt::Key_I:     fireKeyEvent( GuiFacade::KeyEvt::Recip ); break;
+    case Qt::Key_L:     fireKeyEvent( GuiFacade::KeyEvt::Ln ); break;
+    case Qt::Key_E:     fireKeyEvent( GuiFacade::KeyEvt::Exp ); break;
+    case Qt::Key_N:     fireKeyEvent( GuiFacade::KeyEvt::Sin ); break;
+    case Qt::Key_O:     fireKeyEvent( GuiFacade::KeyEvt::Cos ); break;
+    case Qt::Key_AsciiCircum: fireKeyEvent( GuiFacade::KeyEvt::Pow ); break;
+    case Qt::Key_K:     fireKeyEvent( GuiFacade::KeyEvt::Category ); break;
 
     case Qt::Key_X: close(); /* triggers QCloseEvent */ break;
 
     case Qt::Key_P: builder->getMainController()->probe(); break;
+    case Qt::Key_R: builder->getMainController()->restart(); break;
     }
 }
 
@@ -11,6 +11,7 @@ namespace Ui {
 }
 class Builder;
 class GuiFacade;
+struct BuildConfig;
 
 
 /**
@@ -31,9 +32,10 @@ class MainWindow : public QMainWindow {
     ~MainWindow();
 
     /*
-     * Main method "launched" by Qt-runtime in main().
+     * Main method "launched" by Qt-runtime in main() with the options of
+     * components built.
      */
-    void launch();
+    void launch( const BuildConfig& config );
 
     /*
      * Slots are a Qt-concept to bind methods to event sources.
@@ -74,6 +76,8 @@ class MainWindow : public QMainWindow {
 
   private:
     void fireKeyEvent( int ev );
+    void loadStyleSheet();
+    void deferredStart();
     Ui::MainWindow *ui;
     GuiFacade *guiFacade;
     Builder *builder;
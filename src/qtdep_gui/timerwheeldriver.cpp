@@ -0,0 +1,57 @@
+#include "timerwheeldriver.h"
+
+static const uint64_t MAX_MSEC = 1 << 30;    // limit of QTimer interval
+
+
+/**
+ * @brief TimerWheelDriver constructor registers driver at wheel.
+ * @param wheel timer wheel advanced by the driver.
+ * @param parent QObject parent.
+ */
+TimerWheelDriver::TimerWheelDriver( TimerWheel& wheel, QObject *parent )
+    : QObject( parent ), wheel( wheel )
+{
+    timer = new QTimer( this );
+    timer->setSingleShot( true );
+    timer->setTimerType( Qt::PreciseTimer );
+    connect( timer, SIGNAL( timeout() ), this, SLOT( timeout() ) );
+    wheel.setDriver( this );
+    arm( wheel.nextExpiry() );
+}
+
+TimerWheelDriver::~TimerWheelDriver() {
+    wheel.setDriver( nullptr );
+}
+
+
+/**
+ * @brief rearm is invoked by the wheel when an entry has been scheduled
+ * to expire at tick 'when'.
+ * @param when absolute expiry tick.
+ */
+void TimerWheelDriver::rearm( uint64_t when ) {
+    if( when < armed ) {
+        arm( when );
+    }
+}
+
+/**
+ * @brief timeout advances the wheel and arms the QTimer for the next expiry.
+ */
+void TimerWheelDriver::timeout() {
+    armed = UINT64_MAX;
+    wheel.advance();
+    arm( wheel.nextExpiry() );
+}
+
+void TimerWheelDriver::arm( uint64_t when ) {
+    if( when == UINT64_MAX ) {
+        timer->stop();
+        armed = when;
+        return;
+    }
+    uint64_t t = wheel.now();
+    uint64_t msec = when > t? when - t : 0;
+    armed = when;
+    timer->start( int( msec < MAX_MSEC? msec : MAX_MSEC ) );
+}
@@ -0,0 +1,51 @@
+#ifndef TIMERWHEELDRIVER_H
+#define TIMERWHEELDRIVER_H
+
+#include <QObject>
+#include <QTimer>
+#include "timerwheel.h"
+
+
+/**
+ * @brief The TimerWheelDriver class is a Qt-dependent driver that advances
+ * a TimerWheel from the Qt event loop. A single single-shot QTimer is armed
+ * for the next expiry of the wheel, regardless of the number of timers
+ * pending in the wheel. The QTimer is not armed while the wheel is empty.
+ *
+ */
+class TimerWheelDriver : public QObject, public TimerWheel::DriverIntf {
+    Q_OBJECT    // Qt object (macro).
+
+  public:
+    /**
+     * @brief TimerWheelDriver constructor registers driver at wheel.
+     * @param wheel timer wheel advanced by the driver.
+     * @param parent QObject parent.
+     */
+    TimerWheelDriver( TimerWheel& wheel, QObject *parent = nullptr );
+    ~TimerWheelDriver();
+
+    /**
+     * @brief rearm is invoked by the wheel when an entry has been scheduled
+     * to expire at tick 'when'. The QTimer is re-armed if 'when' is earlier
+     * than the currently armed expiry.
+     * @param when absolute expiry tick.
+     */
+    void rearm( uint64_t when );
+
+  public slots:
+    /**
+     * @brief timeout is the method registered to the Qt timer slot.
+     * It advances the wheel and arms the QTimer for the next expiry.
+     */
+    void timeout();
+
+  private:
+    void arm( uint64_t when );
+
+    TimerWheel& wheel;
+    QTimer *timer;
+    uint64_t armed = UINT64_MAX;    // tick for which timer is armed
+};
+
+#endif // TIMERWHEELDRIVER_H